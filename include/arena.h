@@ -0,0 +1,77 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Default size of a chunk of the arena (bytes).
+#define ARENA_DEFAULT_CHUNK (1 << 20)
+
+// A chunk of memory owned by the arena.
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size; // Capacity of 'data' (bytes).
+    size_t used; // Bytes in use.
+    _Alignas(16) unsigned char data[];
+} ArenaChunk;
+
+// Bump allocator: memory is handed out sequentially from a list of chunks and
+// released all at once. Single threaded, use one arena per solver run.
+typedef struct {
+    ArenaChunk *first;   // First chunk of the list.
+    ArenaChunk *current; // Chunk used for the next allocations.
+    size_t chunk_size;   // Minimum size of a new chunk.
+    size_t in_use;       // Bytes currently handed out.
+    size_t peak;         // Max value reached by 'in_use'.
+    size_t reserved;     // Bytes requested to the system.
+    int fd;              // File the chunks are mapped from (-1 = malloc).
+    size_t file_size;    // Bytes of the file in use by the chunks.
+} Arena;
+
+// Position in the arena, used to release temporary allocations.
+typedef struct {
+    ArenaChunk *chunk;
+    size_t used;
+    size_t in_use;
+} ArenaMark;
+
+
+// Initialize an empty arena. If 'chunk_size' is 0 ARENA_DEFAULT_CHUNK is used.
+void arena_init(Arena *a, size_t chunk_size);
+
+// Initialize an empty arena whose chunks are mapped from an unlinked file in
+// 'dir' (out-of-core storage): the kernel can write them back to the file
+// instead of keeping them in RAM. Returns 0 on success.
+int arena_init_mapped(Arena *a, size_t chunk_size, const char *dir);
+
+// Return 1 if the chunks of the arena are mapped from a file.
+static inline int arena_is_mapped(const Arena *a) {
+    return a != NULL && a->fd >= 0;
+}
+
+// Release all the memory owned by the arena.
+void arena_destroy(Arena *a);
+
+// Allocate 'sz' bytes (16 bytes aligned). If 'a' is NULL malloc() is used.
+// Returns NULL if there is not enough memory.
+void *arena_alloc(Arena *a, size_t sz);
+
+// Grow the allocation 'ptr' of 'old_sz' bytes to 'new_sz' bytes. The block is
+// extended in place when it is the last one of the arena. If 'a' is NULL
+// realloc() is used.
+void *arena_realloc(Arena *a, void *ptr, size_t old_sz, size_t new_sz);
+
+// Release 'ptr' if 'a' is NULL, otherwise do nothing: arena memory is released
+// by arena_reset() or arena_destroy().
+void arena_free(Arena *a, void *ptr);
+
+// Release every allocation in O(1). Chunks are kept for the next run.
+void arena_reset(Arena *a);
+
+// Save the current position / release everything allocated after 'mark'.
+ArenaMark arena_mark(const Arena *a);
+void arena_rewind(Arena *a, ArenaMark mark);
+
+// Peak number of bytes handed out since arena_init().
+size_t arena_peak(const Arena *a);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef ASYNC_SOLVE_H
+#define ASYNC_SOLVE_H
+
+#include <pthread.h>
+
+#include "../include/simple_simplex.h"
+
+// A solve running on its own thread.
+typedef struct {
+    Tableau *tab;
+    size_t **basis;
+    int algorithm;                 // Value of enum backend_algorithm.
+    const SolverParams *user;      // Parameters of the caller (tab->params).
+    SolverParams params;           // Copy with 'cancel' and 'progress' set.
+    atomic_int cancel;             // Set by async_solve_cancel().
+    SolverProgress progress;       // Readable while the solve runs.
+    atomic_int done;               // Set when the solve returns.
+    int status;                    // Status of the solve, once done.
+    pthread_t thread;
+} AsyncSolve;
+
+
+// Run 'algorithm' (enum backend_algorithm, with the numeric backend of
+// tab->params) on this thread: the body of an asynchronous solve.
+int async_solve_run(Tableau *tab, size_t **basis, int algorithm);
+
+// Start 'algorithm' (enum backend_algorithm, with the numeric backend of
+// tab->params) on a new thread. 'tab', '*basis' and tab->arena belong to the
+// solve until async_solve_wait(). Returns 0 on success.
+int async_solve_start(AsyncSolve *solve, Tableau *tab, size_t **basis, int algorithm);
+
+// Return 1 if the solve returned (async_solve_wait() will not block).
+int async_solve_done(AsyncSolve *solve);
+
+// Ask the solve to stop at the next pivot (status CANCELLED).
+void async_solve_cancel(AsyncSolve *solve);
+
+// Wait for the solve and return its status. The tableau and the basis hold
+// the last basis reached (the best bound if a limit was hit).
+int async_solve_wait(AsyncSolve *solve);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include "../include/simple_simplex.h"
+
+// Numeric types of the solvers. BACKEND_CLASSIC is the full solver of
+// simple_simplex.c. The other backends run a reduced core generated once per
+// type (backend_template.inc): two phase simplex and dual simplex with
+// Bland's rule, and a cutting plane adding one fractional Gomory cut per
+// round. They share the limits, cancellation and progress of the classic
+// solver, but not its degeneracy strategies, separators, cut selection,
+// heuristics or checkpoints (see backend_unsupported()).
+//
+// The classic solver is not an instantiation of the template: simplex(),
+// dual_simplex() and cutting_plane() stay written on Fraction, because their
+// features and the modules built on them (branch and bound, lazy rows,
+// decomposition, the daemon) use the Fraction tableau directly. The template
+// is the single source of the reduced core only, q32 included.
+enum numeric_backend {
+    BACKEND_CLASSIC, // The Fraction solvers of simple_simplex.c (verbose).
+    BACKEND_Q32,     // Rationals with int fields, overflow checked.
+    BACKEND_Q64,     // Rationals with long long fields, overflow checked.
+    BACKEND_MPQ,     // GMP rationals (only if built with GMP).
+    BACKEND_F64,     // Doubles (not exact).
+    BACKEND_AUTO     // Q32, then wider rationals on overflow.
+};
+
+// Algorithms of the generated core.
+enum backend_algorithm {
+    ALGO_SIMPLEX,       // Two phase simplex.
+    ALGO_DUAL_SIMPLEX,  // Dual simplex from an identity basis.
+    ALGO_CUTTING_PLANE  // Gomory cutting plane.
+};
+
+typedef struct {
+    int backend;    // Backend that produced the result.
+    int iterations; // # of pivots.
+    size_t n, m;    // Size of the final tableau.
+    double cost;    // Objective value.
+    char exact;     // 1 if the final tableau was written back in 'tab'.
+} BackendResult;
+
+
+// Name of a backend.
+const char *backend_name(int backend);
+
+// Return 1 if the backend was compiled in.
+int backend_available(int backend);
+
+// Option of 'params' that only the classic backend implements (e.g.
+// "--heuristics"), NULL if params->backend can run with them.
+const char *backend_unsupported(const SolverParams *params);
+
+// Run 'algorithm' with the numeric backend 'backend' on a copy of 'tab'.
+// '*basis' (allocated from tab->arena) receives the final basis, res->m
+// entries. The final tableau replaces 'tab' when every element fits a
+// Fraction (res->exact). Returns the status of the solve, NUMERIC_OVERFLOW
+// if the backend is too narrow for the problem.
+int backend_solve(Tableau *tab, size_t **basis, int backend, int algorithm,
+        BackendResult *res);
+
+#endif
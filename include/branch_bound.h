@@ -0,0 +1,110 @@
+#ifndef BRANCH_BOUND_H
+#define BRANCH_BOUND_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/arena.h"
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Version of the coordinator / worker protocol.
+#define BB_PROTOCOL_VERSION 2
+
+// Nodes a worker asks to have in flight: one is solved while the next one is
+// on the wire.
+#define BB_WORKER_SLOTS 2
+
+// Messages of the distributed branch and bound (see wire.h for the framing).
+//
+//   worker -> coordinator  BB_HELLO      version, slots
+//   coordinator -> worker  BB_PROBLEM    m, n, solver params, the tableau
+//   coordinator -> worker  BB_NODE       a subproblem, the current cutoff and
+//                                        the pivots left to the search
+//   worker -> coordinator  BB_RESULT     LP status, cost and pivots of a node,
+//                                        its basis and branching variable, or
+//                                        the solution if it is integer
+//   coordinator -> worker  BB_INCUMBENT  cost of a new incumbent (broadcast)
+//   coordinator -> worker  BB_SHUTDOWN   the search is over
+//
+// Load balancing: the coordinator owns the open nodes and keeps up to 'slots'
+// of them in flight on every worker, best bound first. A worker that leaves
+// gives its nodes back to the queue; workers may join during the search.
+enum bb_message {
+    BB_HELLO = 1, BB_PROBLEM, BB_NODE, BB_RESULT, BB_INCUMBENT, BB_SHUTDOWN
+};
+
+// Bound of a subproblem: x_var <= value (upper) or x_var >= value.
+typedef struct {
+    uint32_t var;
+    int32_t value;
+    char upper;
+} BoundChange;
+
+// A subproblem: the problem plus one row (and slack) per bound change, in
+// order. The children of a node restart from its optimal basis.
+typedef struct {
+    uint64_t id;
+    int failures;        // Workers lost while it was in flight.
+    Fraction bound;      // LP cost of the parent, a lower bound of the node.
+    size_t n_bounds;
+    BoundChange *bounds;
+    size_t n_basis;      // m + n_bounds - 1 (0 = no warm start).
+    size_t *basis;       // Optimal basis of the parent.
+} BBNode;
+
+// Outcome of a node.
+typedef struct {
+    int status;          // OPTIMAL, INFEASIBLE, UNBOUNDED or a limit.
+    uint64_t pivots;     // Pivots of the LP.
+    char pruned;         // The LP cost reached the cutoff.
+    char integral;       // The LP solution is integer.
+    Fraction cost;       // LP cost.
+    size_t branch_var;   // Most fractional variable (if not integral)...
+    int32_t branch_floor; // ... and the floor of its value.
+    size_t n_basis;      // Optimal basis (m + n_bounds entries).
+    size_t *basis;
+    Fraction *x;         // Solution x[1..n], if integral.
+} BBResult;
+
+typedef struct {
+    const char *listen;  // Address the workers connect to ("HOST:PORT" or
+                         // "unix:PATH"), NULL means solve in this process.
+    int workers;         // Workers to wait for before the search starts.
+    int spawn;           // Local workers forked on 'listen'.
+} BranchBoundConfig;
+
+typedef struct {
+    size_t nodes;        // Subproblems solved.
+    size_t pruned;       // Infeasible or dominated by the incumbent.
+    size_t incumbents;   // Improvements of the incumbent.
+    size_t max_open;     // Peak # of open nodes.
+    size_t workers;      // Workers that joined the search.
+    size_t requeued;     // Nodes given back by workers that left.
+    Fraction cost;       // Cost of the incumbent.
+} BranchBoundStats;
+
+
+// Solve the LP of a node: cold with two_phase_simplex(), or from the basis of
+// the parent with dual_simplex(). Nodes whose cost reaches 'cutoff' (NULL =
+// none) are pruned. The arrays of 'res' come from 'arena'.
+int bb_solve_node(const Tableau *problem, const BBNode *node,
+        const Fraction *cutoff, Arena *arena, BBResult *res);
+
+// Branch and bound of a pure integer problem (every variable integer and
+// >= 0), best bound first, branching on the most fractional variable. With
+// config->listen the nodes are solved by worker processes (bb_worker()),
+// otherwise in this process. tab->params->time_limit and max_iterations bound
+// the whole search: the workers count the pivots of their nodes against it.
+// Returns OPTIMAL (solution in x[1..n]), INFEASIBLE, UNBOUNDED or a limit, in
+// which case x holds the incumbent if stats->incumbents > 0. 'tab' is not
+// modified.
+int branch_and_bound(const Tableau *tab, const BranchBoundConfig *config,
+        Fraction *x, BranchBoundStats *stats);
+
+// Worker: connect to the coordinator at 'addr' and solve its nodes until it
+// shuts down. A node may use the pivots the search had left when the last
+// node was sent. Returns 0 on a clean shutdown.
+int bb_worker(const char *addr);
+
+#endif
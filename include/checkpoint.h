@@ -0,0 +1,52 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+
+#include "../include/cuts.h"
+#include "../include/simple_simplex.h"
+
+#define CHECKPOINT_MAGIC "SSCKPT"
+#define CHECKPOINT_VERSION 1
+
+// Phase of the solver saved in a snapshot.
+enum checkpoint_phase {
+    PHASE_CUTTING_PLANE // Between two rounds of the cutting plane.
+};
+
+// Header of a snapshot file. It is followed by:
+//  - the tableau, (m+1) x (n+1) pairs of int32 (num, den), row by row;
+//  - the basis, m uint64;
+//  - the length of each cut of the pool, pool_count uint64;
+//  - the unit vectors of the cuts, pool_values doubles.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t phase;       // Value of enum checkpoint_phase.
+    uint64_t n;
+    uint64_t m;
+    uint64_t round;       // Next cutting plane round.
+    uint64_t pool_count;  // # of cuts in the pool.
+    uint64_t pool_values; // Total # of coefficients of the cuts.
+    uint64_t checksum;    // FNV-1a of everything after the header.
+} CheckpointHeader;
+
+// State restored from a snapshot.
+typedef struct {
+    int phase;
+    size_t round;
+} CheckpointState;
+
+
+// Write a snapshot of the cutting plane state in 'path'. The file is written
+// in a temporary file that replaces 'path' only once it is complete and
+// synced, so 'path' always holds a valid snapshot. Returns 0 on success.
+int checkpoint_write(const char *path, const Tableau *tab, const size_t *basis,
+        const CutPool *pool, int phase, size_t round);
+
+// Load the snapshot in 'path' (memory mapped). The tableau and the basis are
+// allocated from 'arena', the cuts are added to 'pool'. Returns 0 on success.
+int checkpoint_read(const char *path, Arena *arena, Tableau *tab,
+        size_t **basis, CutPool *pool, CheckpointState *state);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef COLGEN_H
+#define COLGEN_H
+
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Pricing oracle of the column generation. 'duals' has m+1 entries, duals[0]
+// is unused. The callback writes at most 'max_cols' columns in 'cols', one
+// after the other, m+1 entries each: the cost, then the coefficients of the
+// m rows. Returns the # of columns written (0 if there is no improving one).
+typedef size_t (*PricingCallback)(const Fraction *duals, size_t m,
+        Fraction *cols, size_t max_cols, void *data);
+
+typedef struct {
+    size_t rounds;        // # of calls to the pricing oracle.
+    size_t columns_added; // # of columns appended to the master.
+} ColGenStats;
+
+
+// Column generation: solve the restricted master problem 'tab', then ask
+// 'pricing' for columns with negative reduced cost, append them and
+// re-optimize with primal simplex from the current basis, until the oracle
+// has no improving column. The master must contain one unit column per row
+// (slacks or artificials), used to read the duals from the tableau. At most
+// tab->params->colgen_batch columns are requested per round.
+int column_generation(Tableau *tab, size_t *basis, PricingCallback pricing,
+        void *data, ColGenStats *stats);
+
+// Dual values of the current basis (m+1 entries, duals[0] is unused), given
+// the unit columns 'unit' (m entries, unit[i-1] is e_i) and their original
+// costs 'unit_cost'.
+void colgen_duals(const Tableau *tab, const size_t *unit, const Fraction *unit_cost,
+        Fraction *duals);
+
+#endif
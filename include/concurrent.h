@@ -0,0 +1,44 @@
+#ifndef CONCURRENT_H
+#define CONCURRENT_H
+
+#include "../include/simple_simplex.h"
+
+// Engines raced by the concurrent optimizer.
+enum concurrent_engine {
+    ENGINE_PRIMAL,         // Two phase simplex, Bland's rule.
+    ENGINE_PRIMAL_PERTURB, // Two phase simplex, perturbation when stalling.
+    ENGINE_PRIMAL_LEX,     // Two phase simplex, lexicographic when stalling.
+    ENGINE_DUAL,           // Dual simplex (needs a dual feasible basis).
+    ENGINE_SOA,            // Simplex on the SoA layout (needs a feasible basis).
+    N_ENGINES
+};
+
+// Mask of all the engines.
+#define ENGINES_ALL ((1u << N_ENGINES) - 1)
+
+// Status of an engine that cannot be used on the problem.
+#define ENGINE_NOT_APPLICABLE -1
+
+typedef struct {
+    int status;                    // Status of the winner.
+    int engine;                    // Winning engine (-1 if none).
+    double seconds;                // Wall time of the winner.
+    int engine_status[N_ENGINES];  // Final status of every engine.
+} ConcurrentResult;
+
+
+// Name of an engine.
+const char *concurrent_engine_name(int engine);
+
+// Race the engines in 'engines' (bit mask of enum concurrent_engine) on
+// separate threads, each one on its own copy of the problem and its own
+// arena. The first engine that proves optimality, infeasibility or
+// unboundedness wins: its tableau and basis are copied back in 'tab' and
+// 'basis' and the other engines are cancelled. Returns the status of the
+// winner. If no engine could conclude: TIME_LIMIT or CANCELLED if that is
+// what stopped every engine (or params->cancel is set), ITERATION_LIMIT
+// otherwise.
+int concurrent_simplex(Tableau *tab, size_t *basis, unsigned int engines,
+        ConcurrentResult *res);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef CUTS_H
+#define CUTS_H
+
+#include <stddef.h>
+
+#include "../include/arena.h"
+#include "../include/simple_simplex.h"
+
+// Cuts added so far, stored as unit coefficient vectors over the columns
+// 1..len of the tableau at the time they were generated. Used to score the
+// orthogonality of new candidates.
+typedef struct {
+    size_t count;  // # of cuts in the pool.
+    size_t cap;    // Allocated cuts.
+    size_t *len;   // Length of each cut.
+    double **unit; // Unit coefficient vector of each cut.
+    Arena *arena;  // Allocator (NULL means malloc/free).
+} CutPool;
+
+// A candidate cut: the new tableau row "coef[1..n] x + s = coef[0]", where
+// s >= 0 is the slack of the cut (integer as well). The current vertex
+// violates it if coef[0] < 0.
+typedef struct {
+    int family;           // Separator that generated it (see separators.h).
+    size_t index;         // Generation order, breaks the ties of the score.
+    const Fraction *coef; // Entries 0..n of the row.
+    double efficacy;      // Distance cut off from the current vertex.
+    double orthogonality; // Min 1 - |cos| w.r.t. the cuts in the pool.
+    double score;         // efficacy + weight * orthogonality.
+    double *unit;         // Unit coefficient vector (columns 1..n).
+} CutCandidate;
+
+// Buffers reused by the separation rounds of a solve.
+typedef struct {
+    CutCandidate *cand; // Candidates of the current round.
+    size_t cand_cap;
+    double *units;      // Storage of the unit vectors of the candidates.
+    size_t units_cap;
+    Fraction *coefs;    // Storage of the rows of the candidates.
+    size_t coefs_cap;
+} CutWorkspace;
+
+
+void cut_pool_init(CutPool *pool, Arena *arena);
+void cut_pool_free(CutPool *pool);
+
+// Add a copy of 'unit' (length 'len') to the pool. Returns 0 on success.
+int cut_pool_add(CutPool *pool, const double *unit, size_t len);
+
+// Min of 1 - |cos| between 'unit' and the cuts of the pool (1 if empty).
+double cut_pool_orthogonality(const CutPool *pool, const double *unit, size_t len);
+
+void cut_workspace_init(CutWorkspace *ws);
+void cut_workspace_free(CutWorkspace *ws, Arena *arena);
+
+// Make room for 'count' candidates of 'n' columns. Returns 0 on success.
+int cut_workspace_reserve(CutWorkspace *ws, Arena *arena, size_t count, size_t n);
+
+// Score the candidates ws->cand[0..count) (in parallel, see
+// tab->params->threads) and select the best ones (at most
+// tab->params->cuts_per_round, mutually orthogonal enough). The selected
+// cuts are moved to the front of ws->cand and added to the pool. Returns the
+// # of selected cuts.
+size_t cut_select(const Tableau *tab, CutPool *pool, CutWorkspace *ws, size_t count);
+
+// Write in 'out' (entries 0..n_src) the Gomory cut generated from row 'src'
+// of the tableau: -frac(row_src) (slack excluded).
+void gomory_write_cut(const Tableau *tab, size_t src, Fraction *out, size_t n_src);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Messages between the solver daemon and its clients (see wire.h for the
+// framing). A client may send any number of requests without waiting: they
+// are solved concurrently and each result is sent as soon as it is ready, so
+// results may come back in a different order. A client may shut down its
+// sending side after its last request: it still gets all the results.
+//
+//   client -> daemon  DAEMON_SOLVE   id, algorithm, limits, m, n, the tableau
+//   daemon -> client  DAEMON_RESULT  id, status, pivots, time, cost and the
+//                                    solution x[1..n] (if there is one)
+enum daemon_message {
+    DAEMON_SOLVE = 1, DAEMON_RESULT
+};
+
+// Status of a request that could not be decoded.
+#define DAEMON_REJECTED (-1)
+
+// Requests decoded but not solved yet. Connections are not read while the
+// queue is full.
+#define DAEMON_QUEUE_LIMIT 1024
+
+// Bytes of results not sent yet above which a connection is not read: a
+// client that does not read its results stops being served, not the daemon.
+#define DAEMON_OUTPUT_LIMIT (16u << 20)
+
+// How to solve a request. Zero limits mean the defaults of the daemon.
+typedef struct {
+    int algorithm;       // Value of enum backend_algorithm.
+    int max_iterations;  // Max # of pivots.
+    double time_limit;   // Max seconds.
+} DaemonRequest;
+
+typedef struct {
+    uint64_t id;         // Id of the request.
+    int status;          // Value of enum tableau_status, or DAEMON_REJECTED.
+    uint64_t pivots;
+    double seconds;      // Time spent solving.
+    double objective;    // Cost of the last basis (also for inexact backends).
+    Fraction cost;       // Cost of x.
+    size_t n;            // Variables of x (0 = no solution).
+    Fraction *x;         // x[1..n], malloc'd by the client.
+} DaemonResult;
+
+// Serve the requests of the clients that connect to 'addr' ("unix:PATH" or
+// "HOST:PORT") on 'threads' solver threads (0 = one per CPU), until SIGINT
+// or SIGTERM. 'params' are the defaults of every request; each thread keeps
+// its own arena and buffers from one request to the next. Returns 0 on a
+// clean shutdown.
+int solver_daemon(const char *addr, const SolverParams *params, int threads);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <stddef.h>
+
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Row of the block structure that ties the blocks together.
+#define LINKING_ROW (-1)
+
+typedef struct {
+    size_t blocks;    // Independent blocks (subproblems).
+    size_t linking;   // Linking rows, in the master problem.
+    size_t rounds;    // Pricing rounds of the master.
+    size_t proposals; // Extreme points and rays generated by the blocks.
+    Fraction cost;    // Optimal cost.
+} DecompositionStats;
+
+
+// Detect a block-angular structure: rows are moved to the linking ones,
+// densest first, until the others split in independent blocks. Writes in
+// row_block[i-1] the block of row i (0, 1, ...) or LINKING_ROW and returns
+// the # of blocks (1 if the problem does not decompose).
+size_t decomposition_detect(const Tableau *tab, int *row_block);
+
+// Dantzig-Wolfe decomposition. Every block {x_k >= 0 : B_k x_k = b_k} is a
+// subproblem, the master combines their extreme points (and rays) under the
+// linking rows, with column_generation(). The subproblems are priced in
+// parallel (tab->params->threads) and each one keeps its tableau between
+// two rounds: only its costs change, so it restarts from the last basis.
+// 'row_block' declares the structure (see decomposition_detect(), NULL
+// means detect it). On OPTIMAL the solution is written in x[1..n].
+// 'tab' is not modified.
+int dantzig_wolfe(const Tableau *tab, const int *row_block, Fraction *x,
+        DecompositionStats *stats);
+
+#endif
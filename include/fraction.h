@@ -1,6 +1,7 @@
 #ifndef FRACTION_H
 #define FRACTION_H
 
+#include <stddef.h> // For size_t
 #include <stdlib.h> // Required for EXIT_FAILURE in basic error handling
 
 // Define the Fraction struct
@@ -11,6 +12,10 @@ typedef struct {
 
 // Function prototypes
 
+// Greatest Common Divisor (binary algorithm). Signs are ignored.
+int gcd(int a, int b);
+long long fraction_gcd64(long long a, long long b);
+
 // Create/Initialize a fraction
 // Returns a Fraction struct initialized with num and den.
 // Handles the case where den is 0.
@@ -26,9 +31,12 @@ Fraction fraction_abs(Fraction f);
 Fraction fraction_chg_sign(Fraction f);
 Fraction fraction_floor(Fraction f);
 
+// Approximate value.
+double fraction_to_double(Fraction f);
+
 // Comparison functions
 // These functions return 1 for true, 0 for false.
-// Uses cross-multiplication (ad vs bc). Integer overflow is NOT checked.
+// Uses cross-multiplication (ad vs bc) on 64 bits.
 int fraction_equal(Fraction f1, Fraction f2);
 int fraction_not_equal(Fraction f1, Fraction f2);
 int fraction_less(Fraction f1, Fraction f2);
@@ -36,6 +44,28 @@ int fraction_less_equal(Fraction f1, Fraction f2);
 int fraction_greater(Fraction f1, Fraction f2);
 int fraction_greater_equal(Fraction f1, Fraction f2);
 
+// Batched operations
+// They work on whole arrays, skip zeros and trivial factors and compute
+// intermediate values on 64 bits, so that a single simplification is done
+// per element.
+
+// row[j] = k * row[j], for j in [0, len).
+void fraction_row_scale(Fraction *row, Fraction k, size_t len);
+
+// dst[j] = dst[j] - k * src[j], for j in [0, len).
+void fraction_row_fms(Fraction *dst, const Fraction *src, Fraction k, size_t len);
+
+// Ratio test over the elements num[i * stride] / den[i * stride], i in
+// [0, len). Only the indices where den has the same sign of 'sign' are
+// considered. Returns the index with the smallest absolute ratio, ties are
+// broken by the smallest key[i] (smallest index if 'key' is NULL). Returns
+// 'len' if no index qualifies. Fractions are compared without being built.
+size_t fraction_min_ratio(const Fraction *num, const Fraction *den,
+        size_t stride, size_t len, int sign, const size_t *key);
+
+// Parse a fraction written as "num" or "num/den". Returns 0 on success.
+int fraction_parse(const char *str, Fraction *f);
+
 // Print function
 // Prints the fraction to standard output in the format "num/den".
 void fraction_print(Fraction f);
@@ -0,0 +1,75 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <stddef.h>
+
+#include "../include/fraction.h"
+#include "../include/separators.h"
+#include "../include/simple_simplex.h"
+
+// Primal heuristics of the cutting plane. params->heuristics is a mask of
+// HEURISTIC_BIT() values.
+enum heuristic {
+    HEUR_ROUNDING, // Round the LP vertex in the direction without locks.
+    HEUR_DIVING,   // Bound the least fractional variable and reoptimize with
+                   // dual_simplex(), until the vertex is integer.
+    HEUR_PUMP,     // Feasibility pump: alternate roundings and LPs that
+                   // minimize the distance from the rounding.
+    HEUR_RINS,     // Branch and bound over the variables on which the LP
+                   // vertex and the incumbent disagree.
+    N_HEURISTICS
+};
+
+#define HEURISTIC_BIT(h) (1u << (h))
+
+// Statistics of a heuristic over a solve.
+typedef struct {
+    size_t calls;
+    size_t found;    // Improvements of the incumbent.
+    double seconds;
+} HeuristicStats;
+
+// Best integer solution known, and how far it may be from the optimum.
+typedef struct Incumbent {
+    char found;
+    Fraction cost;
+    Fraction *x;         // x[1..n] (malloc'd when found).
+    size_t n;
+    char has_bound;
+    Fraction bound;      // Lower bound on the cost of every solution.
+    double gap;          // (cost - bound) / max(1, |cost|), 1 if not found.
+    int source;          // Heuristic that found it, N_HEURISTICS if it is the
+                         // vertex of the LP.
+    double seconds;      // When it was found, from the start of the solve.
+    HeuristicStats stats[N_HEURISTICS];
+} Incumbent;
+
+// Names of the heuristics, indexed by enum heuristic.
+extern const char *const heuristic_names[N_HEURISTICS];
+
+// Parse a comma separated list of heuristic names ("rounding,rins") in a
+// mask. Returns 0 on success.
+int heuristics_parse(const char *list, unsigned int *mask);
+
+void incumbent_init(Incumbent *inc);
+void incumbent_free(Incumbent *inc);
+
+// Offer x[1..n] (n = orig->n) as a solution. It is checked against the rows
+// of the original problem and kept if it is cheaper than the incumbent.
+// Returns 1 if the incumbent improved.
+int incumbent_offer(Incumbent *inc, const OriginalProblem *orig,
+        const Fraction *x, int source);
+
+// Raise the lower bound to 'bound' (the cost of a relaxation) and update the
+// gap. With integer costs the bound is rounded up.
+void incumbent_bound(Incumbent *inc, const OriginalProblem *orig, Fraction bound);
+
+// Run the heuristics of tab->params->heuristics from the optimal tableau of
+// a cutting plane round, each one for at most tab->params->heuristic_time
+// seconds and heuristic_iterations pivots, which do not count against the
+// max_iterations of the solve. 'tab' and 'basis' are not modified. Returns 1
+// if the incumbent improved.
+int run_heuristics(const Tableau *tab, const size_t *basis,
+        const OriginalProblem *orig, Incumbent *inc);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef LAZY_H
+#define LAZY_H
+
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Separation oracle of the lazy constraints. 'x' has n+1 entries, x[0] is
+// unused and x[j] is the value of variable j of the original problem. The
+// callback writes at most 'max_rows' rows "a x <= b" in 'rows', one after the
+// other, n+1 entries each: b, then a_1..a_n. Returns the # of rows written
+// (0 if no constraint is violated).
+typedef size_t (*LazyCallback)(const Fraction *x, size_t n,
+        Fraction *rows, size_t max_rows, void *data);
+
+typedef struct {
+    size_t rounds;     // # of calls to the separation oracle.
+    size_t rows_added; // # of rows appended to the problem.
+} LazyStats;
+
+
+// Row generation: solve 'tab', then ask 'separate' for constraints violated
+// by the current solution, append them (in terms of the nonbasic variables,
+// with a slack each) and restore feasibility with dual simplex from the
+// current basis, until the oracle returns no violated row. At most
+// tab->params->lazy_batch rows are requested per round. The basis is grown
+// together with the tableau, so '*basis' must come from tab->arena.
+int lazy_constraints(Tableau *tab, size_t **basis, LazyCallback separate,
+        void *data, LazyStats *stats);
+
+#endif
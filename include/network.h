@@ -0,0 +1,36 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include "../include/simple_simplex.h"
+
+typedef struct {
+    long pivots;  // # of tree exchanges (both phases).
+    double cost;  // Objective value.
+    char written; // 1 if the final tableau and basis were written in 'tab'.
+    size_t redundant; // Rows removed from 'tab' when it was written.
+} NetworkResult;
+
+
+// Return 1 if the constraint matrix of 'tab' is a node-arc incidence matrix,
+// up to the sign of the rows: every column has one or two entries, +1 or -1,
+// and the rows can be negated so that the two entries of a column have
+// opposite signs (e.g. transportation and assignment problems). Costs and
+// rhs must be integer. If 'sign' is not NULL, sign[i-1] (+1 or -1) receives
+// the sign of row i.
+int network_detect(const Tableau *tab, int *sign);
+
+// Network simplex on a problem accepted by network_detect(): row i is node
+// i, a column is an arc (to or from a ground node if it has one entry). The
+// spanning tree is kept with pred/depth/child lists and integer (64 bit)
+// flows and potentials; a pivot costs O(cycle + moved subtree). Two phases,
+// starting from a tree of artificial arcs, with strongly feasible trees
+// against cycling. On OPTIMAL the canonical tableau of the optimal basis is
+// written back in 'tab' and 'basis' (a row per node, with the tree arc that
+// enters it), unless a value does not fit a Fraction or an arc that no
+// feasible flow uses is priced < 0 (res->written). The
+// redundant rows (one per component without ground arcs, e.g. balanced
+// transportation problems) are removed and tab->m decreases. Returns
+// INFEASIBLE, OPTIMAL, UNBOUNDED, or the status of a limit.
+int network_simplex(Tableau *tab, size_t *basis, NetworkResult *res);
+
+#endif
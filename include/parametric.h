@@ -0,0 +1,44 @@
+#ifndef PARAMETRIC_H
+#define PARAMETRIC_H
+
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// A linear piece of the optimal value function: for lambda in [lo, hi] the
+// basis 'basis' is optimal and the cost is z0 + z1 * lambda.
+typedef struct {
+    Fraction lo, hi;
+    Fraction z0, z1;
+    size_t *basis; // m entries.
+} ParametricPiece;
+
+// Result of a parametric analysis.
+typedef struct {
+    size_t m;               // Size of the bases.
+    size_t count;           // # of pieces.
+    size_t cap;             // Allocated pieces.
+    ParametricPiece *pieces;
+    Fraction end;           // Last value of lambda reached.
+    int end_status;         // OPTIMAL if the whole range was covered,
+                            // otherwise the status past 'end'.
+    Arena *arena;
+} ParametricResult;
+
+
+// Parametric rhs: solve  min cx, Ax = b + lambda * d, x >= 0  for every
+// lambda in [lo, hi]. 'd' has m+1 entries, d[0] is ignored. The problem is
+// solved once at 'lo', then lambda is moved through its range with dual
+// simplex pivots, one per breakpoint.
+int parametric_rhs(Tableau *tab, size_t *basis, const Fraction *d,
+        Fraction lo, Fraction hi, ParametricResult *res);
+
+// Parametric cost: solve  min (c + lambda * e)x, Ax = b, x >= 0  for every
+// lambda in [lo, hi]. 'e' has n+1 entries, e[0] is ignored. Breakpoints are
+// crossed with primal simplex pivots.
+int parametric_cost(Tableau *tab, size_t *basis, const Fraction *e,
+        Fraction lo, Fraction hi, ParametricResult *res);
+
+// Print the breakpoints and the pieces of the optimal value function.
+void parametric_print(const ParametricResult *res);
+
+#endif
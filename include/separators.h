@@ -0,0 +1,86 @@
+#ifndef SEPARATORS_H
+#define SEPARATORS_H
+
+#include <stddef.h>
+
+#include "../include/arena.h"
+#include "../include/cuts.h"
+#include "../include/simple_simplex.h"
+
+// Families of cuts of the cutting plane. params->cut_families is a mask of
+// CUT_FAMILY_BIT() values.
+enum cut_family {
+    CUT_GOMORY, // Fractional Gomory cut of a tableau row.
+    CUT_GMI,    // Gomory mixed integer cut of a tableau row, scaled to integer.
+    CUT_COVER,  // Lifted cover of a knapsack row of the original problem.
+    CUT_CLIQUE, // Clique of the conflict graph of the binary variables.
+    N_CUT_FAMILIES
+};
+
+#define CUT_FAMILY_BIT(f) (1u << (f))
+
+// Statistics of a separator over a solve.
+typedef struct SeparatorStats {
+    size_t calls;    // Separation rounds.
+    size_t found;    // Violated cuts generated.
+    size_t selected; // Cuts added to the tableau.
+    double seconds;  // Time spent separating.
+} SeparatorStats;
+
+// Rows of the problem before any cut, with the knapsack structure used by the
+// cover and clique separators. Every variable is integer and >= 0.
+typedef struct {
+    size_t n;            // Original variables.
+    size_t m;            // Original rows.
+    Fraction *rows;      // Rows 1..m of the initial tableau, n+1 entries each.
+    Fraction *cost;      // Row 0 of the initial tableau: the cost of x is
+                         // sum c_j x_j - cost[0].
+    char *binary;        // binary[j] is set if x_j is in {0, 1} (j = 1..n).
+    size_t *knapsacks;   // Rows with integer coefficients >= 0 and rhs > 0.
+    size_t n_knapsacks;
+    size_t n_binaries;
+    size_t *bin_index;   // Index of x_j among the binaries (j = 1..n).
+    char *conflict;      // conflict[i * n_binaries + k]: x_i + x_k <= 1
+                         // (NULL if there are too many binaries).
+    Fraction *x;         // Values of the variables at the current vertex.
+    void *scratch;       // Buffers of the separators.
+    Arena *arena;        // Allocator (NULL means malloc/free).
+} OriginalProblem;
+
+// Input of a separator.
+typedef struct {
+    const Tableau *tab;
+    const size_t *basis;
+    const OriginalProblem *orig; // NULL if no separator or heuristic needs it.
+} SeparationInput;
+
+// A cut separator. separate() writes in 'cuts' at most 'max' violated cuts,
+// each one as the tab->n + 1 entries of a CutCandidate row, and returns how
+// many. max_cuts() bounds the cuts of a round.
+typedef struct {
+    const char *name;
+    size_t (*max_cuts)(const SeparationInput *in);
+    size_t (*separate)(const SeparationInput *in, Fraction *cuts, size_t max);
+} CutSeparator;
+
+// Separators, indexed by enum cut_family.
+extern const CutSeparator cut_separators[N_CUT_FAMILIES];
+
+// Parse a comma separated list of family names ("gomory,cover") in a mask.
+// Returns 0 on success.
+int cut_families_parse(const char *list, unsigned int *mask);
+
+// Save the rows of 'tab' (not solved yet) and detect the binary variables,
+// the knapsack rows and the conflicts. Returns 0 on success.
+int original_problem_init(OriginalProblem *orig, const Tableau *tab);
+void original_problem_free(OriginalProblem *orig);
+
+// A separation round: run the separators enabled in tab->params->cut_families
+// and select the best cuts among all of them (see cut_select()). The Gomory
+// separator runs if the enabled ones find nothing, so that a fractional
+// vertex always has a cut. The selected cuts are at the front of ws->cand.
+// tab->params->cut_stats is updated. Returns the # of selected cuts (0 only
+// if the memory runs out).
+size_t separate_cuts(const SeparationInput *in, CutPool *pool, CutWorkspace *ws);
+
+#endif
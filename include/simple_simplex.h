@@ -1,35 +1,178 @@
 #ifndef SIMPLE_SIMPLEX_H
 #define SIMPLE_SIMPLEX_H
 
+#include <stdatomic.h>
 #include <stdio.h>
 
+#include "../include/arena.h"
 #include "../include/fraction.h"
 #include "../include/utils.h"
 
+// Strategies used when the simplex stalls on degenerate pivots.
+enum degeneracy_mode {
+    DEGEN_NONE,          // Bland's rule only.
+    DEGEN_PERTURB,       // Random perturbation of the rhs.
+    DEGEN_LEXICOGRAPHIC  // Lexicographic ratio test.
+};
+
+// Progress of a solve, written by the solver and readable from other threads.
+typedef struct {
+    atomic_long pivots;       // Pivots done so far.
+    atomic_long rounds;       // Rounds of the cutting plane (or row generation).
+    _Atomic double objective; // Cost of the current basis: an upper bound in
+                              // primal simplex, a lower bound in dual simplex
+                              // and cutting plane.
+    _Atomic double seconds;   // Elapsed wall-clock time.
+} SolverProgress;
+
+// Clock and pivot count of a solve, shared by the threads working for it.
+typedef struct {
+    double start;             // Monotonic seconds at the start of the solve.
+    atomic_long pivots;       // Pivots done so far, on any thread.
+} SolveScope;
+
+// Solver parameters.
+typedef struct {
+    int max_iterations;  // Max # of pivots of a solve (0 = no limit), see
+                         // solve_begin() for what a solve counts.
+    int degeneracy;      // Value of enum degeneracy_mode.
+    int stall_threshold; // # of consecutive degenerate pivots before acting.
+    unsigned int seed;   // Seed of the random perturbation.
+    int threads;         // # of threads used to evaluate the cuts.
+    int cuts_per_round;  // Max # of cuts added by a cutting plane round.
+    double cut_ortho_weight;      // Weight of the orthogonality in the score.
+    double cut_min_orthogonality; // Min orthogonality among the cuts of a round.
+    const char *checkpoint_path;  // Snapshot of the cutting plane (NULL = none).
+    double checkpoint_interval;   // Min seconds between two snapshots.
+    atomic_int *cancel;  // The solve stops when set to 1 (NULL = never).
+    int verbose;         // Print the iterations of the solvers.
+    int backend;         // Value of enum numeric_backend (see backend.h).
+    int colgen_batch;    // Max # of columns priced per column generation round.
+    int lazy_batch;      // Max # of lazy rows added per round.
+    double time_limit;   // Max wall-clock seconds of a solve (0 = no limit).
+    SolverProgress *progress; // Updated during the solve (NULL = none).
+    int network;         // Route network problems of modes S and TPS to the
+                         // network simplex (see network.h).
+    unsigned int cut_families; // Separators of the cutting plane, bit mask of
+                               // enum cut_family (see separators.h).
+    int cut_max_scale;   // Max multiplier that makes a GMI cut integer.
+    struct SeparatorStats *cut_stats; // One per cut family, updated by the
+                                      // cutting plane (NULL = none).
+    unsigned int heuristics; // Primal heuristics of the cutting plane, bit
+                             // mask of enum heuristic (see heuristics.h).
+    double heuristic_time;   // Max seconds of a heuristic call (0 = no limit).
+    int heuristic_iterations; // Max pivots of a heuristic call (0 = no
+                              // limit), not counted in max_iterations.
+    double gap_limit;        // The cutting plane stops when the relative gap
+                             // of the incumbent is <= gap_limit.
+    struct Incumbent *incumbent; // Best integer solution found by the cutting
+                                 // plane (NULL = none).
+    SolveScope *scope;   // Solve that a thread with these parameters works
+                         // for (NULL = its solvers start their own).
+} SolverParams;
+
 // FIXME: add a "constructor".
 typedef struct {
     size_t n;  // # of columns of the constraint matrix.
     size_t m;  // # of rows of the constraint matrix.
-    Fraction *data; // (m+1) x (n+1) matrix.
+    Fraction *data; // (m+1) x (n+1) matrix, rows are 'stride' elements apart.
+    Arena *arena;   // Allocator of 'data' (NULL means malloc/free).
+    size_t stride;  // Allocated columns (>= n+1), 0 means n+1.
+    size_t row_cap; // Allocated rows (>= m+1), 0 means m+1.
+    const SolverParams *params; // Solver parameters (NULL means defaults).
 } Tableau;
 
+// Distance between two consecutive rows of the tableau.
+static inline size_t tableau_stride(const Tableau *tab) {
+    return tab->stride ? tab->stride : tab->n + 1;
+}
+
+// Cost of the current basis (-z), as a double.
+static inline double tableau_cost(const Tableau *tab) {
+    return -(double) tab->data[0].num / tab->data[0].den;
+}
+
 enum tableau_status {
-    INFEASIBLE, FEASIBLE, OPTIMAL, UNBOUNDED
+    INFEASIBLE, FEASIBLE, OPTIMAL, UNBOUNDED, ITERATION_LIMIT, CANCELLED,
+    NUMERIC_OVERFLOW, TIME_LIMIT
 };
 
-
-// Load the tableau specified by the user.
+// Set the default solver parameters.
+void solver_params_default(SolverParams *params);
+
+// Parameters of the tableau (defaults if tab->params is NULL).
+const SolverParams *tableau_params(const Tableau *tab);
+
+// Return 1 if the solve was cancelled through params->cancel.
+static inline int solver_cancelled(const SolverParams *params) {
+    return params->cancel && atomic_load_explicit(params->cancel, memory_order_relaxed);
+}
+
+// Limits of a solve. A solve is a call of a solver by its caller, with every
+// solver it runs in turn: the outermost solve_begin() of a thread starts the
+// clock and the pivot count of max_iterations and time_limit, the nested
+// solvers share them until the matching solve_end(). The threads that work
+// for the solve (the subproblems of dantzig_wolfe()) share them through
+// params->scope, the worker processes of branch_and_bound() get what is left
+// with each node and report their pivots back. The engines of
+// concurrent_simplex() race with a budget each.
+void solve_begin(const SolverParams *params);
+void solve_end(void);
+
+// Scope of the solve running on this thread (NULL outside a solve), for the
+// parameters of the threads that work for it.
+SolveScope *solve_scope(void);
+
+// Pivots of the solve running on this thread, and pivots done for it by
+// another process.
+long solve_pivots(void);
+void solve_add_pivots(long pivots);
+
+// Seconds since the outermost solve_begin() of this thread (0 outside a
+// solve). A nested solver gets a deadline by setting its time_limit to
+// solve_elapsed() + budget.
+double solve_elapsed(void);
+
+// Return 1 if the solve must stop, with the reason (ITERATION_LIMIT,
+// TIME_LIMIT or CANCELLED) in 'status'. The tableau is left at the last
+// basis, whose cost is the best bound of the solver.
+int solve_stop(const SolverParams *params, int *status);
+
+// Record a pivot (or a round) that reached 'cost' in params->progress.
+void solve_pivot(const SolverParams *params, double cost);
+void solve_round(const SolverParams *params, double cost);
+
+// printf() that prints only if params->verbose is set.
+void solver_log(const SolverParams *params, const char *fmt, ...);
+
+
+// Load the tableau specified by the user. Memory is taken from 'arena'
+// (NULL means malloc).
 int load_tableau(const char *num_fn, const char *den_fn, int rows, int cols,
-        Tableau *tab);
+        Arena *arena, Tableau *tab);
 
 // Find the starting point for the dual simplex.
 int search_starting_basis(Tableau *tab, size_t *basis);
 
+// Pivot on element (t, h). With 'minipivot' only 'row' is updated. The rows of
+// an out-of-core tableau (tab->arena from arena_init_mapped()) are updated in
+// blocks that stream through the file.
 void pivot_operations(Tableau *tab, size_t h, size_t t, int minipivot, size_t row);
 
 // Print the tableau in a nice way :).
 void pretty_print_tableau(Tableau *tab, size_t *basis);
 
+// Write in 'out' ('width' entries) the row 'row' (b, then a_1..a_n) of the
+// variables 1..n expressed in the basis of the rows 1..rows of the tableau:
+// the basic variables are substituted out with their tableau rows.
+void tableau_express_row(const Tableau *tab, const size_t *basis, size_t rows,
+        const Fraction *row, size_t n, size_t width, Fraction *out);
+
+// Write in 'x' (n+1 entries, x[0] = 0) the values of the variables 1..n at
+// the vertex of the basis. Returns 1 if the classic fractions overflowed (a
+// denominator that is not positive).
+int tableau_vertex(const Tableau *tab, const size_t *basis, size_t n, Fraction *x);
+
 // FIXME: implement the bland's rule.
 // Return 1 if the problem is unbounded, 0 otherwise.
 // If the problem is not unbounded, then 't' contains the pivot row index.
@@ -40,11 +183,22 @@ char unbounded_check(Tableau *tab, size_t h, size_t *t, size_t *basis);
 // variable that enters the basis.
 char optimality_check(Tableau *tab, size_t *h);
 
+// Apply to 'col' (m+1 entries, one per row) the row operations of the pivot
+// on element (t, h). Must be called before pivot_operations().
+void pivot_aux_column(Tableau *tab, Fraction *col, size_t h, size_t t);
+
+// Primal simplex. Stalling is handled according to tab->params->degeneracy.
+// Returns OPTIMAL, UNBOUNDED, ITERATION_LIMIT, TIME_LIMIT or CANCELLED.
 int simplex(Tableau *tab, size_t *basis);
 
 // Phase 1 of Two phases simplex method.
 int phase_one(Tableau *tab, size_t *basis);
 
+// Two phases simplex: phase one is skipped if the tableau already contains
+// a starting basis. Returns INFEASIBLE, OPTIMAL, UNBOUNDED, ITERATION_LIMIT,
+// TIME_LIMIT or CANCELLED.
+int two_phase_simplex(Tableau *tab, size_t *basis);
+
 // FIXME: implement blan's rule.
 int dual_optimality_check(Tableau *tab, size_t *t, size_t *basis);
 
@@ -53,7 +207,31 @@ char dual_unbounded_check(Tableau *tab, size_t t, size_t *h);
 // Dual simplex algorithm.
 int dual_simplex(Tableau *tab, size_t *basis);
 
-// Cutting plane algorithm.
-int cutting_plane(Tableau *tab, size_t *basis);
+// Grow the tableau to new_m rows and new_n columns. Old entries are kept,
+// new ones are left uninitialized. Capacity grows geometrically, so repeated
+// augmentations are amortized.
+int augment_tableau(Tableau *tab, size_t new_n, size_t new_m);
+
+// Append 'k' rows to the constraints, each one with a new slack column that
+// enters the basis. Entries 0..n (old n) of the new rows are left to the
+// caller. '*basis' must come from tab->arena and is grown accordingly.
+// Returns 0 on success.
+int append_rows(Tableau *tab, size_t **basis, size_t k);
+
+// Cutting plane algorithm. The basis is grown together with the tableau, so
+// '*basis' must come from tab->arena (or malloc if tab->arena is NULL).
+// If tab->params->checkpoint_path is set, the state is saved there between two
+// rounds (at most every checkpoint_interval seconds).
+// The heuristics of tab->params->heuristics run between two rounds: once the
+// gap of their incumbent reaches gap_limit the algorithm stops and returns
+// OPTIMAL if the gap is zero, FEASIBLE otherwise, the solution being in
+// tab->params->incumbent (not in the tableau).
+int cutting_plane(Tableau *tab, size_t **basis);
+
+// Resume the cutting plane algorithm from the snapshot in 'path'. 'tab' must
+// hold the problem of the snapshot, before any cut: the tableau and the basis
+// are replaced by the ones of the snapshot, allocated from tab->arena;
+// tab->params is kept.
+int cutting_plane_resume(const char *path, Tableau *tab, size_t **basis);
 
 #endif
@@ -0,0 +1,65 @@
+#ifndef SOA_TABLEAU_H
+#define SOA_TABLEAU_H
+
+#include <stddef.h>
+
+#include "../include/arena.h"
+#include "../include/fraction.h"
+#include "../include/simple_simplex.h"
+
+// Every row is padded to a multiple of this many elements, so that each row
+// of 'num' and 'den' starts on a 32 bytes boundary.
+#define SOA_ROW_ALIGN 8
+
+// Structure-of-arrays version of the tableau: numerators and denominators are
+// stored in two separate contiguous (m+1) x stride matrices.
+typedef struct {
+    size_t n;      // # of columns of the constraint matrix.
+    size_t m;      // # of rows of the constraint matrix.
+    size_t stride; // Padded row length (>= n + 1).
+    int *num;      // Numerators.
+    int *den;      // Denominators (always positive).
+
+    // Scratch rows used by the batched kernels (stride elements each).
+    long long *scratch_num;
+    long long *scratch_den;
+
+    Arena *arena;  // Allocator of the arrays (NULL means malloc/free).
+    const SolverParams *params; // Solver parameters (NULL means defaults).
+} SoaTableau;
+
+
+// Allocate an (m+1) x (n+1) SoA tableau from 'arena' (NULL means malloc).
+// Returns 0 on success.
+int soa_tableau_create(SoaTableau *soa, size_t n, size_t m, Arena *arena);
+
+// Release the memory of the SoA tableau (a no-op for arena memory).
+void soa_tableau_free(SoaTableau *soa);
+
+// Convert 'tab' to the SoA layout. 'soa' is allocated by the function from
+// tab->arena and shares the parameters of 'tab'.
+int soa_tableau_from_tableau(SoaTableau *soa, const Tableau *tab);
+
+// Copy the SoA tableau back in 'tab', that must have the same size.
+void soa_tableau_to_tableau(const SoaTableau *soa, Tableau *tab);
+
+// Batched row kernels.
+// row_i = k * row_i.
+void soa_row_scale(SoaTableau *soa, size_t i, int k_num, int k_den);
+// row_i = row_i - k * row_t.
+void soa_row_fms(SoaTableau *soa, size_t i, size_t t, int k_num, int k_den);
+
+// Pivot on element (t, h) of the tableau.
+void soa_pivot_operations(SoaTableau *soa, size_t h, size_t t);
+
+// Same as unbounded_check() (primal ratio test on column 'h').
+char soa_unbounded_check(SoaTableau *soa, size_t h, size_t *t, size_t *basis);
+
+// Same as dual_unbounded_check() (dual ratio test on row 't').
+char soa_dual_unbounded_check(SoaTableau *soa, size_t t, size_t *h);
+
+// Simplex and dual simplex on the SoA layout.
+int soa_simplex(SoaTableau *soa, size_t *basis);
+int soa_dual_simplex(SoaTableau *soa, size_t *basis);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef SOLVER_CLIENT_H
+#define SOLVER_CLIENT_H
+
+#include <stdint.h>
+
+#include "../include/daemon.h"
+#include "../include/simple_simplex.h"
+#include "../include/wire.h"
+
+// Connection to a solver daemon. A client is not thread safe: use one per
+// thread.
+typedef struct {
+    int fd;
+    uint64_t next_id;
+    WireBuffer buf;
+} SolverClient;
+
+// Returns 0 on success.
+int solver_client_connect(SolverClient *client, const char *addr);
+void solver_client_close(SolverClient *client);
+
+// Send the problem in 'tab' (not solved yet) without waiting for the result.
+// Its id is stored in 'id'. Returns 0 on success.
+int solver_client_submit(SolverClient *client, const Tableau *tab,
+        const DaemonRequest *req, uint64_t *id);
+
+// Wait for the next result, of any of the requests in flight. Returns 0 on
+// success, 1 if the daemon closed the connection, -1 on error.
+int solver_client_receive(SolverClient *client, DaemonResult *res);
+
+// Submit a request and wait for its result (no other request must be in
+// flight).
+int solver_client_solve(SolverClient *client, const Tableau *tab,
+        const DaemonRequest *req, DaemonResult *res);
+
+void daemon_result_free(DaemonResult *res);
+
+#endif
@@ -14,4 +14,9 @@
 // Free and null a pointer.
 void free_and_null(char **ptr);
 
+// Parse a comma separated list of the 'count' names of 'names' into a mask
+// (bit k set for names[k]). Returns 1 on an unknown or empty list.
+int parse_name_list(const char *list, const char *const *names, int count,
+        unsigned int *mask);
+
 #endif
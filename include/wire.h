@@ -0,0 +1,81 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../include/fraction.h"
+
+// Framing of the messages between processes: a 12 bytes header (magic, type,
+// payload length as little endian uint32) followed by the payload. Integers
+// of the payload are little endian too, so the peers may run on different
+// hosts.
+#define WIRE_MAGIC 0x42425353u // "SSBB"
+#define WIRE_MAX_PAYLOAD (1u << 30)
+#define WIRE_READ_SIZE (64u << 10)
+
+// Growable payload, written with wire_put_*() and read back with wire_get_*().
+typedef struct {
+    unsigned char *data;
+    size_t len;  // Bytes written.
+    size_t cap;  // Allocated bytes.
+    size_t pos;  // Read position.
+    char error;  // Set by a failed put (no memory) or get (short payload).
+} WireBuffer;
+
+void wire_init(WireBuffer *buf);
+void wire_free(WireBuffer *buf);
+
+// Empty the buffer, keeping its memory.
+void wire_clear(WireBuffer *buf);
+
+void wire_put_u32(WireBuffer *buf, uint32_t v);
+void wire_put_u64(WireBuffer *buf, uint64_t v);
+void wire_put_fraction(WireBuffer *buf, Fraction f);
+void wire_put_double(WireBuffer *buf, double v); // IEEE 754 bits.
+
+// Missing bytes read as 0 and set buf->error. So does a fraction whose
+// denominator is not positive: the solvers take the sign from the numerator.
+uint32_t wire_get_u32(WireBuffer *buf);
+uint64_t wire_get_u64(WireBuffer *buf);
+Fraction wire_get_fraction(WireBuffer *buf);
+double wire_get_double(WireBuffer *buf);
+
+// Send / receive a whole message. wire_recv() blocks until the message is
+// complete and returns 1 if the peer closed the connection. A payload longer
+// than 'max_len' bytes (capped at WIRE_MAX_PAYLOAD) is an error, detected
+// before anything is allocated. Both return -1 on error, 0 on success.
+int wire_send(int fd, uint32_t type, const WireBuffer *payload);
+int wire_recv(int fd, uint32_t *type, WireBuffer *payload, size_t max_len);
+
+// Non-blocking peers keep the bytes of the messages in a WireBuffer whose
+// 'pos' marks what is consumed (or sent) already.
+//
+// wire_read() appends what 'fd' has available, at most WIRE_READ_SIZE bytes,
+// without blocking even if 'fd' is a blocking socket: returns 0 (also when nothing can be read yet), 1 at the end of the stream
+// and -1 on error. wire_next() moves the payload of the first complete
+// message of 'buf' to 'payload': returns 1 if there was one, 0 if more bytes
+// are needed and -1 on a bad header (same checks as wire_recv()).
+int wire_read(int fd, WireBuffer *buf);
+int wire_next(WireBuffer *buf, uint32_t *type, WireBuffer *payload, size_t max_len);
+
+// wire_append() adds a whole message to 'buf'; wire_write() sends what 'fd'
+// accepts without blocking and empties 'buf' once everything is sent. Both
+// return -1 on error, 0 on success.
+int wire_append(WireBuffer *buf, uint32_t type, const WireBuffer *payload);
+int wire_write(int fd, WireBuffer *buf);
+
+// Return 1 if a message (or the end of the connection) can be read from 'fd'
+// without blocking.
+int wire_pending(int fd);
+
+// Sockets. An address is "unix:PATH" (Unix socket) or "HOST:PORT" (TCP).
+// Return the socket descriptor, or -1 on error.
+int wire_listen(const char *addr);
+int wire_accept(int fd);
+int wire_connect(const char *addr);
+
+// Close a listening socket, removing its path if it is a Unix one.
+void wire_close_listener(int fd, const char *addr);
+
+#endif
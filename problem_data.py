@@ -28,4 +28,87 @@ c = [-4, -5, 0, 0, 0]
 #    - TPS => Two Phase Simplex
 #    - DS  => Dual Simplex
 #    - CP  => Cutting Plane
+#    - SOA  => (Primal) Simplex, structure-of-arrays tableau layout
+#    - DSOA => Dual Simplex, structure-of-arrays tableau layout
+#    - NET  => Network simplex (node-arc incidence matrix, up to row signs);
+#              S and TPS switch to it on such problems with --network=1
+#    - CG   => Column generation, columns priced from the pool in 'columns'
+#    - LAZY => Lazy constraints, violated rows separated from the pool in 'rows'
+#    - DW   => Dantzig-Wolfe decomposition of a block-angular problem, the
+#              blocks are solved in parallel (--threads)
+#    - BB   => Branch and bound, in this process or on worker processes
+#              (--listen, --spawn); start a worker with: out --worker=ADDRESS
+#    - CONC => Concurrent optimizer: the simplex variants race on separate
+#              threads, the first one to conclude wins
+#    - PRHS  => Parametric rhs:  b + lambda * d, lambda in lambda_range
+#    - PCOST => Parametric cost: c + lambda * e, lambda in lambda_range
 mode = "CP"
+
+# Parametric analysis (modes PRHS and PCOST only).
+# d = [1, -1, 2]
+# e = [1, 1, 0, 0, 0]
+# lambda_range = (0, 10)
+
+# Column generation (mode CG only): candidate columns, [cost, a_1, ..., a_m].
+# columns = [[-3, 1, 0, 1], [-2, 0, 1, 1]]
+
+# Lazy constraints (mode LAZY only): candidate rows a x <= b, [b, a_1, ..., a_n].
+# rows = [[4, 1, 1, 0, 0, 0], [6, 2, 0, 1, 0, 0]]
+
+# Solver options (optional).
+# Possible values:
+#    - --max-itr=N     => Max # of pivots of a solve (0 = no limit): of the
+#                         whole run of the mode, with the threads and
+#                         workers it uses (each engine of CONC has its own)
+#    - --time-limit=S  => Max wall-clock seconds of a solve (0 = no limit)
+#    - --progress=S    => Solve S, TPS, DS and CP on a separate thread and
+#                         report the progress every S seconds instead of
+#                         printing the iterations
+#    - --degeneracy=M  => Stalling handling: none, perturb, lex
+#    - --stall=N       => # of consecutive degenerate pivots before acting
+#    - --seed=N        => Seed of the random perturbation
+#    - --threads=N     => # of threads used to evaluate the cuts
+#    - --cuts=N        => Max # of cuts added by a cutting plane round
+#    - --separators=L  => Cut families of the cutting plane, comma separated:
+#                         gomory (default), gmi, cover, clique; a round
+#                         without any of their cuts adds Gomory cuts
+#    - --gmi-scale=N   => Max multiplier that makes a GMI cut integer (1000)
+#    - --heuristics=L  => Primal heuristics run between the cutting plane
+#                         rounds, comma separated: rounding, diving, pump, rins
+#    - --heuristic-time=S => Max seconds of a heuristic call (default 1)
+#    - --heuristic-itr=N => Max # of pivots of a heuristic call, not counted
+#                         by --max-itr (0 = no limit)
+#    - --gap=G         => Stop the cutting plane when the relative gap of the
+#                         incumbent of the heuristics is <= G (default 0),
+#                         with status optimal when the gap is 0
+#    - --checkpoint=F  => Save the cutting plane state in file F
+#    - --checkpoint-every=S => Min seconds between two snapshots (default 60)
+#    - --resume=F      => Resume the cutting plane from the snapshot in F
+#    - --colgen-batch=N => Max # of columns added per column generation round
+#    - --lazy-batch=N  => Max # of rows added per lazy constraint round
+#    - --blocks=L      => Block of each row in mode DW, -1 for the linking rows
+#                         (default: detected), e.g. --blocks=-1,0,0,1,1
+#    - --listen=A      => Mode BB: the workers connect to A, HOST:PORT or
+#                         unix:PATH
+#    - --workers=N     => Mode BB: workers to wait for before branching
+#                         (default: the spawned ones); daemon: solver threads
+#                         (default: one per CPU)
+#    - --spawn=N       => Mode BB: fork N local workers on --listen
+#    - --connect=A     => Send the problem (modes S, TPS, DS and CP) to the
+#                         daemon at A, started with: out --daemon=A [options]
+#    - --requests=N    => Send it N times, pipelined, and report the throughput
+#    - --network=0|1   => Detect network problems in modes S and TPS (default 0)
+#    - --out-of-core=D => Keep the tableau in a memory-mapped file in directory D,
+#                         for models larger than RAM
+#    - --backend=B     => Solver of S, TPS, DS and CP: classic (the full Fraction
+#                         solver), or a reduced core (Bland's rule, one Gomory
+#                         cut per round) on q32, q64, mpq (needs GMP), f64 or
+#                         auto (q32, wider on overflow). Only classic has
+#                         --degeneracy, --separators, --cuts, --heuristics,
+#                         --gap, --checkpoint and --resume
+options = []
+
+# Solver daemon (optional): run_solver.py sends the problem to a daemon
+# started with `./build/out --daemon=unix:PATH [options]` instead of spawning
+# the solver (modes S, TPS, DS and CP).
+# daemon = "unix:/tmp/simplex.sock"
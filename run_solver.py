@@ -1,6 +1,8 @@
 import numpy as np
 from fractions import Fraction
 import os
+import socket
+import struct
 
 # File in which the user specify the data.
 import problem_data 
@@ -10,9 +12,28 @@ NUM_FN = "./data/numerators"
 # Denominators file name.
 DEN_FN = "./data/denominators"
 
+# Direction of the parametric analysis (modes PRHS and PCOST).
+DIR_NUM_FN = "./data/dir_numerators"
+DIR_DEN_FN = "./data/dir_denominators"
+
+# Column pool of the column generation (mode CG).
+COL_NUM_FN = "./data/col_numerators"
+COL_DEN_FN = "./data/col_denominators"
+
+# Row pool of the lazy constraints (mode LAZY).
+ROW_NUM_FN = "./data/row_numerators"
+ROW_DEN_FN = "./data/row_denominators"
+
 # Binary executable path.
 exec_cmd = "./build/out"
 
+# Messages of the solver daemon (see include/daemon.h and include/wire.h).
+WIRE_MAGIC = 0x42425353
+DAEMON_SOLVE, DAEMON_RESULT = 1, 2
+DAEMON_ALGORITHMS = {"S": 0, "TPS": 0, "DS": 1, "CP": 2}
+STATUS_NAMES = ["infeasible", "feasible", "optimal", "unbounded", "iteration limit",
+                "cancelled", "numeric overflow", "time limit"]
+
 # Save the denominators and numerators in a binary file.
 def matrix_to_bin_file(matrix, num_fn, den_fn):
 
@@ -32,6 +53,39 @@ def matrix_to_bin_file(matrix, num_fn, den_fn):
     denominators.tofile(den_fn)   
 
 
+# Solve the tableau on the daemon listening on 'address' ("unix:PATH"),
+# without spawning the solver nor writing files.
+def solve_on_daemon(address, tableau, mode):
+    rows, cols = tableau.shape
+    payload = struct.pack("<QIIdII", 1, DAEMON_ALGORITHMS[mode], 0, 0.0, rows - 1, cols - 1)
+    payload += b"".join(struct.pack("<ii", f.numerator, f.denominator) for f in tableau.flat)
+
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(address[len("unix:"):])
+        sock.sendall(struct.pack("<III", WIRE_MAGIC, DAEMON_SOLVE, len(payload)) + payload)
+
+        def read(size):
+            data = b""
+            while len(data) < size:
+                chunk = sock.recv(size - len(data))
+                if not chunk:
+                    raise ConnectionError("the daemon closed the connection")
+                data += chunk
+            return data
+
+        _, kind, length = struct.unpack("<III", read(12))
+        result = read(length)
+
+    _, status, pivots, seconds, objective, num, den, n = struct.unpack_from("<QiQddiiI", result)
+    x = struct.unpack_from("<%di" % (2 * n), result, 48)
+    print("Status: %s (%d pivots, %.4f s)." % (
+        STATUS_NAMES[status] if 0 <= status < len(STATUS_NAMES) else "rejected", pivots, seconds))
+    print("        Cost = %s" % (Fraction(num, den) if n else objective))
+    for j in range(n):
+        if x[2 * j]:
+            print("        x[%d] = %s" % (j + 1, Fraction(x[2 * j], x[2 * j + 1])))
+
+
 # Returns the tableau.
 def construct_tableau(A, b, c):
     # Transform in an np.array.
@@ -67,13 +121,42 @@ if __name__ == "__main__":
     # Create the tableau.
     Tableau = construct_tableau(problem_data.A, problem_data.b, problem_data.c)
 
+    # A running daemon solves the problem directly.
+    daemon = getattr(problem_data, "daemon", None)
+    if daemon:
+        solve_on_daemon(daemon, Tableau, problem_data.mode)
+        raise SystemExit
+
     # Crate binary files of the data.
     matrix_to_bin_file(Tableau, NUM_FN, DEN_FN)
 
     # Define the remaning paramters.
     rows, cols = Tableau.shape
     mode = problem_data.mode
+    options = " ".join(getattr(problem_data, "options", []))
+
+    # Parametric analysis: d (rhs) or e (cost) direction and lambda range.
+    if mode in ("PRHS", "PCOST"):
+        direction = problem_data.d if mode == "PRHS" else problem_data.e
+        direction = np.array([[Fraction(0)] + [Fraction(x) for x in direction]])
+        matrix_to_bin_file(direction, DIR_NUM_FN, DIR_DEN_FN)
+
+        lo, hi = problem_data.lambda_range
+        options += f" --direction={DIR_NUM_FN},{DIR_DEN_FN}"
+        options += f" --lambda={Fraction(lo)}:{Fraction(hi)}"
+
+    # Column generation: the pool, one column per row of the file.
+    if mode == "CG":
+        pool = np.array([[Fraction(x) for x in col] for col in problem_data.columns])
+        matrix_to_bin_file(pool, COL_NUM_FN, COL_DEN_FN)
+        options += f" --columns={COL_NUM_FN},{COL_DEN_FN}"
+
+    # Lazy constraints: the pool, one row per row of the file.
+    if mode == "LAZY":
+        pool = np.array([[Fraction(x) for x in row] for row in problem_data.rows])
+        matrix_to_bin_file(pool, ROW_NUM_FN, ROW_DEN_FN)
+        options += f" --rows={ROW_NUM_FN},{ROW_DEN_FN}"
 
     # Execute
-    to_execute = f"{exec_cmd} {NUM_FN} {DEN_FN} {rows} {cols} {mode}"
+    to_execute = f"{exec_cmd} {NUM_FN} {DEN_FN} {rows} {cols} {mode} {options}"
     os.system(to_execute)
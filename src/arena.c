@@ -0,0 +1,193 @@
+#include "../include/arena.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define ARENA_ALIGN 16
+
+// Round 'sz' up to a multiple of ARENA_ALIGN.
+static size_t align_up(size_t sz) {
+    return (sz + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
+}
+
+void arena_init(Arena *a, size_t chunk_size) {
+    a->first = NULL;
+    a->current = NULL;
+    a->chunk_size = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK;
+    a->in_use = 0;
+    a->peak = 0;
+    a->reserved = 0;
+    a->fd = -1;
+    a->file_size = 0;
+}
+
+int arena_init_mapped(Arena *a, size_t chunk_size, const char *dir) {
+    arena_init(a, chunk_size);
+
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/simplex-XXXXXX", dir) >= (int) sizeof(path)) {
+        fprintf(stderr, "Error - Directory name '%s' is too long.\n", dir);
+        return 1;
+    }
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        fprintf(stderr, "Error - Cannot create a file in '%s'.\n", dir);
+        return 1;
+    }
+
+    // The file lives as long as the descriptor.
+    unlink(path);
+    a->fd = fd;
+    return 0;
+}
+
+// Bytes mapped for a chunk.
+static size_t mapped_size(const ArenaChunk *chunk) {
+    return sizeof(ArenaChunk) + chunk->size;
+}
+
+void arena_destroy(Arena *a) {
+    ArenaChunk *chunk = a->first;
+    while (chunk != NULL) {
+        ArenaChunk *next = chunk->next;
+        if (a->fd >= 0) munmap(chunk, mapped_size(chunk));
+        else free(chunk);
+        chunk = next;
+    }
+    if (a->fd >= 0) close(a->fd);
+    a->fd = -1;
+    a->file_size = 0;
+    a->first = NULL;
+    a->current = NULL;
+    a->in_use = 0;
+}
+
+// Map a chunk of at least 'size' bytes at the end of the file. The chunks
+// are read and written front to back by the pivots, hence the hint.
+static ArenaChunk *map_chunk(Arena *a, size_t size) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t len = (sizeof(ArenaChunk) + size + page - 1) / page * page;
+
+    // Reserve the blocks now: a full disk must not fault on first write.
+    if (posix_fallocate(a->fd, (off_t) a->file_size, (off_t) len)) return NULL;
+    void *p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, a->fd,
+            (off_t) a->file_size);
+    if (p == MAP_FAILED) return NULL;
+    madvise(p, len, MADV_SEQUENTIAL);
+    a->file_size += len;
+
+    ArenaChunk *chunk = p;
+    chunk->size = len - sizeof(ArenaChunk);
+    return chunk;
+}
+
+// Make 'current' a chunk with at least 'sz' free bytes.
+// Chunks that follow 'current' are empty, so they can be reused.
+static int arena_next_chunk(Arena *a, size_t sz) {
+    ArenaChunk *next = a->current ? a->current->next : a->first;
+
+    if (next == NULL || next->size < sz) {
+        size_t size = sz > a->chunk_size ? sz : a->chunk_size;
+        ArenaChunk *chunk;
+        if (a->fd >= 0) {
+            chunk = map_chunk(a, size);
+            if (chunk == NULL) return 1;
+            size = chunk->size;
+        } else {
+            chunk = malloc(sizeof(ArenaChunk) + size);
+            if (chunk == NULL) return 1;
+            chunk->size = size;
+        }
+
+        chunk->next = next;
+        if (a->current) a->current->next = chunk;
+        else a->first = chunk;
+
+        a->reserved += size;
+        next = chunk;
+    }
+
+    next->used = 0;
+    a->current = next;
+    return 0;
+}
+
+void *arena_alloc(Arena *a, size_t sz) {
+    if (a == NULL) return malloc(sz);
+
+    sz = align_up(sz ? sz : 1);
+
+    if (a->current == NULL || a->current->size - a->current->used < sz) {
+        if (arena_next_chunk(a, sz)) {
+            fprintf(stderr, "Error - Arena is out of memory.\n");
+            return NULL;
+        }
+    }
+
+    void *ptr = a->current->data + a->current->used;
+    a->current->used += sz;
+
+    a->in_use += sz;
+    if (a->in_use > a->peak) a->peak = a->in_use;
+
+    return ptr;
+}
+
+void *arena_realloc(Arena *a, void *ptr, size_t old_sz, size_t new_sz) {
+    if (a == NULL) return realloc(ptr, new_sz);
+    if (ptr == NULL) return arena_alloc(a, new_sz);
+    if (new_sz <= old_sz) return ptr;
+
+    // Extend in place if 'ptr' is the last allocation of the current chunk.
+    ArenaChunk *chunk = a->current;
+    size_t old_al = align_up(old_sz ? old_sz : 1);
+    size_t new_al = align_up(new_sz);
+    if ((unsigned char*) ptr + old_al == chunk->data + chunk->used
+            && chunk->size - chunk->used >= new_al - old_al) {
+        chunk->used += new_al - old_al;
+        a->in_use += new_al - old_al;
+        if (a->in_use > a->peak) a->peak = a->in_use;
+        return ptr;
+    }
+
+    void *new_ptr = arena_alloc(a, new_sz);
+    if (new_ptr != NULL) memcpy(new_ptr, ptr, old_sz);
+    return new_ptr;
+}
+
+void arena_free(Arena *a, void *ptr) {
+    if (a == NULL) free(ptr);
+}
+
+void arena_reset(Arena *a) {
+    a->current = a->first;
+    if (a->current) a->current->used = 0;
+    a->in_use = 0;
+}
+
+ArenaMark arena_mark(const Arena *a) {
+    ArenaMark mark;
+    mark.chunk = a->current;
+    mark.used = a->current ? a->current->used : 0;
+    mark.in_use = a->in_use;
+    return mark;
+}
+
+void arena_rewind(Arena *a, ArenaMark mark) {
+    if (mark.chunk == NULL) {
+        arena_reset(a);
+        return;
+    }
+    a->current = mark.chunk;
+    a->current->used = mark.used;
+    a->in_use = mark.in_use;
+}
+
+size_t arena_peak(const Arena *a) {
+    return a->peak;
+}
@@ -0,0 +1,74 @@
+#include "../include/async_solve.h"
+#include "../include/backend.h"
+
+#include <stdio.h>
+
+int async_solve_run(Tableau *tab, size_t **basis, int algorithm) {
+    const SolverParams *params = tableau_params(tab);
+    int status = INFEASIBLE;
+
+    if (params->backend != BACKEND_CLASSIC) {
+        BackendResult res;
+        status = backend_solve(tab, basis, params->backend, algorithm, &res);
+    } else if (algorithm == ALGO_SIMPLEX) {
+        status = two_phase_simplex(tab, *basis);
+    } else if (algorithm == ALGO_DUAL_SIMPLEX) {
+        if (search_starting_basis(tab, *basis))
+            fprintf(stderr, "Error - No full basis found.\n");
+        else
+            status = dual_simplex(tab, *basis);
+    } else {
+        status = cutting_plane(tab, basis);
+    }
+
+    return status;
+}
+
+static void *solve_main(void *arg) {
+    AsyncSolve *solve = arg;
+    solve->status = async_solve_run(solve->tab, solve->basis, solve->algorithm);
+    atomic_store(&solve->done, 1);
+
+    return NULL;
+}
+
+int async_solve_start(AsyncSolve *solve, Tableau *tab, size_t **basis, int algorithm) {
+    solve->tab = tab;
+    solve->basis = basis;
+    solve->algorithm = algorithm;
+    solve->user = tab->params;
+    solve->params = *tableau_params(tab);
+    solve->params.cancel = &solve->cancel;
+    solve->params.progress = &solve->progress;
+    solve->status = INFEASIBLE;
+    atomic_init(&solve->cancel, 0);
+    atomic_init(&solve->done, 0);
+    atomic_init(&solve->progress.pivots, 0);
+    atomic_init(&solve->progress.rounds, 0);
+    atomic_init(&solve->progress.objective, 0);
+    atomic_init(&solve->progress.seconds, 0);
+
+    tab->params = &solve->params;
+    if (pthread_create(&solve->thread, NULL, solve_main, solve)) {
+        fprintf(stderr, "Error - Cannot start the solve.\n");
+        tab->params = solve->user;
+        return 1;
+    }
+
+    return 0;
+}
+
+int async_solve_done(AsyncSolve *solve) {
+    return atomic_load(&solve->done);
+}
+
+void async_solve_cancel(AsyncSolve *solve) {
+    atomic_store(&solve->cancel, 1);
+}
+
+int async_solve_wait(AsyncSolve *solve) {
+    pthread_join(solve->thread, NULL);
+    solve->tab->params = solve->user;
+
+    return solve->status;
+}
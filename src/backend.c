@@ -0,0 +1,350 @@
+#include "../include/backend.h"
+#include "../include/separators.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+
+#ifdef SIMPLEX_HAVE_GMP
+#include <gmp.h>
+#endif
+
+static const char *backend_names[] = {"classic", "q32", "q64", "mpq", "f64", "auto"};
+
+const char *backend_name(int backend) {
+    if (backend < BACKEND_CLASSIC || backend > BACKEND_AUTO) return "unknown";
+    return backend_names[backend];
+}
+
+int backend_available(int backend) {
+#ifndef SIMPLEX_HAVE_GMP
+    if (backend == BACKEND_MPQ) return 0;
+#endif
+    return backend >= BACKEND_CLASSIC && backend <= BACKEND_AUTO;
+}
+
+const char *backend_unsupported(const SolverParams *params) {
+    if (params->backend == BACKEND_CLASSIC) return NULL;
+    if (params->degeneracy != DEGEN_NONE) return "--degeneracy";
+    if (params->cut_families != CUT_FAMILY_BIT(CUT_GOMORY)) return "--separators";
+    if (params->cuts_per_round != 1) return "--cuts";
+    if (params->heuristics) return "--heuristics";
+    if (params->gap_limit > 0) return "--gap";
+    if (params->checkpoint_path) return "--checkpoint";
+    return NULL;
+}
+
+
+// -------------------------------------------------------------------------
+// q32: Fraction, 64 bits intermediates.
+
+// d = num/den simplified. Sets *of if it does not fit.
+static inline void q32_set(Fraction *d, long long num, long long den, int *of) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    if (num == 0) {
+        d->num = 0;
+        d->den = 1;
+        return;
+    }
+    if (den != 1) {
+        long long g = fraction_gcd64(num, den);
+        num /= g;
+        den /= g;
+    }
+    if (num > INT_MAX || num < -INT_MAX || den > INT_MAX) {
+        *of = 1;
+        return;
+    }
+    d->num = (int) num;
+    d->den = (int) den;
+}
+
+static inline void q32_add(Fraction *d, Fraction a, Fraction b, int *of) {
+    if (a.den == b.den && a.den == 1) {
+        q32_set(d, (long long) a.num + b.num, 1, of);
+        return;
+    }
+    q32_set(d, (long long) a.num * b.den + (long long) b.num * a.den,
+            (long long) a.den * b.den, of);
+}
+
+static inline void q32_mul(Fraction *d, Fraction a, Fraction b, int *of) {
+    q32_set(d, (long long) a.num * b.num, (long long) a.den * b.den, of);
+}
+
+static inline void q32_div(Fraction *d, Fraction a, Fraction b, int *of) {
+    q32_set(d, (long long) a.num * b.den, (long long) a.den * b.num, of);
+}
+
+static inline int q32_cmp(Fraction a, Fraction b) {
+    long long l = (long long) a.num * b.den, r = (long long) b.num * a.den;
+    return (l > r) - (l < r);
+}
+
+static inline Fraction q32_floor(Fraction a) {
+    long long q = a.num / a.den;
+    if (a.num % a.den && a.num < 0) q--;
+    return (Fraction) {(int) q, 1};
+}
+
+static inline int q32_to_fraction(Fraction *f, Fraction a) {
+    *f = a;
+    return 1;
+}
+
+#define SUFFIX q32
+#define NUM Fraction
+#define N_INIT(x) ((x) = (Fraction) {0, 1})
+#define N_CLEAR(x) ((void) 0)
+#define N_SET(d, a) ((d) = (a))
+#define N_SWAP(a, b) do { Fraction sw_ = (a); (a) = (b); (b) = sw_; } while (0)
+#define N_SET_FRACTION(d, f) ((d) = (f))
+#define N_TO_FRACTION(f, a) q32_to_fraction(&(f), (a))
+#define N_ADD(d, a, b) q32_add(&(d), (a), (b), &t->overflow)
+#define N_SUB(d, a, b) q32_add(&(d), (a), (Fraction) {-(b).num, (b).den}, &t->overflow)
+#define N_MUL(d, a, b) q32_mul(&(d), (a), (b), &t->overflow)
+#define N_DIV(d, a, b) q32_div(&(d), (a), (b), &t->overflow)
+#define N_NEG(d, a) ((d) = (Fraction) {-(a).num, (a).den})
+#define N_FLOOR(d, a) ((d) = q32_floor(a))
+#define N_SGN(a) (((a).num > 0) - ((a).num < 0))
+#define N_CMP(a, b) q32_cmp((a), (b))
+#define N_IS_INT(a) ((a).den == 1)
+#define N_GET_D(a) ((double) (a).num / (a).den)
+#define N_PRINT(a) printf("%d/%d", (a).num, (a).den)
+#include "backend_template.inc"
+
+
+// -------------------------------------------------------------------------
+// q64: long long fields, 128 bits intermediates.
+
+typedef struct {
+    long long num;
+    long long den;
+} Fraction64;
+
+typedef __int128 int128;
+typedef unsigned __int128 uint128;
+
+static inline int ctz128(uint128 x) {
+    unsigned long long lo = (unsigned long long) x;
+    return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((unsigned long long) (x >> 64));
+}
+
+// Binary GCD on 128 bits (u, v != 0).
+static inline uint128 gcd128(uint128 u, uint128 v) {
+    int shift = ctz128(u | v);
+    u >>= ctz128(u);
+    do {
+        v >>= ctz128(v);
+        if (u > v) {
+            uint128 tmp = v;
+            v = u;
+            u = tmp;
+        }
+        v -= u;
+    } while (v != 0);
+    return u << shift;
+}
+
+static inline void q64_set(Fraction64 *d, int128 num, int128 den, int *of) {
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    if (num == 0) {
+        d->num = 0;
+        d->den = 1;
+        return;
+    }
+    if (den != 1) {
+        int128 g = (int128) gcd128(num < 0 ? -(uint128) num : (uint128) num, (uint128) den);
+        num /= g;
+        den /= g;
+    }
+    if (num > LLONG_MAX || num < -LLONG_MAX || den > LLONG_MAX) {
+        *of = 1;
+        return;
+    }
+    d->num = (long long) num;
+    d->den = (long long) den;
+}
+
+static inline void q64_add(Fraction64 *d, Fraction64 a, Fraction64 b, int *of) {
+    q64_set(d, (int128) a.num * b.den + (int128) b.num * a.den,
+            (int128) a.den * b.den, of);
+}
+
+static inline void q64_mul(Fraction64 *d, Fraction64 a, Fraction64 b, int *of) {
+    q64_set(d, (int128) a.num * b.num, (int128) a.den * b.den, of);
+}
+
+static inline void q64_div(Fraction64 *d, Fraction64 a, Fraction64 b, int *of) {
+    q64_set(d, (int128) a.num * b.den, (int128) a.den * b.num, of);
+}
+
+static inline int q64_cmp(Fraction64 a, Fraction64 b) {
+    int128 l = (int128) a.num * b.den, r = (int128) b.num * a.den;
+    return (l > r) - (l < r);
+}
+
+static inline Fraction64 q64_floor(Fraction64 a) {
+    long long q = a.num / a.den;
+    if (a.num % a.den && a.num < 0) q--;
+    return (Fraction64) {q, 1};
+}
+
+static inline int q64_to_fraction(Fraction *f, Fraction64 a) {
+    if (a.num > INT_MAX || a.num < -INT_MAX || a.den > INT_MAX) return 0;
+    f->num = (int) a.num;
+    f->den = (int) a.den;
+    return 1;
+}
+
+#define SUFFIX q64
+#define NUM Fraction64
+#define N_INIT(x) ((x) = (Fraction64) {0, 1})
+#define N_CLEAR(x) ((void) 0)
+#define N_SET(d, a) ((d) = (a))
+#define N_SWAP(a, b) do { Fraction64 sw_ = (a); (a) = (b); (b) = sw_; } while (0)
+#define N_SET_FRACTION(d, f) ((d) = (Fraction64) {(f).num, (f).den})
+#define N_TO_FRACTION(f, a) q64_to_fraction(&(f), (a))
+#define N_ADD(d, a, b) q64_add(&(d), (a), (b), &t->overflow)
+#define N_SUB(d, a, b) q64_add(&(d), (a), (Fraction64) {-(b).num, (b).den}, &t->overflow)
+#define N_MUL(d, a, b) q64_mul(&(d), (a), (b), &t->overflow)
+#define N_DIV(d, a, b) q64_div(&(d), (a), (b), &t->overflow)
+#define N_NEG(d, a) ((d) = (Fraction64) {-(a).num, (a).den})
+#define N_FLOOR(d, a) ((d) = q64_floor(a))
+#define N_SGN(a) (((a).num > 0) - ((a).num < 0))
+#define N_CMP(a, b) q64_cmp((a), (b))
+#define N_IS_INT(a) ((a).den == 1)
+#define N_GET_D(a) ((double) (a).num / (a).den)
+#define N_PRINT(a) printf("%lld/%lld", (a).num, (a).den)
+#include "backend_template.inc"
+
+
+// -------------------------------------------------------------------------
+// mpq: GMP rationals, never overflow.
+
+#ifdef SIMPLEX_HAVE_GMP
+static inline int mpq_backend_to_fraction(Fraction *f, const mpq_t a) {
+    if (!mpz_fits_sint_p(mpq_numref(a)) || !mpz_fits_sint_p(mpq_denref(a))) return 0;
+    f->num = (int) mpz_get_si(mpq_numref(a));
+    f->den = (int) mpz_get_si(mpq_denref(a));
+    return 1;
+}
+
+static inline void mpq_backend_floor(mpq_t d, const mpq_t a) {
+    mpz_fdiv_q(mpq_numref(d), mpq_numref(a), mpq_denref(a));
+    mpz_set_ui(mpq_denref(d), 1);
+}
+
+#define SUFFIX mpq
+#define NUM mpq_t
+#define N_INIT(x) mpq_init(x)
+#define N_CLEAR(x) mpq_clear(x)
+#define N_SET(d, a) mpq_set((d), (a))
+#define N_SWAP(a, b) mpq_swap((a), (b))
+#define N_SET_FRACTION(d, f) mpq_set_si((d), (f).num, (unsigned long) (f).den)
+#define N_TO_FRACTION(f, a) mpq_backend_to_fraction(&(f), (a))
+#define N_ADD(d, a, b) mpq_add((d), (a), (b))
+#define N_SUB(d, a, b) mpq_sub((d), (a), (b))
+#define N_MUL(d, a, b) mpq_mul((d), (a), (b))
+#define N_DIV(d, a, b) mpq_div((d), (a), (b))
+#define N_NEG(d, a) mpq_neg((d), (a))
+#define N_FLOOR(d, a) mpq_backend_floor((d), (a))
+#define N_SGN(a) mpq_sgn(a)
+#define N_CMP(a, b) mpq_cmp((a), (b))
+#define N_IS_INT(a) (mpz_cmp_ui(mpq_denref(a), 1) == 0)
+#define N_GET_D(a) mpq_get_d(a)
+#define N_PRINT(a) gmp_printf("%Qd", (a))
+#include "backend_template.inc"
+#endif
+
+
+// -------------------------------------------------------------------------
+// f64: doubles, values within F64_EPS of 0 (or of an integer) are snapped.
+
+#define F64_EPS 1e-9
+
+static inline int f64_sgn(double a) {
+    return (a > F64_EPS) - (a < -F64_EPS);
+}
+
+// Doubles are never written back: the tableau would not be exact.
+static inline int f64_to_fraction(Fraction *f, double a) {
+    (void) f;
+    (void) a;
+    return 0;
+}
+
+#define SUFFIX f64
+#define NUM double
+#define N_INIT(x) ((x) = 0.0)
+#define N_CLEAR(x) ((void) 0)
+#define N_SET(d, a) ((d) = (a))
+#define N_SWAP(a, b) do { double sw_ = (a); (a) = (b); (b) = sw_; } while (0)
+#define N_SET_FRACTION(d, f) ((d) = (double) (f).num / (f).den)
+#define N_TO_FRACTION(f, a) f64_to_fraction(&(f), (a))
+#define N_ADD(d, a, b) ((d) = (a) + (b))
+#define N_SUB(d, a, b) ((d) = (a) - (b))
+#define N_MUL(d, a, b) ((d) = (a) * (b))
+#define N_DIV(d, a, b) ((d) = (a) / (b))
+#define N_NEG(d, a) ((d) = -(a))
+#define N_FLOOR(d, a) ((d) = floor((a) + F64_EPS))
+#define N_SGN(a) f64_sgn(a)
+#define N_CMP(a, b) f64_sgn((a) - (b))
+#define N_IS_INT(a) (fabs((a) - round(a)) < F64_EPS)
+#define N_GET_D(a) (a)
+#define N_PRINT(a) printf("%.10g", (a) + 0.0)
+#include "backend_template.inc"
+
+
+int backend_solve(Tableau *tab, size_t **basis, int backend, int algorithm,
+        BackendResult *res) {
+    res->iterations = 0;
+    res->n = tab->n;
+    res->m = tab->m;
+    res->cost = 0;
+    res->exact = 0;
+
+    if (!backend_available(backend) || backend == BACKEND_CLASSIC) {
+        fprintf(stderr, "Error - Backend '%s' is not available.\n", backend_name(backend));
+        return INFEASIBLE;
+    }
+    const char *option = backend_unsupported(tableau_params(tab));
+    if (option) {
+        fprintf(stderr, "Error - %s needs --backend=classic.\n", option);
+        return INFEASIBLE;
+    }
+
+    // Narrowest type first, wider ones only on overflow. The limits of the
+    // solve span all the attempts.
+    if (backend == BACKEND_AUTO) {
+        int status = NUMERIC_OVERFLOW;
+        solve_begin(tableau_params(tab));
+        for (int b = BACKEND_Q32; b <= BACKEND_MPQ && status == NUMERIC_OVERFLOW; b++) {
+            if (!backend_available(b)) continue;
+            status = backend_solve(tab, basis, b, algorithm, res);
+        }
+        solve_end();
+        return status;
+    }
+
+    int status;
+    solve_begin(tableau_params(tab));
+    res->backend = backend;
+    switch (backend) {
+    case BACKEND_Q32: status = bt_solve_q32(tab, basis, algorithm, res); break;
+    case BACKEND_Q64: status = bt_solve_q64(tab, basis, algorithm, res); break;
+#ifdef SIMPLEX_HAVE_GMP
+    case BACKEND_MPQ: status = bt_solve_mpq(tab, basis, algorithm, res); break;
+#endif
+    default: status = bt_solve_f64(tab, basis, algorithm, res); break;
+    }
+    solve_end();
+
+    return status;
+}
@@ -0,0 +1,927 @@
+#include "../include/branch_bound.h"
+#include "../include/wire.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Milliseconds between two checks of the limits while waiting for workers.
+#define POLL_INTERVAL 200
+
+// Workers lost while a node was in flight before the coordinator solves it
+// itself: a node must not go round forever between failing workers.
+#define MAX_NODE_FAILURES 3
+
+// Seconds a connection may take to complete a message (its HELLO included)
+// or to accept one, before it is dropped.
+#define STALL_TIMEOUT 30
+
+// A connected worker. Its messages are read without blocking, so a peer that
+// stops in the middle of one does not stop the search.
+typedef struct {
+    int fd;
+    size_t slots;        // Nodes it wants in flight, 0 until its HELLO.
+    size_t busy;         // Nodes in flight.
+    BBNode **inflight;   // 'slots' entries, NULL if free.
+    size_t nodes;        // Nodes solved.
+    WireBuffer in;       // Bytes received and not decoded yet.
+    double since;        // When 'in' started to hold an incomplete message
+                         // (0 if it does not).
+} Worker;
+
+typedef struct {
+    const Tableau *tab;
+    const SolverParams *params;
+    BBNode **open;       // Binary heap of the open nodes, best bound first.
+    size_t n_open, open_cap;
+    uint64_t next_id;
+    char has_incumbent;
+    Fraction incumbent;
+    Fraction *x;         // Incumbent solution, n+1 entries.
+    int status;          // Why the search stopped early (OPTIMAL if it did not).
+    BranchBoundStats *stats;
+    Worker *workers;
+    size_t n_workers, workers_cap;
+    Arena arena;         // Node solves and decoded results.
+} Search;
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Allocate a node with room for its bounds and basis (one malloc'd block).
+static BBNode *node_create(size_t n_bounds, size_t n_basis) {
+    BBNode *node = malloc(sizeof(BBNode) + n_bounds * sizeof(BoundChange)
+            + n_basis * sizeof(size_t));
+    if (node == NULL) return NULL;
+    node->basis = (size_t*) (node + 1);
+    node->bounds = (BoundChange*) (node->basis + n_basis);
+    node->n_bounds = n_bounds;
+    node->n_basis = n_basis;
+    node->id = 0;
+    node->failures = 0;
+    node->bound = fraction_create(0, 1);
+    return node;
+}
+
+// Node 'a' is explored before 'b': lower bound, then deeper, then older.
+static int node_before(const BBNode *a, const BBNode *b) {
+    if (fraction_less(a->bound, b->bound)) return 1;
+    if (fraction_less(b->bound, a->bound)) return 0;
+    if (a->n_bounds != b->n_bounds) return a->n_bounds > b->n_bounds;
+    return a->id < b->id;
+}
+
+static int push_node(Search *s, BBNode *node) {
+    if (s->n_open == s->open_cap) {
+        size_t cap = s->open_cap ? 2 * s->open_cap : 64;
+        BBNode **open = realloc(s->open, cap * sizeof(BBNode*));
+        if (open == NULL) return 1;
+        s->open = open;
+        s->open_cap = cap;
+    }
+
+    size_t i = s->n_open++;
+    while (i > 0 && node_before(node, s->open[(i - 1) / 2])) {
+        s->open[i] = s->open[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    s->open[i] = node;
+    if (s->n_open > s->stats->max_open) s->stats->max_open = s->n_open;
+    return 0;
+}
+
+static BBNode *pop_node(Search *s) {
+    if (s->n_open == 0) return NULL;
+    BBNode *top = s->open[0];
+    BBNode *last = s->open[--s->n_open];
+
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= s->n_open) break;
+        if (c + 1 < s->n_open && node_before(s->open[c + 1], s->open[c])) c++;
+        if (!node_before(s->open[c], last)) break;
+        s->open[i] = s->open[c];
+        i = c;
+    }
+    if (s->n_open) s->open[i] = last;
+    return top;
+}
+
+// Next open node that the incumbent does not dominate.
+static BBNode *next_node(Search *s) {
+    BBNode *node;
+    while ((node = pop_node(s)) != NULL) {
+        if (!s->has_incumbent || fraction_less(node->bound, s->incumbent)) return node;
+        s->stats->pruned++;
+        free(node);
+    }
+    return NULL;
+}
+
+// Bring the tableau in the canonical form of 'basis'. Rows are swapped so that
+// basis[i-1] is the variable of row i. Returns 1 if the basis is singular.
+static int canonicalize(Tableau *tab, const size_t *basis) {
+    size_t cols = tableau_stride(tab);
+    for (size_t r = 1; r <= tab->m; r++) {
+        size_t var = basis[r - 1];
+        if (var == 0 || var > tab->n) return 1;
+
+        size_t t = r;
+        while (t <= tab->m && tab->data[t * cols + var].num == 0) t++;
+        if (t > tab->m) return 1;
+
+        if (t != r) {
+            for (size_t j = 0; j <= tab->n; j++) {
+                Fraction tmp = tab->data[t * cols + j];
+                tab->data[t * cols + j] = tab->data[r * cols + j];
+                tab->data[r * cols + j] = tmp;
+            }
+        }
+        pivot_operations(tab, var, r, 0, 0);
+    }
+    return 0;
+}
+
+// The problem with one row and one slack per bound change of the node.
+static void fill_node_tableau(Tableau *tab, const Tableau *problem, const BBNode *node) {
+    size_t cols = tableau_stride(tab);
+    size_t src_cols = tableau_stride(problem);
+    for (size_t i = 0; i <= tab->m; i++) {
+        for (size_t j = 0; j <= tab->n; j++) {
+            tab->data[i * cols + j] = i <= problem->m && j <= problem->n
+                ? problem->data[i * src_cols + j] : fraction_create(0, 1);
+        }
+    }
+
+    // x_var + s = value or -x_var + s = -value.
+    for (size_t b = 0; b < node->n_bounds; b++) {
+        const BoundChange *bc = &node->bounds[b];
+        Fraction *row = &tab->data[(problem->m + 1 + b) * cols];
+        int sign = bc->upper ? 1 : -1;
+        row[0] = fraction_create(sign * bc->value, 1);
+        row[bc->var] = fraction_create(sign, 1);
+        row[problem->n + 1 + b] = fraction_create(1, 1);
+    }
+}
+
+int bb_solve_node(const Tableau *problem, const BBNode *node,
+        const Fraction *cutoff, Arena *arena, BBResult *res) {
+    size_t n0 = problem->n;
+    Tableau tab;
+    tab.n = n0 + node->n_bounds;
+    tab.m = problem->m + node->n_bounds;
+    tab.arena = arena;
+    tab.stride = 0;
+    tab.row_cap = 0;
+    tab.params = problem->params;
+    tab.data = arena_alloc(arena, (tab.m + 1) * (tab.n + 1) * sizeof(Fraction));
+    size_t *basis = arena_alloc(arena, tab.m * sizeof(size_t));
+
+    memset(res, 0, sizeof(*res));
+    res->status = INFEASIBLE;
+    res->cost = fraction_create(0, 1);
+    if (tab.data == NULL || basis == NULL) {
+        fprintf(stderr, "Error - Not enough memory to solve a node.\n");
+        return res->status;
+    }
+
+    const SolverParams *params = tableau_params(&tab);
+    solve_begin(params);
+    long pivots = solve_pivots();
+    fill_node_tableau(&tab, problem, node);
+
+    // Warm start: the basis of the parent plus the slack of the new bound,
+    // which is dual feasible.
+    char warm = node->n_basis > 0 && node->n_basis + 1 == tab.m;
+    if (warm) {
+        memcpy(basis, node->basis, node->n_basis * sizeof(size_t));
+        basis[tab.m - 1] = tab.n;
+        if (canonicalize(&tab, basis)) {
+            solver_log(params, "Singular warm start basis, solving from scratch.\n");
+            fill_node_tableau(&tab, problem, node);
+            warm = 0;
+        }
+    }
+
+    if (warm) {
+        // The dual simplex is unbounded when the node is infeasible.
+        res->status = dual_simplex(&tab, basis);
+        if (res->status == UNBOUNDED) res->status = INFEASIBLE;
+    } else {
+        res->status = two_phase_simplex(&tab, basis);
+    }
+    res->pivots = (uint64_t) (solve_pivots() - pivots);
+    solve_end();
+    if (res->status != OPTIMAL) return res->status;
+
+    // The classic fractions wrap around silently: a vertex with a bad
+    // denominator cannot be trusted (nor branched on).
+    size_t cols = tableau_stride(&tab);
+    for (size_t i = 0; i <= tab.m; i++) {
+        if (tab.data[i * cols].den <= 0) {
+            solver_log(params, "Numeric overflow in a node.\n");
+            res->status = NUMERIC_OVERFLOW;
+            return res->status;
+        }
+    }
+
+    res->cost = fraction_chg_sign(tab.data[0]);
+    if (cutoff && fraction_greater_equal(res->cost, *cutoff)) {
+        res->pruned = 1;
+        return res->status;
+    }
+
+    Fraction *x = arena_alloc(arena, (n0 + 1) * sizeof(Fraction));
+    if (x == NULL) {
+        res->status = INFEASIBLE;
+        return res->status;
+    }
+    tableau_vertex(&tab, basis, n0, x);
+
+    // Most fractional variable (fractional part closest to 1/2).
+    double best = 1;
+    for (size_t j = 1; j <= n0; j++) {
+        if (x[j].den == 1) continue;
+        Fraction fl = fraction_floor(x[j]);
+        double frac = fraction_to_double(x[j]) - fl.num;
+        double dist = frac > 0.5 ? frac - 0.5 : 0.5 - frac;
+        if (dist < best) {
+            best = dist;
+            res->branch_var = j;
+            res->branch_floor = fl.num;
+        }
+    }
+
+    res->integral = res->branch_var == 0;
+    if (res->integral) res->x = x;
+    res->n_basis = tab.m;
+    res->basis = basis;
+    return res->status;
+}
+
+// Children of 'node' on res->branch_var, both warm started from its basis.
+static int branch(Search *s, const BBNode *node, const BBResult *res) {
+    for (int upper = 1; upper >= 0; upper--) {
+        BBNode *child = node_create(node->n_bounds + 1, res->n_basis);
+        if (child == NULL) return 1;
+        child->id = s->next_id++;
+        child->bound = res->cost;
+        memcpy(child->bounds, node->bounds, node->n_bounds * sizeof(BoundChange));
+        BoundChange *bc = &child->bounds[node->n_bounds];
+        bc->var = (uint32_t) res->branch_var;
+        bc->upper = (char) upper;
+        bc->value = upper ? res->branch_floor : res->branch_floor + 1;
+        memcpy(child->basis, res->basis, res->n_basis * sizeof(size_t));
+        if (push_node(s, child)) {
+            free(child);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Account the result of a node. Returns 1 if the incumbent improved.
+static int handle_result(Search *s, const BBNode *node, const BBResult *res) {
+    s->stats->nodes++;
+
+    if (res->status == INFEASIBLE) {
+        s->stats->pruned++;
+        return 0;
+    }
+    if (res->status != OPTIMAL) {
+        // Unbounded LP relaxation, or a limit of the node solve.
+        s->status = res->status;
+        return 0;
+    }
+    if (res->pruned || (s->has_incumbent && fraction_greater_equal(res->cost, s->incumbent))) {
+        s->stats->pruned++;
+        return 0;
+    }
+
+    if (res->integral) {
+        s->has_incumbent = 1;
+        s->incumbent = res->cost;
+        memcpy(s->x, res->x, (s->tab->n + 1) * sizeof(Fraction));
+        s->stats->incumbents++;
+        if (s->params->verbose) {
+            printf("New incumbent at node %lu: cost = ", (unsigned long) node->id);
+            fraction_print(res->cost);
+            printf("\n");
+        }
+        return 1;
+    }
+
+    if (branch(s, node, res)) {
+        fprintf(stderr, "Error - Not enough memory to branch.\n");
+        s->status = INFEASIBLE;
+    }
+    return 0;
+}
+
+// Solve a node in this process.
+static void solve_here(Search *s, BBNode *node) {
+    BBResult res;
+    bb_solve_node(s->tab, node, s->has_incumbent ? &s->incumbent : NULL, &s->arena, &res);
+    handle_result(s, node, &res);
+    arena_reset(&s->arena);
+    free(node);
+}
+
+static void encode_node(WireBuffer *buf, const BBNode *node, const Search *s) {
+    wire_put_u64(buf, node->id);
+    wire_put_u32(buf, (uint32_t) s->has_incumbent);
+    wire_put_fraction(buf, s->incumbent);
+    wire_put_fraction(buf, node->bound);
+
+    // Pivots left to the search (0 = no limit).
+    long left = 0;
+    if (s->params->max_iterations > 0) {
+        left = s->params->max_iterations - solve_pivots();
+        if (left < 1) left = 1;
+    }
+    wire_put_u32(buf, (uint32_t) left);
+    wire_put_u32(buf, (uint32_t) node->n_bounds);
+    for (size_t b = 0; b < node->n_bounds; b++) {
+        wire_put_u32(buf, node->bounds[b].var);
+        wire_put_u32(buf, (uint32_t) node->bounds[b].value);
+        wire_put_u32(buf, (uint32_t) node->bounds[b].upper);
+    }
+    wire_put_u32(buf, (uint32_t) node->n_basis);
+    for (size_t i = 0; i < node->n_basis; i++)
+        wire_put_u32(buf, (uint32_t) node->basis[i]);
+}
+
+// Returns NULL on a malformed message. The cutoff is written in 'cutoff'
+// when the message carries one, the pivots left in 'max_iterations'.
+static BBNode *decode_node(WireBuffer *buf, const Tableau *problem,
+        char *has_cutoff, Fraction *cutoff, int *max_iterations) {
+    uint64_t id = wire_get_u64(buf);
+    char has = (char) wire_get_u32(buf);
+    Fraction inc = wire_get_fraction(buf);
+    Fraction bound = wire_get_fraction(buf);
+    uint32_t left = wire_get_u32(buf);
+    size_t n_bounds = wire_get_u32(buf);
+    if (buf->error || n_bounds > (buf->len - buf->pos) / 12) return NULL;
+
+    size_t save = buf->pos;
+    buf->pos += 12 * n_bounds;
+    size_t n_basis = wire_get_u32(buf);
+    if (buf->error || (n_basis && (n_bounds == 0 || n_basis != problem->m + n_bounds - 1)))
+        return NULL;
+    buf->pos = save;
+
+    BBNode *node = node_create(n_bounds, n_basis);
+    if (node == NULL) return NULL;
+    node->id = id;
+    node->bound = bound;
+    for (size_t b = 0; b < n_bounds; b++) {
+        node->bounds[b].var = wire_get_u32(buf);
+        node->bounds[b].value = (int32_t) wire_get_u32(buf);
+        node->bounds[b].upper = (char) wire_get_u32(buf);
+        if (node->bounds[b].var == 0 || node->bounds[b].var > problem->n) buf->error = 1;
+    }
+    wire_get_u32(buf);
+    for (size_t i = 0; i < n_basis; i++) node->basis[i] = wire_get_u32(buf);
+    if (buf->error) {
+        free(node);
+        return NULL;
+    }
+
+    if (has && (!*has_cutoff || fraction_less(inc, *cutoff))) {
+        *has_cutoff = 1;
+        *cutoff = inc;
+    }
+    *max_iterations = left > INT_MAX ? INT_MAX : (int) left;
+    return node;
+}
+
+static void encode_result(WireBuffer *buf, uint64_t id, const BBResult *res, size_t n) {
+    wire_put_u64(buf, id);
+    wire_put_u32(buf, (uint32_t) res->status);
+    wire_put_u64(buf, res->pivots);
+    wire_put_u32(buf, (uint32_t) res->pruned);
+    wire_put_u32(buf, (uint32_t) res->integral);
+    wire_put_fraction(buf, res->cost);
+    wire_put_u32(buf, (uint32_t) res->branch_var);
+    wire_put_u32(buf, (uint32_t) res->branch_floor);
+    wire_put_u32(buf, (uint32_t) res->n_basis);
+    for (size_t i = 0; i < res->n_basis; i++)
+        wire_put_u32(buf, (uint32_t) res->basis[i]);
+    if (res->integral)
+        for (size_t j = 1; j <= n; j++) wire_put_fraction(buf, res->x[j]);
+}
+
+// The arrays of 'res' come from 'arena'. Returns 1 on a malformed message.
+static int decode_result(WireBuffer *buf, uint64_t *id, BBResult *res,
+        const BBNode *node, const Tableau *problem, Arena *arena) {
+    memset(res, 0, sizeof(*res));
+    *id = wire_get_u64(buf);
+    res->status = (int) wire_get_u32(buf);
+    res->pivots = wire_get_u64(buf);
+    res->pruned = (char) wire_get_u32(buf);
+    res->integral = (char) wire_get_u32(buf);
+    res->cost = wire_get_fraction(buf);
+    res->branch_var = wire_get_u32(buf);
+    res->branch_floor = (int32_t) wire_get_u32(buf);
+    res->n_basis = wire_get_u32(buf);
+    if (buf->error || res->status < INFEASIBLE || res->status > TIME_LIMIT) return 1;
+
+    char branching = res->status == OPTIMAL && !res->pruned && !res->integral;
+    if (branching && (res->branch_var == 0 || res->branch_var > problem->n
+                || res->n_basis != problem->m + node->n_bounds))
+        return 1;
+    if (res->n_basis > (buf->len - buf->pos) / 4) return 1;
+
+    res->basis = arena_alloc(arena, (res->n_basis + 1) * sizeof(size_t));
+    if (res->basis == NULL) return 1;
+    for (size_t i = 0; i < res->n_basis; i++) res->basis[i] = wire_get_u32(buf);
+
+    if (res->integral) {
+        res->x = arena_alloc(arena, (problem->n + 1) * sizeof(Fraction));
+        if (res->x == NULL) return 1;
+        res->x[0] = fraction_create(0, 1);
+        for (size_t j = 1; j <= problem->n; j++) res->x[j] = wire_get_fraction(buf);
+    }
+    return buf->error;
+}
+
+// A new connection: a worker once its HELLO arrives.
+static int add_connection(Search *s, int fd) {
+    if (s->n_workers == s->workers_cap) {
+        size_t cap = s->workers_cap ? 2 * s->workers_cap : 8;
+        Worker *workers = realloc(s->workers, cap * sizeof(Worker));
+        if (workers == NULL) {
+            close(fd);
+            return 1;
+        }
+        s->workers = workers;
+        s->workers_cap = cap;
+    }
+
+    // The messages to the worker are sent blocking, but not forever.
+    struct timeval tv = {STALL_TIMEOUT, 0};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    Worker *w = &s->workers[s->n_workers++];
+    w->fd = fd;
+    w->slots = 0;
+    w->busy = 0;
+    w->inflight = NULL;
+    w->nodes = 0;
+    wire_init(&w->in);
+    w->since = monotonic_seconds();
+    return 0;
+}
+
+// Handshake: HELLO (in 'buf') in, PROBLEM out.
+static int hello(Search *s, Worker *w, WireBuffer *buf) {
+    uint32_t version = wire_get_u32(buf);
+    uint32_t slots = wire_get_u32(buf);
+    if (buf->error || version != BB_PROTOCOL_VERSION || slots == 0 || slots > 64) {
+        fprintf(stderr, "Error - Worker with an unsupported protocol.\n");
+        return 1;
+    }
+
+    const Tableau *tab = s->tab;
+    size_t cols = tableau_stride(tab);
+    wire_clear(buf);
+    wire_put_u32(buf, (uint32_t) tab->m);
+    wire_put_u32(buf, (uint32_t) tab->n);
+    wire_put_u32(buf, (uint32_t) s->params->degeneracy);
+    wire_put_u32(buf, (uint32_t) s->params->stall_threshold);
+    wire_put_u32(buf, s->params->seed);
+    for (size_t i = 0; i <= tab->m; i++)
+        for (size_t j = 0; j <= tab->n; j++)
+            wire_put_fraction(buf, tab->data[i * cols + j]);
+    if (buf->error || wire_send(w->fd, BB_PROBLEM, buf)) return 1;
+
+    w->inflight = calloc(slots, sizeof(BBNode*));
+    if (w->inflight == NULL) return 1;
+    w->slots = slots;
+    s->stats->workers++;
+    solver_log(s->params, "Worker %lu joined (%u slots).\n",
+            (unsigned long) s->stats->workers, slots);
+    return 0;
+}
+
+// The worker left: its nodes go back to the queue.
+static void drop_worker(Search *s, size_t k) {
+    Worker *w = &s->workers[k];
+    size_t requeued = 0;
+    for (size_t i = 0; i < w->slots; i++) {
+        BBNode *node = w->inflight[i];
+        if (node == NULL) continue;
+        if (++node->failures >= MAX_NODE_FAILURES) {
+            solver_log(s->params, "Node %lu failed %d times, solving it here.\n",
+                    (unsigned long) node->id, node->failures);
+            solve_here(s, node);
+            continue;
+        }
+        if (push_node(s, node)) free(node);
+        s->stats->requeued++;
+        requeued++;
+    }
+    if (w->slots)
+        solver_log(s->params, "A worker left, %lu nodes requeued.\n", (unsigned long) requeued);
+    close(w->fd);
+    free(w->inflight);
+    wire_free(&w->in);
+    s->workers[k] = s->workers[--s->n_workers];
+}
+
+// Fill the free slots of the workers.
+static void dispatch(Search *s, WireBuffer *buf) {
+    for (size_t k = 0; k < s->n_workers; k++) {
+        Worker *w = &s->workers[k];
+        while (w->busy < w->slots) {
+            BBNode *node = next_node(s);
+            if (node == NULL) return;
+
+            size_t slot = 0;
+            while (w->inflight[slot] != NULL) slot++;
+            w->inflight[slot] = node;
+            w->busy++;
+
+            wire_clear(buf);
+            encode_node(buf, node, s);
+            if (buf->error || wire_send(w->fd, BB_NODE, buf)) {
+                drop_worker(s, k--);
+                break;
+            }
+        }
+    }
+}
+
+static void broadcast_incumbent(Search *s, WireBuffer *buf) {
+    wire_clear(buf);
+    wire_put_fraction(buf, s->incumbent);
+    for (size_t k = 0; k < s->n_workers; k++)
+        if (s->workers[k].slots) wire_send(s->workers[k].fd, BB_INCUMBENT, buf);
+}
+
+// A result of worker w (in 'buf').
+static int take_result(Search *s, Worker *w, WireBuffer *buf) {
+    // Find the node by id (it is in the first 8 bytes).
+    uint64_t id = wire_get_u64(buf);
+    buf->pos = 0;
+    size_t slot = 0;
+    while (slot < w->slots && (w->inflight[slot] == NULL || w->inflight[slot]->id != id))
+        slot++;
+    if (slot == w->slots) return 1;
+
+    BBNode *node = w->inflight[slot];
+    BBResult res;
+    if (decode_result(buf, &id, &res, node, s->tab, &s->arena)) {
+        fprintf(stderr, "Error - Malformed result from a worker.\n");
+        return 1;
+    }
+    w->inflight[slot] = NULL;
+    w->busy--;
+    w->nodes++;
+    solve_add_pivots((long) res.pivots);
+
+    if (handle_result(s, node, &res)) broadcast_incumbent(s, buf);
+    arena_reset(&s->arena);
+    free(node);
+    return 0;
+}
+
+// Read what worker k sent and handle its complete messages. Returns 1 if the
+// worker left.
+static int receive(Search *s, size_t k, WireBuffer *buf) {
+    Worker *w = &s->workers[k];
+    int status = wire_read(w->fd, &w->in);
+    if (status < 0) return 1;
+
+    for (;;) {
+        // The longest message: HELLO, or a result of its nodes (header,
+        // basis and integer solution).
+        size_t max_len = 8;
+        if (w->slots) {
+            size_t n_bounds = 0;
+            for (size_t i = 0; i < w->slots; i++)
+                if (w->inflight[i] && w->inflight[i]->n_bounds > n_bounds)
+                    n_bounds = w->inflight[i]->n_bounds;
+            max_len = 48 + 4 * (s->tab->m + n_bounds) + 8 * s->tab->n;
+        }
+
+        uint32_t type;
+        int got = wire_next(&w->in, &type, buf, max_len);
+        if (got < 0) return 1;
+        if (got == 0) break;
+        if (w->slots == 0) {
+            if (type != BB_HELLO || hello(s, w, buf)) return 1;
+        } else if (type != BB_RESULT || take_result(s, w, buf)) {
+            return 1;
+        }
+        if (s->status != OPTIMAL) return 0;
+    }
+
+    if (w->in.pos == w->in.len) w->since = 0;
+    else if (w->since == 0) w->since = monotonic_seconds();
+    return status;
+}
+
+// Distributed search. Returns 1 if it could not start.
+static int coordinate(Search *s, const BranchBoundConfig *config) {
+    int lfd = wire_listen(config->listen);
+    if (lfd < 0) return 1;
+
+    // Local workers, for a single machine.
+    pid_t *children = calloc(config->spawn > 0 ? config->spawn : 1, sizeof(pid_t));
+    int n_children = 0;
+    if (children == NULL) goto TERMINATE;
+    fflush(NULL);
+    for (int c = 0; c < config->spawn; c++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(lfd);
+            _exit(bb_worker(config->listen) ? 1 : 0);
+        }
+        if (pid < 0) {
+            fprintf(stderr, "Error - Cannot fork a worker: %s.\n", strerror(errno));
+            break;
+        }
+        children[n_children++] = pid;
+    }
+
+    WireBuffer buf;
+    wire_init(&buf);
+    struct pollfd *pfd = NULL;
+    size_t pfd_cap = 0;
+
+    // Wait for the workers, then search until no node is open or in flight.
+    size_t wanted = config->workers > 0 ? (size_t) config->workers : (size_t) n_children;
+    for (;;) {
+        int status;
+        if (solve_stop(s->params, &status)) {
+            s->status = status;
+            break;
+        }
+
+        size_t busy = 0, ready = 0;
+        if (s->stats->workers >= wanted) {
+            dispatch(s, &buf);
+            for (size_t k = 0; k < s->n_workers; k++) {
+                busy += s->workers[k].busy;
+                ready += s->workers[k].slots > 0;
+            }
+            if (busy == 0 && s->n_open == 0) break;
+
+            // Nobody left to solve the open nodes.
+            if (ready == 0) {
+                BBNode *node = next_node(s);
+                if (node) solve_here(s, node);
+                if (s->status != OPTIMAL) break;
+                continue;
+            }
+        }
+
+        if (pfd_cap < s->n_workers + 1) {
+            pfd_cap = 2 * (s->n_workers + 1);
+            struct pollfd *p = realloc(pfd, pfd_cap * sizeof(struct pollfd));
+            if (p == NULL) break;
+            pfd = p;
+        }
+        pfd[0].fd = lfd;
+        pfd[0].events = POLLIN;
+        for (size_t k = 0; k < s->n_workers; k++) {
+            pfd[k + 1].fd = s->workers[k].fd;
+            pfd[k + 1].events = POLLIN;
+        }
+        size_t n_polled = s->n_workers;
+        int ready_fds = poll(pfd, n_polled + 1, POLL_INTERVAL);
+
+        // Results first (backwards: a worker that leaves is swapped with
+        // the last one), then the connections stuck in a message.
+        double now = monotonic_seconds();
+        for (size_t k = n_polled; k-- > 0;) {
+            Worker *w = &s->workers[k];
+            if (ready_fds > 0 && (pfd[k + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                if (receive(s, k, &buf)) {
+                    drop_worker(s, k);
+                    continue;
+                }
+            } else if (w->since > 0 && now - w->since > STALL_TIMEOUT) {
+                fprintf(stderr, "Error - No complete message from a worker in %d seconds.\n",
+                        STALL_TIMEOUT);
+                drop_worker(s, k);
+            }
+            if (s->status != OPTIMAL) break;
+        }
+        if (s->status != OPTIMAL) break;
+
+        if (ready_fds > 0 && (pfd[0].revents & POLLIN)) {
+            int fd = wire_accept(lfd);
+            if (fd >= 0) add_connection(s, fd);
+        }
+    }
+
+    // Stop the workers.
+    for (size_t k = s->n_workers; k-- > 0;) {
+        Worker *w = &s->workers[k];
+        wire_send(w->fd, BB_SHUTDOWN, NULL);
+        if (w->slots)
+            solver_log(s->params, "Worker %lu: %lu nodes.\n", (unsigned long) k + 1,
+                    (unsigned long) w->nodes);
+        for (size_t i = 0; i < w->slots; i++) free(w->inflight[i]);
+        close(w->fd);
+        free(w->inflight);
+        wire_free(&w->in);
+    }
+    s->n_workers = 0;
+    for (int c = 0; c < n_children; c++) waitpid(children[c], NULL, 0);
+
+    free(pfd);
+    wire_free(&buf);
+
+TERMINATE:
+    free(children);
+    wire_close_listener(lfd, config->listen);
+    return children == NULL;
+}
+
+int branch_and_bound(const Tableau *tab, const BranchBoundConfig *config,
+        Fraction *x, BranchBoundStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->cost = fraction_create(0, 1);
+
+    Search s;
+    memset(&s, 0, sizeof(s));
+    s.tab = tab;
+    s.params = tableau_params(tab);
+    s.status = OPTIMAL;
+    s.stats = stats;
+    s.x = x;
+    s.incumbent = fraction_create(0, 1);
+    arena_init(&s.arena, 0);
+    for (size_t j = 0; j <= tab->n; j++) x[j] = fraction_create(0, 1);
+
+    solve_begin(s.params);
+    int status = INFEASIBLE;
+    BBNode *root = node_create(0, 0);
+    if (root == NULL || push_node(&s, root)) {
+        free(root);
+        fprintf(stderr, "Error - Not enough memory to start the search.\n");
+        goto TERMINATE;
+    }
+    s.next_id = 1;
+
+    if (config && config->listen) {
+        if (coordinate(&s, config)) goto TERMINATE;
+    } else {
+        BBNode *node;
+        while (s.status == OPTIMAL && (node = next_node(&s)) != NULL) {
+            if (solve_stop(s.params, &s.status)) {
+                free(node);
+                break;
+            }
+            solve_here(&s, node);
+        }
+    }
+
+    if (s.status != OPTIMAL) status = s.status;
+    else if (s.has_incumbent) status = OPTIMAL;
+    if (s.has_incumbent) stats->cost = s.incumbent;
+
+TERMINATE:
+    solve_end();
+    for (size_t i = 0; i < s.n_open; i++) free(s.open[i]);
+    free(s.open);
+    free(s.workers);
+    arena_destroy(&s.arena);
+    return status;
+}
+
+// Receive the problem of the coordinator. The tableau data is malloc'd.
+static int receive_problem(int fd, WireBuffer *buf, Tableau *tab, SolverParams *params) {
+    uint32_t type;
+    if (wire_recv(fd, &type, buf, WIRE_MAX_PAYLOAD) || type != BB_PROBLEM) return 1;
+
+    solver_params_default(params);
+    params->verbose = 0;
+    params->cut_stats = NULL;
+    tab->m = wire_get_u32(buf);
+    tab->n = wire_get_u32(buf);
+    params->degeneracy = (int) wire_get_u32(buf);
+    params->stall_threshold = (int) wire_get_u32(buf);
+    params->seed = wire_get_u32(buf);
+    size_t entries = (tab->m + 1) * (tab->n + 1);
+    if (buf->error || tab->m == 0 || tab->n == 0 || entries > (buf->len - buf->pos) / 8)
+        return 1;
+
+    tab->arena = NULL;
+    tab->stride = 0;
+    tab->row_cap = 0;
+    tab->params = params;
+    tab->data = malloc(entries * sizeof(Fraction));
+    if (tab->data == NULL) return 1;
+    for (size_t k = 0; k < entries; k++) tab->data[k] = wire_get_fraction(buf);
+    return buf->error;
+}
+
+int bb_worker(const char *addr) {
+    int fd = wire_connect(addr);
+    if (fd < 0) return 1;
+
+    int ret = 1;
+    WireBuffer buf;
+    wire_init(&buf);
+    Arena arena;
+    arena_init(&arena, 0);
+    Tableau tab;
+    tab.data = NULL;
+    SolverParams params;
+
+    // Nodes received and not solved yet, in order.
+    BBNode **queue = calloc(BB_WORKER_SLOTS, sizeof(BBNode*));
+    size_t queued = 0, queue_cap = BB_WORKER_SLOTS;
+    char has_cutoff = 0;
+    Fraction cutoff = fraction_create(0, 1);
+    if (queue == NULL) goto TERMINATE;
+
+    wire_put_u32(&buf, BB_PROTOCOL_VERSION);
+    wire_put_u32(&buf, BB_WORKER_SLOTS);
+    if (wire_send(fd, BB_HELLO, &buf) || receive_problem(fd, &buf, &tab, &params)) {
+        fprintf(stderr, "Error - Handshake with the coordinator failed.\n");
+        goto TERMINATE;
+    }
+
+    for (;;) {
+        // Block only when there is nothing to solve, then drain the socket:
+        // a new incumbent may prune the queued nodes.
+        while (queued == 0 || wire_pending(fd)) {
+            uint32_t type;
+            int status = wire_recv(fd, &type, &buf, WIRE_MAX_PAYLOAD);
+            if (status == 1 || (status == 0 && type == BB_SHUTDOWN)) {
+                ret = 0;
+                goto TERMINATE;
+            }
+            if (status) goto TERMINATE;
+
+            if (type == BB_INCUMBENT) {
+                Fraction inc = wire_get_fraction(&buf);
+                if (!buf.error && (!has_cutoff || fraction_less(inc, cutoff))) {
+                    has_cutoff = 1;
+                    cutoff = inc;
+                }
+            } else if (type == BB_NODE) {
+                BBNode *node = decode_node(&buf, &tab, &has_cutoff, &cutoff,
+                        &params.max_iterations);
+                if (node == NULL) {
+                    fprintf(stderr, "Error - Malformed node from the coordinator.\n");
+                    goto TERMINATE;
+                }
+                if (queued == queue_cap) {
+                    BBNode **q = realloc(queue, 2 * queue_cap * sizeof(BBNode*));
+                    if (q == NULL) {
+                        free(node);
+                        goto TERMINATE;
+                    }
+                    queue = q;
+                    queue_cap *= 2;
+                }
+                queue[queued++] = node;
+            }
+        }
+
+        BBNode *node = queue[0];
+        memmove(queue, queue + 1, --queued * sizeof(BBNode*));
+
+        BBResult res;
+        if (has_cutoff && fraction_greater_equal(node->bound, cutoff)) {
+            memset(&res, 0, sizeof(res));
+            res.status = OPTIMAL;
+            res.pruned = 1;
+            res.cost = node->bound;
+        } else {
+            bb_solve_node(&tab, node, has_cutoff ? &cutoff : NULL, &arena, &res);
+        }
+
+        wire_clear(&buf);
+        encode_result(&buf, node->id, &res, tab.n);
+        free(node);
+        arena_reset(&arena);
+        if (buf.error || wire_send(fd, BB_RESULT, &buf)) goto TERMINATE;
+    }
+
+TERMINATE:
+    for (size_t i = 0; i < queued; i++) free(queue[i]);
+    free(queue);
+    free(tab.data);
+    arena_destroy(&arena);
+    wire_free(&buf);
+    close(fd);
+    return ret;
+}
@@ -0,0 +1,271 @@
+#include "../include/checkpoint.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// Basis entries converted per write.
+#define BASIS_CHUNK 256
+
+static uint64_t fnv1a(uint64_t hash, const void *buf, size_t len) {
+    const unsigned char *p = buf;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= p[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Write 'len' bytes of 'buf' and update the checksum. Returns 0 on success.
+static int write_block(FILE *fp, const void *buf, size_t len, uint64_t *hash) {
+    if (len && fwrite(buf, 1, len, fp) != len) return 1;
+    *hash = fnv1a(*hash, buf, len);
+    return 0;
+}
+
+// Sync the directory containing 'path', so that the rename is durable.
+static void sync_parent_dir(const char *path) {
+    char dir[4096];
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL) {
+        strcpy(dir, ".");
+    } else {
+        size_t len = slash == path ? 1 : (size_t) (slash - path);
+        if (len >= sizeof(dir)) return;
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+    }
+
+    int fd = open(dir, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+int checkpoint_write(const char *path, const Tableau *tab, const size_t *basis,
+        const CutPool *pool, int phase, size_t round) {
+    int status = 0;
+    FILE *fp = NULL;
+
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int) sizeof(tmp_path)) {
+        fprintf(stderr, "Error - Checkpoint path too long.\n");
+        return 1;
+    }
+
+    fp = fopen(tmp_path, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "Error - Cannot create checkpoint '%s'.\n", tmp_path);
+        return 1;
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header.version = CHECKPOINT_VERSION;
+    header.phase = (uint32_t) phase;
+    header.n = tab->n;
+    header.m = tab->m;
+    header.round = round;
+    header.pool_count = pool->count;
+    for (size_t k = 0; k < pool->count; k++)
+        header.pool_values += pool->len[k];
+
+    // The header is written again at the end, with the checksum.
+    uint64_t hash = FNV_OFFSET;
+    if (fwrite(&header, sizeof(header), 1, fp) != 1) {
+        status = 1;
+        goto TERMINATE;
+    }
+
+    // Tableau, without the unused capacity.
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i <= tab->m; i++) {
+        status = write_block(fp, &tab->data[i * cols],
+                (tab->n + 1) * sizeof(Fraction), &hash);
+        if (status) goto TERMINATE;
+    }
+
+    // Basis.
+    uint64_t buf[BASIS_CHUNK];
+    for (size_t i = 0; i < tab->m; i += BASIS_CHUNK) {
+        size_t len = tab->m - i < BASIS_CHUNK ? tab->m - i : BASIS_CHUNK;
+        for (size_t k = 0; k < len; k++)
+            buf[k] = basis[i + k];
+        status = write_block(fp, buf, len * sizeof(uint64_t), &hash);
+        if (status) goto TERMINATE;
+    }
+
+    // Cut pool.
+    for (size_t k = 0; k < pool->count; k++) {
+        uint64_t len = pool->len[k];
+        status = write_block(fp, &len, sizeof(len), &hash);
+        if (status) goto TERMINATE;
+    }
+    for (size_t k = 0; k < pool->count; k++) {
+        status = write_block(fp, pool->unit[k], pool->len[k] * sizeof(double), &hash);
+        if (status) goto TERMINATE;
+    }
+
+    header.checksum = hash;
+    if (fseek(fp, 0, SEEK_SET) || fwrite(&header, sizeof(header), 1, fp) != 1) {
+        status = 1;
+        goto TERMINATE;
+    }
+
+    // Make sure the data reached the disk before replacing the old snapshot.
+    if (fflush(fp) || fsync(fileno(fp))) {
+        status = 1;
+        goto TERMINATE;
+    }
+
+TERMINATE:
+    if (fclose(fp)) status = 1;
+
+    if (!status && rename(tmp_path, path)) status = 1;
+
+    if (status) {
+        fprintf(stderr, "Error - Cannot write checkpoint '%s'.\n", path);
+        remove(tmp_path);
+    } else {
+        sync_parent_dir(path);
+    }
+
+    return status;
+}
+
+int checkpoint_read(const char *path, Arena *arena, Tableau *tab,
+        size_t **basis, CutPool *pool, CheckpointState *state) {
+    int status = 0;
+    unsigned char *map = NULL;
+    size_t size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error - Cannot open checkpoint '%s'.\n", path);
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) || (size_t) st.st_size < sizeof(CheckpointHeader)) {
+        fprintf(stderr, "Error - Checkpoint '%s' is truncated.\n", path);
+        close(fd);
+        return 1;
+    }
+    size = (size_t) st.st_size;
+
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "Error - Cannot map checkpoint '%s'.\n", path);
+        return 1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    CheckpointHeader header;
+    memcpy(&header, map, sizeof(header));
+    if (memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC))
+            || header.version != CHECKPOINT_VERSION) {
+        fprintf(stderr, "Error - '%s' is not a checkpoint.\n", path);
+        status = 1;
+        goto TERMINATE;
+    }
+
+    // Check the size before trusting any count of the header.
+    uint64_t n = header.n, m = header.m;
+    uint64_t limit = size / sizeof(uint64_t);
+    if (n >= limit || m >= limit || (n + 1) > limit / (m + 1)
+            || header.pool_count > limit || header.pool_values > limit) {
+        status = 1;
+    } else {
+        uint64_t expected = sizeof(header) + (m + 1) * (n + 1) * sizeof(Fraction)
+            + m * sizeof(uint64_t) + header.pool_count * sizeof(uint64_t)
+            + header.pool_values * sizeof(double);
+        if (expected != size) status = 1;
+    }
+    if (!status && fnv1a(FNV_OFFSET, map + sizeof(header), size - sizeof(header))
+            != header.checksum) {
+        status = 1;
+    }
+    if (status) {
+        fprintf(stderr, "Error - Checkpoint '%s' is corrupted.\n", path);
+        goto TERMINATE;
+    }
+
+    const unsigned char *p = map + sizeof(header);
+
+    // Tableau.
+    size_t elems = (m + 1) * (n + 1);
+    Fraction *data = arena_alloc(arena, elems * sizeof(Fraction));
+    size_t *new_basis = arena_alloc(arena, (m ? m : 1) * sizeof(size_t));
+    if (data == NULL || new_basis == NULL) {
+        fprintf(stderr, "Error - Not enough memory to load the checkpoint.\n");
+        status = 1;
+        goto TERMINATE;
+    }
+    memcpy(data, p, elems * sizeof(Fraction));
+    p += elems * sizeof(Fraction);
+    for (size_t k = 0; k < elems; k++) {
+        if (data[k].den <= 0) {
+            fprintf(stderr, "Error - Checkpoint '%s' is corrupted.\n", path);
+            status = 1;
+            goto TERMINATE;
+        }
+    }
+
+    // Basis.
+    for (size_t i = 0; i < m; i++) {
+        uint64_t var;
+        memcpy(&var, p, sizeof(var));
+        p += sizeof(var);
+        if (var < 1 || var > n) {
+            fprintf(stderr, "Error - Checkpoint '%s' is corrupted.\n", path);
+            status = 1;
+            goto TERMINATE;
+        }
+        new_basis[i] = var;
+    }
+
+    // Cut pool. Every section starts at a multiple of 8 bytes, so the values
+    // can be read in place.
+    const double *values = (const double*) (p + header.pool_count * sizeof(uint64_t));
+    uint64_t remaining = header.pool_values;
+    for (size_t k = 0; k < header.pool_count; k++) {
+        uint64_t len;
+        memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (len > remaining) {
+            fprintf(stderr, "Error - Checkpoint '%s' is corrupted.\n", path);
+            status = 1;
+            goto TERMINATE;
+        }
+        remaining -= len;
+
+        status = cut_pool_add(pool, values, len);
+        if (status) goto TERMINATE;
+        values += len;
+    }
+
+    tab->n = n;
+    tab->m = m;
+    tab->data = data;
+    tab->arena = arena;
+    tab->stride = n + 1;
+    tab->row_cap = m + 1;
+    *basis = new_basis;
+
+    state->phase = (int) header.phase;
+    state->round = header.round;
+
+TERMINATE:
+    munmap(map, size);
+
+    return status;
+}
@@ -0,0 +1,142 @@
+#include "../include/colgen.h"
+
+#include <stdio.h>
+
+// Find a unit column e_i for every row of the constraint matrix. Returns 0
+// on success.
+static int find_unit_columns(const Tableau *tab, size_t *unit) {
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i < tab->m; i++) unit[i] = 0;
+
+    for (size_t j = 1; j <= tab->n; j++) {
+        size_t row = 0;
+        char ok = 1;
+        for (size_t i = 1; i <= tab->m && ok; i++) {
+            Fraction elem = tab->data[i * cols + j];
+            if (elem.num == 0) continue;
+            if (row || elem.num != 1 || elem.den != 1) ok = 0;
+            else row = i;
+        }
+        if (ok && row && !unit[row - 1]) unit[row - 1] = j;
+    }
+
+    for (size_t i = 0; i < tab->m; i++)
+        if (!unit[i]) return 1;
+    return 0;
+}
+
+void colgen_duals(const Tableau *tab, const size_t *unit, const Fraction *unit_cost,
+        Fraction *duals) {
+    // Reduced cost of e_i: c_i - y_i.
+    duals[0] = fraction_create(0, 1);
+    for (size_t i = 1; i <= tab->m; i++)
+        duals[i] = fraction_subtract(unit_cost[i - 1], tab->data[unit[i - 1]]);
+}
+
+// Write in column 'dst' of the tableau the column 'col' (cost, then the rows)
+// expressed in the current basis: B^-1 a is a combination of the current
+// unit columns, the reduced cost is c - y a.
+static void append_column(Tableau *tab, size_t dst, const Fraction *col,
+        const size_t *unit, const Fraction *duals) {
+    size_t cols = tableau_stride(tab);
+
+    Fraction rc = col[0];
+    for (size_t i = 1; i <= tab->m; i++) {
+        if (col[i].num == 0) continue;
+        rc = fraction_subtract(rc, fraction_multiply(duals[i], col[i]));
+    }
+    tab->data[dst] = rc;
+
+    for (size_t r = 1; r <= tab->m; r++) {
+        Fraction sum = fraction_create(0, 1);
+        for (size_t i = 1; i <= tab->m; i++) {
+            if (col[i].num == 0) continue;
+            Fraction b_ri = tab->data[r * cols + unit[i - 1]];
+            if (b_ri.num == 0) continue;
+            sum = fraction_add(sum, fraction_multiply(b_ri, col[i]));
+        }
+        tab->data[r * cols + dst] = sum;
+    }
+}
+
+int column_generation(Tableau *tab, size_t *basis, PricingCallback pricing,
+        void *data, ColGenStats *stats) {
+    const SolverParams *params = tableau_params(tab);
+    int status = INFEASIBLE;
+    size_t m = tab->m;
+    size_t batch = params->colgen_batch > 0 ? (size_t) params->colgen_batch : 1;
+
+    stats->rounds = 0;
+    solve_begin(params);
+    stats->columns_added = 0;
+
+    // Not rewound at the end: the tableau grows in the same arena.
+    size_t *unit = arena_alloc(tab->arena, m * sizeof(size_t));
+    Fraction *unit_cost = arena_alloc(tab->arena, m * sizeof(Fraction));
+    Fraction *duals = arena_alloc(tab->arena, (m + 1) * sizeof(Fraction));
+    Fraction *cols = arena_alloc(tab->arena, batch * (m + 1) * sizeof(Fraction));
+    if (unit == NULL || unit_cost == NULL || duals == NULL || cols == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the column generation.\n");
+        goto TERMINATE;
+    }
+
+    if (find_unit_columns(tab, unit)) {
+        fprintf(stderr, "Error - The master problem needs a unit column per row.\n");
+        goto TERMINATE;
+    }
+    for (size_t i = 0; i < m; i++)
+        unit_cost[i] = tab->data[unit[i]];
+
+    // Restricted master problem.
+    status = two_phase_simplex(tab, basis);
+
+    while (status == OPTIMAL) {
+        if (solve_stop(params, &status)) break;
+
+        colgen_duals(tab, unit, unit_cost, duals);
+        size_t count = pricing(duals, m, cols, batch, data);
+        stats->rounds++;
+
+        // Keep only the improving columns.
+        size_t kept = 0;
+        for (size_t k = 0; k < count && k < batch; k++) {
+            const Fraction *col = &cols[k * (m + 1)];
+            Fraction rc = col[0];
+            for (size_t i = 1; i <= m; i++)
+                if (col[i].num) rc = fraction_subtract(rc, fraction_multiply(duals[i], col[i]));
+            if (rc.num >= 0) continue;
+            if (kept != k) {
+                for (size_t i = 0; i <= m; i++)
+                    cols[kept * (m + 1) + i] = col[i];
+            }
+            kept++;
+        }
+        if (!kept) break;
+
+        size_t old_n = tab->n;
+        if (augment_tableau(tab, old_n + kept, m)) {
+            fprintf(stderr, "Error - Cannot append the columns.\n");
+            status = INFEASIBLE;
+            break;
+        }
+        for (size_t k = 0; k < kept; k++)
+            append_column(tab, old_n + 1 + k, &cols[k * (m + 1)], unit, duals);
+        stats->columns_added += kept;
+
+        solver_log(params, "\n### Column generation - round %lu: %lu columns ###\n",
+                stats->rounds, kept);
+
+        // The basis is still primal feasible: warm start.
+        status = simplex(tab, basis);
+        if (status == OPTIMAL) solve_round(params, tableau_cost(tab));
+    }
+
+TERMINATE:
+    solve_end();
+    arena_free(tab->arena, unit);
+    arena_free(tab->arena, unit_cost);
+    arena_free(tab->arena, duals);
+    arena_free(tab->arena, cols);
+
+    return status;
+}
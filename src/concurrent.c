@@ -0,0 +1,242 @@
+#include "../include/concurrent.h"
+#include "../include/soa_tableau.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Milliseconds between two checks of the cancellation flag of the caller.
+#define CANCEL_POLL_INTERVAL 10
+
+static const char *engine_names[N_ENGINES] = {
+    "primal", "primal (perturbation)", "primal (lexicographic)", "dual", "primal (SoA)"
+};
+
+const char *concurrent_engine_name(int engine) {
+    if (engine < 0 || engine >= N_ENGINES) return "none";
+    return engine_names[engine];
+}
+
+// State shared by the engines of a race.
+typedef struct {
+    atomic_int cancel;       // Set by the winner, or when the caller cancels.
+    pthread_mutex_t lock;    // Protects 'res' and 'running'.
+    pthread_cond_t done;     // Signaled when an engine returns.
+    int running;
+    ConcurrentResult *res;
+    struct timespec start;
+} Race;
+
+// A single engine of the race, with its own copy of the problem.
+typedef struct {
+    Race *race;
+    int engine;
+    SolverParams params;
+    Arena arena;
+    Tableau tab;
+    size_t *basis;
+} Racer;
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+// Return 1 if the basis of 'tab' is primal (rhs >= 0) or dual (reduced
+// costs >= 0) feasible.
+static int basis_feasible(const Tableau *tab, char primal) {
+    size_t cols = tableau_stride(tab);
+    if (primal) {
+        for (size_t i = 1; i <= tab->m; i++)
+            if (tab->data[i * cols].num < 0) return 0;
+    } else {
+        for (size_t j = 1; j <= tab->n; j++)
+            if (tab->data[j].num < 0) return 0;
+    }
+    return 1;
+}
+
+// Run one engine on 'tab'. Returns its status, or ENGINE_NOT_APPLICABLE.
+static int run_engine(int engine, Tableau *tab, size_t *basis) {
+    switch (engine) {
+    case ENGINE_PRIMAL:
+    case ENGINE_PRIMAL_PERTURB:
+    case ENGINE_PRIMAL_LEX:
+        return two_phase_simplex(tab, basis);
+
+    case ENGINE_DUAL:
+        if (search_starting_basis(tab, basis) || !basis_feasible(tab, 0))
+            return ENGINE_NOT_APPLICABLE;
+
+        // An unbounded dual means an infeasible primal.
+        int status = dual_simplex(tab, basis);
+        return status == UNBOUNDED ? INFEASIBLE : status;
+
+    case ENGINE_SOA: {
+        if (search_starting_basis(tab, basis) || !basis_feasible(tab, 1))
+            return ENGINE_NOT_APPLICABLE;
+
+        SoaTableau soa;
+        if (soa_tableau_from_tableau(&soa, tab)) return ENGINE_NOT_APPLICABLE;
+        int status = soa_simplex(&soa, basis);
+        soa_tableau_to_tableau(&soa, tab);
+        soa_tableau_free(&soa);
+        return status;
+    }
+    }
+
+    return ENGINE_NOT_APPLICABLE;
+}
+
+static void *racer_main(void *arg) {
+    Racer *racer = arg;
+    Race *race = racer->race;
+
+    int status = run_engine(racer->engine, &racer->tab, racer->basis);
+
+    // The first conclusive engine wins.
+    pthread_mutex_lock(&race->lock);
+    race->res->engine_status[racer->engine] = status;
+    if ((status == OPTIMAL || status == INFEASIBLE || status == UNBOUNDED)
+            && race->res->engine < 0) {
+        race->res->engine = racer->engine;
+        race->res->status = status;
+        race->res->seconds = elapsed_seconds(&race->start);
+        atomic_store(&race->cancel, 1);
+    }
+    race->running--;
+    pthread_cond_signal(&race->done);
+    pthread_mutex_unlock(&race->lock);
+
+    return NULL;
+}
+
+// Give 'racer' a private copy of the problem. Returns 0 on success.
+static int racer_init(Racer *racer, const Tableau *tab) {
+    arena_init(&racer->arena, 0);
+
+    Tableau *copy = &racer->tab;
+    *copy = (Tableau) {tab->n, tab->m, NULL, &racer->arena, 0, 0, &racer->params};
+    copy->data = arena_alloc(&racer->arena, (tab->m + 1) * (tab->n + 1) * sizeof(Fraction));
+    racer->basis = arena_alloc(&racer->arena, (tab->m ? tab->m : 1) * sizeof(size_t));
+    if (copy->data == NULL || racer->basis == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the %s engine.\n",
+                concurrent_engine_name(racer->engine));
+        arena_destroy(&racer->arena);
+        return 1;
+    }
+
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i <= tab->m; i++)
+        memcpy(&copy->data[i * (tab->n + 1)], &tab->data[i * cols],
+                (tab->n + 1) * sizeof(Fraction));
+
+    return 0;
+}
+
+int concurrent_simplex(Tableau *tab, size_t *basis, unsigned int engines,
+        ConcurrentResult *res) {
+    const SolverParams *params = tableau_params(tab);
+
+    res->status = ITERATION_LIMIT;
+    res->engine = -1;
+    res->seconds = 0;
+    for (int e = 0; e < N_ENGINES; e++)
+        res->engine_status[e] = ENGINE_NOT_APPLICABLE;
+
+    Race race;
+    race.res = res;
+    atomic_init(&race.cancel, 0);
+    pthread_mutex_init(&race.lock, NULL);
+    pthread_cond_init(&race.done, NULL);
+    race.running = 0;
+    clock_gettime(CLOCK_MONOTONIC, &race.start);
+
+    Racer racers[N_ENGINES];
+    pthread_t threads[N_ENGINES];
+    char started[N_ENGINES] = {0};
+
+    for (int e = 0; e < N_ENGINES; e++) {
+        if (!(engines & (1u << e))) continue;
+
+        racers[e].race = &race;
+        racers[e].engine = e;
+        racers[e].params = *params;
+        racers[e].params.cancel = &race.cancel;
+        racers[e].params.verbose = 0;
+        racers[e].params.checkpoint_path = NULL;
+        racers[e].params.progress = NULL;
+        racers[e].params.scope = NULL; // A pivot budget per engine.
+        if (e == ENGINE_PRIMAL) racers[e].params.degeneracy = DEGEN_NONE;
+        if (e == ENGINE_PRIMAL_PERTURB) racers[e].params.degeneracy = DEGEN_PERTURB;
+        if (e == ENGINE_PRIMAL_LEX) racers[e].params.degeneracy = DEGEN_LEXICOGRAPHIC;
+
+        if (racer_init(&racers[e], tab)) continue;
+        pthread_mutex_lock(&race.lock);
+        race.running++;
+        pthread_mutex_unlock(&race.lock);
+        if (pthread_create(&threads[e], NULL, racer_main, &racers[e])) {
+            fprintf(stderr, "Error - Cannot start the %s engine.\n",
+                    concurrent_engine_name(e));
+            pthread_mutex_lock(&race.lock);
+            race.running--;
+            pthread_mutex_unlock(&race.lock);
+            arena_destroy(&racers[e].arena);
+            continue;
+        }
+        started[e] = 1;
+    }
+
+    // The engines watch the flag of the race: the cancellation of the caller
+    // is forwarded to it.
+    pthread_mutex_lock(&race.lock);
+    while (race.running > 0) {
+        if (solver_cancelled(params)) atomic_store(&race.cancel, 1);
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += CANCEL_POLL_INTERVAL * 1000000L;
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&race.done, &race.lock, &until);
+    }
+    pthread_mutex_unlock(&race.lock);
+
+    for (int e = 0; e < N_ENGINES; e++)
+        if (started[e]) pthread_join(threads[e], NULL);
+
+    // Without a winner, the reason the engines stopped: a time limit or a
+    // cancellation shared by all of them, otherwise their pivot budgets.
+    if (res->engine < 0) {
+        int stop = -1;
+        for (int e = 0; e < N_ENGINES; e++) {
+            int s = res->engine_status[e];
+            if (s == ENGINE_NOT_APPLICABLE) continue;
+            stop = stop < 0 || stop == s ? s : ITERATION_LIMIT;
+        }
+        if (solver_cancelled(params)) stop = CANCELLED;
+        if (stop == TIME_LIMIT || stop == CANCELLED) res->status = stop;
+    }
+
+    // Copy back the solution of the winner.
+    if (res->engine >= 0) {
+        const Racer *winner = &racers[res->engine];
+        size_t cols = tableau_stride(tab);
+        for (size_t i = 0; i <= tab->m; i++)
+            memcpy(&tab->data[i * cols], &winner->tab.data[i * (tab->n + 1)],
+                    (tab->n + 1) * sizeof(Fraction));
+        memcpy(basis, winner->basis, tab->m * sizeof(size_t));
+    }
+
+    for (int e = 0; e < N_ENGINES; e++)
+        if (started[e]) arena_destroy(&racers[e].arena);
+
+    pthread_cond_destroy(&race.done);
+    pthread_mutex_destroy(&race.lock);
+
+    return res->status;
+}
@@ -0,0 +1,241 @@
+#include "../include/cuts.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void cut_pool_init(CutPool *pool, Arena *arena) {
+    pool->count = 0;
+    pool->cap = 0;
+    pool->len = NULL;
+    pool->unit = NULL;
+    pool->arena = arena;
+}
+
+void cut_pool_free(CutPool *pool) {
+    for (size_t k = 0; k < pool->count; k++)
+        arena_free(pool->arena, pool->unit[k]);
+    arena_free(pool->arena, pool->unit);
+    arena_free(pool->arena, pool->len);
+    cut_pool_init(pool, pool->arena);
+}
+
+int cut_pool_add(CutPool *pool, const double *unit, size_t len) {
+    if (pool->count == pool->cap) {
+        size_t cap = pool->cap ? 2 * pool->cap : 16;
+        size_t *new_len = arena_realloc(pool->arena, pool->len,
+                pool->cap * sizeof(size_t), cap * sizeof(size_t));
+        if (new_len == NULL) return 1;
+        pool->len = new_len;
+
+        double **new_unit = arena_realloc(pool->arena, pool->unit,
+                pool->cap * sizeof(double*), cap * sizeof(double*));
+        if (new_unit == NULL) return 1;
+        pool->unit = new_unit;
+
+        pool->cap = cap;
+    }
+
+    double *copy = arena_alloc(pool->arena, len * sizeof(double));
+    if (copy == NULL) return 1;
+    memcpy(copy, unit, len * sizeof(double));
+
+    pool->unit[pool->count] = copy;
+    pool->len[pool->count] = len;
+    pool->count++;
+
+    return 0;
+}
+
+// |cos| between two unit vectors, restricted to their common columns.
+static double abs_cos(const double *u, size_t len_u, const double *v, size_t len_v) {
+    size_t len = len_u < len_v ? len_u : len_v;
+    double dot = 0;
+    for (size_t j = 0; j < len; j++)
+        dot += u[j] * v[j];
+    return fabs(dot);
+}
+
+double cut_pool_orthogonality(const CutPool *pool, const double *unit, size_t len) {
+    double ortho = 1;
+    for (size_t k = 0; k < pool->count; k++) {
+        double o = 1 - abs_cos(unit, len, pool->unit[k], pool->len[k]);
+        if (o < ortho) ortho = o;
+    }
+    return ortho;
+}
+
+void cut_workspace_init(CutWorkspace *ws) {
+    ws->cand = NULL;
+    ws->cand_cap = 0;
+    ws->units = NULL;
+    ws->units_cap = 0;
+    ws->coefs = NULL;
+    ws->coefs_cap = 0;
+}
+
+void cut_workspace_free(CutWorkspace *ws, Arena *arena) {
+    arena_free(arena, ws->cand);
+    arena_free(arena, ws->units);
+    arena_free(arena, ws->coefs);
+    cut_workspace_init(ws);
+}
+
+int cut_workspace_reserve(CutWorkspace *ws, Arena *arena, size_t count, size_t n) {
+    if (count > ws->cand_cap) {
+        size_t cap = 2 * count;
+        CutCandidate *cand = arena_alloc(arena, cap * sizeof(CutCandidate));
+        if (cand == NULL) return 1;
+        arena_free(arena, ws->cand);
+        ws->cand = cand;
+        ws->cand_cap = cap;
+    }
+    if (count * n > ws->units_cap) {
+        size_t cap = 2 * count * n;
+        double *units = arena_alloc(arena, cap * sizeof(double));
+        if (units == NULL) return 1;
+        arena_free(arena, ws->units);
+        ws->units = units;
+        ws->units_cap = cap;
+    }
+    if (count * (n + 1) > ws->coefs_cap) {
+        size_t cap = 2 * count * (n + 1);
+        Fraction *coefs = arena_alloc(arena, cap * sizeof(Fraction));
+        if (coefs == NULL) return 1;
+        arena_free(arena, ws->coefs);
+        ws->coefs = coefs;
+        ws->coefs_cap = cap;
+    }
+    return 0;
+}
+
+// Work assigned to a thread: candidates first, first + step, ...
+typedef struct {
+    size_t n;
+    const CutPool *pool;
+    CutCandidate *cand;
+    size_t count;
+    size_t first;
+    size_t step;
+    double ortho_weight;
+} ScoreTask;
+
+// Compute the unit vector, the efficacy and the orthogonality of the
+// candidates assigned to the task.
+static void *score_candidates(void *arg) {
+    ScoreTask *task = arg;
+    size_t n = task->n;
+
+    for (size_t k = task->first; k < task->count; k += task->step) {
+        CutCandidate *c = &task->cand[k];
+        const Fraction *row = c->coef;
+
+        // Cut: sum_j coef_j x_j <= coef_0.
+        double norm = 0;
+        for (size_t j = 1; j <= n; j++) {
+            double f = fraction_to_double(row[j]);
+            c->unit[j - 1] = f;
+            norm += f * f;
+        }
+        norm = sqrt(norm);
+
+        if (norm > 0) {
+            for (size_t j = 0; j < n; j++)
+                c->unit[j] /= norm;
+            c->efficacy = -fraction_to_double(row[0]) / norm;
+        } else {
+            // 0 <= coef_0 < 0: the cut proves infeasibility, take it first.
+            c->efficacy = INFINITY;
+        }
+
+        c->orthogonality = cut_pool_orthogonality(task->pool, c->unit, n);
+        c->score = c->efficacy + task->ortho_weight * c->orthogonality;
+    }
+
+    return NULL;
+}
+
+// Best score first, ties broken by the generation order.
+static int compare_candidates(const void *a, const void *b) {
+    const CutCandidate *c1 = a, *c2 = b;
+    if (c1->score > c2->score) return -1;
+    if (c1->score < c2->score) return 1;
+    return (c1->index > c2->index) - (c1->index < c2->index);
+}
+
+size_t cut_select(const Tableau *tab, CutPool *pool, CutWorkspace *ws, size_t count) {
+    const SolverParams *params = tableau_params(tab);
+    if (!count) return 0;
+
+    for (size_t k = 0; k < count; k++) {
+        ws->cand[k].index = k;
+        ws->cand[k].unit = &ws->units[k * tab->n];
+    }
+
+    // Score the candidates, in parallel if required.
+    size_t n_threads = params->threads > 1 ? (size_t) params->threads : 1;
+    if (n_threads > count) n_threads = count;
+
+    ScoreTask tasks[n_threads];
+    pthread_t threads[n_threads];
+    for (size_t t = 0; t < n_threads; t++) {
+        tasks[t].n = tab->n;
+        tasks[t].pool = pool;
+        tasks[t].cand = ws->cand;
+        tasks[t].count = count;
+        tasks[t].first = t;
+        tasks[t].step = n_threads;
+        tasks[t].ortho_weight = params->cut_ortho_weight;
+    }
+
+    size_t started = 1; // Task 0 runs on the calling thread.
+    for (; started < n_threads; started++) {
+        if (pthread_create(&threads[started], NULL, score_candidates, &tasks[started]))
+            break;
+    }
+    score_candidates(&tasks[0]);
+    // Tasks that could not be started run here.
+    for (size_t t = started; t < n_threads; t++)
+        score_candidates(&tasks[t]);
+    for (size_t t = 1; t < started; t++)
+        pthread_join(threads[t], NULL);
+
+    // Greedy selection: best score first, skipping the candidates that are
+    // almost parallel to a cut already selected in this round.
+    qsort(ws->cand, count, sizeof(CutCandidate), compare_candidates);
+
+    size_t max_cuts = params->cuts_per_round > 0 ? (size_t) params->cuts_per_round : 1;
+    size_t selected = 0;
+    for (size_t k = 0; k < count && selected < max_cuts; k++) {
+        CutCandidate *c = &ws->cand[k];
+
+        char parallel = 0;
+        for (size_t s = 0; s < selected && !parallel; s++) {
+            double o = 1 - abs_cos(c->unit, tab->n, ws->cand[s].unit, tab->n);
+            if (o < params->cut_min_orthogonality) parallel = 1;
+        }
+        if (parallel) continue;
+
+        // Keep the selected candidates at the front of the array.
+        CutCandidate tmp = ws->cand[selected];
+        ws->cand[selected] = *c;
+        *c = tmp;
+        selected++;
+    }
+
+    for (size_t s = 0; s < selected; s++)
+        cut_pool_add(pool, ws->cand[s].unit, tab->n);
+
+    return selected;
+}
+
+void gomory_write_cut(const Tableau *tab, size_t src, Fraction *out, size_t n_src) {
+    size_t cols = tableau_stride(tab);
+    for (size_t j = 0; j <= n_src; j++) {
+        Fraction elem = tab->data[src * cols + j];
+        Fraction res = fraction_subtract(elem, fraction_floor(elem));
+        out[j] = fraction_chg_sign(res);
+    }
+}
@@ -0,0 +1,457 @@
+#include "../include/daemon.h"
+#include "../include/arena.h"
+#include "../include/async_solve.h"
+#include "../include/backend.h"
+#include "../include/heuristics.h"
+#include "../include/wire.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Milliseconds between two checks of the shutdown request.
+#define POLL_INTERVAL 200
+
+// A client connection. Its socket is non-blocking and only the main thread
+// reads or writes it: requests are queued once their message is complete and
+// results are sent as the client accepts them, so a slow client blocks
+// neither the other clients nor the solver threads. The main thread and every
+// queued request hold a reference: the socket is closed when the last one is
+// released. All fields but 'in' and 'eof' are protected by d->lock.
+typedef struct {
+    int fd;
+    int refs;
+    int pending;           // Requests queued or being solved.
+    char eof;              // The client sent its last request: the connection
+                           // is kept until its results are sent.
+    char closed;           // The client left: its requests are dropped.
+    WireBuffer in;         // Received bytes of the requests not complete yet.
+    WireBuffer out;        // Results not sent yet.
+} Connection;
+
+typedef struct Job {
+    struct Job *next;
+    Connection *conn;
+    WireBuffer payload;    // The DAEMON_SOLVE message.
+} Job;
+
+typedef struct {
+    SolverParams params;   // Defaults of the requests.
+    atomic_int cancel;     // Stops the running solves on shutdown.
+    pthread_mutex_t lock;  // Queue and references of the connections.
+    pthread_cond_t ready;
+    Job *head, *tail;
+    size_t queued;
+    char stopping;
+    int wake[2];           // Pipe written when a result is ready to be sent.
+} Daemon;
+
+// A solver thread. Its arena and buffers stay allocated between requests.
+typedef struct {
+    Daemon *d;
+    Arena arena;           // Tableau and basis of the request.
+    WireBuffer out;        // Result being encoded.
+    SolverParams params;
+    SolverProgress progress;
+    Incumbent incumbent;
+    pthread_t thread;
+} DaemonWorker;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int sig) {
+    (void) sig;
+    stop_requested = 1;
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0;
+}
+
+static Connection *connection_create(int fd) {
+    if (set_nonblocking(fd)) return NULL;
+    Connection *conn = malloc(sizeof(Connection));
+    if (conn == NULL) return NULL;
+    conn->fd = fd;
+    conn->refs = 1;
+    conn->pending = 0;
+    conn->eof = 0;
+    conn->closed = 0;
+    wire_init(&conn->in);
+    wire_init(&conn->out);
+    return conn;
+}
+
+// Drop a reference, with d->lock held.
+static void connection_release(Connection *conn) {
+    if (--conn->refs) return;
+    close(conn->fd);
+    wire_free(&conn->in);
+    wire_free(&conn->out);
+    free(conn);
+}
+
+// Result of a request that was not solved.
+static void put_rejected(WireBuffer *out) {
+    wire_put_u32(out, (uint32_t) DAEMON_REJECTED);
+    wire_put_u64(out, 0);
+    wire_put_double(out, 0);
+    wire_put_double(out, 0);
+    wire_put_fraction(out, fraction_create(0, 1));
+    wire_put_u32(out, 0);
+}
+
+// Decode and solve a request, then encode its result in w->out.
+static void solve_request(DaemonWorker *w, WireBuffer *in) {
+    uint64_t id = wire_get_u64(in);
+    DaemonRequest req;
+    req.algorithm = (int) wire_get_u32(in);
+    req.max_iterations = (int) wire_get_u32(in);
+    req.time_limit = wire_get_double(in);
+    size_t m = wire_get_u32(in);
+    size_t n = wire_get_u32(in);
+
+    wire_clear(&w->out);
+    wire_put_u64(&w->out, id);
+
+    // The tableau must fill the rest of the message exactly.
+    size_t entries = (m + 1) * (n + 1);
+    if (in->error || m == 0 || n == 0 || m > WIRE_MAX_PAYLOAD || n > WIRE_MAX_PAYLOAD
+            || req.algorithm < ALGO_SIMPLEX
+            || req.algorithm > ALGO_CUTTING_PLANE
+            || (in->len - in->pos) / 8 != entries || (in->len - in->pos) % 8) {
+        put_rejected(&w->out);
+        return;
+    }
+
+    arena_reset(&w->arena);
+    Tableau tab = {n, m, NULL, &w->arena, 0, 0, &w->params};
+    tab.data = arena_alloc(&w->arena, entries * sizeof(Fraction));
+    size_t *basis = arena_alloc(&w->arena, m * sizeof(size_t));
+    if (tab.data == NULL || basis == NULL) {
+        fprintf(stderr, "Error - Not enough memory for a request.\n");
+        put_rejected(&w->out);
+        return;
+    }
+    for (size_t k = 0; k < entries; k++) tab.data[k] = wire_get_fraction(in);
+    if (in->error) {
+        put_rejected(&w->out);
+        return;
+    }
+
+    w->params = w->d->params;
+    w->params.progress = &w->progress;
+    if (req.max_iterations > 0) w->params.max_iterations = req.max_iterations;
+    if (req.time_limit > 0) w->params.time_limit = req.time_limit;
+    incumbent_free(&w->incumbent);
+    incumbent_init(&w->incumbent);
+    w->params.incumbent = w->params.heuristics ? &w->incumbent : NULL;
+    atomic_store(&w->progress.objective, 0);
+
+    double start = monotonic_seconds();
+    int status = async_solve_run(&tab, &basis, req.algorithm);
+
+    wire_put_u32(&w->out, (uint32_t) status);
+    wire_put_u64(&w->out, (uint64_t) atomic_load(&w->progress.pivots));
+    wire_put_double(&w->out, monotonic_seconds() - start);
+    wire_put_double(&w->out, atomic_load(&w->progress.objective));
+
+    // The solution: the incumbent of the heuristics (the cutting plane stops
+    // on the gap before its vertex is integer), or the vertex of the tableau
+    // (written back by the classic backend only).
+    if ((status == FEASIBLE || status == OPTIMAL) && w->incumbent.found) {
+        wire_put_fraction(&w->out, w->incumbent.cost);
+        wire_put_u32(&w->out, (uint32_t) n);
+        for (size_t j = 1; j <= n; j++) wire_put_fraction(&w->out, w->incumbent.x[j]);
+    } else if (status == OPTIMAL && w->params.backend == BACKEND_CLASSIC) {
+        Fraction *x = arena_alloc(&w->arena, (n + 1) * sizeof(Fraction));
+        if (x == NULL) {
+            wire_put_fraction(&w->out, fraction_chg_sign(tab.data[0]));
+            wire_put_u32(&w->out, 0);
+            return;
+        }
+        tableau_vertex(&tab, basis, n, x);
+        wire_put_fraction(&w->out, fraction_chg_sign(tab.data[0]));
+        wire_put_u32(&w->out, (uint32_t) n);
+        for (size_t j = 1; j <= n; j++) wire_put_fraction(&w->out, x[j]);
+    } else {
+        wire_put_fraction(&w->out, fraction_create(0, 1));
+        wire_put_u32(&w->out, 0);
+    }
+}
+
+static void *worker_main(void *arg) {
+    DaemonWorker *w = arg;
+    Daemon *d = w->d;
+
+    for (;;) {
+        pthread_mutex_lock(&d->lock);
+        while (d->head == NULL && !d->stopping) pthread_cond_wait(&d->ready, &d->lock);
+        Job *job = d->head;
+        if (job == NULL) {
+            pthread_mutex_unlock(&d->lock);
+            break;
+        }
+        d->head = job->next;
+        if (d->head == NULL) d->tail = NULL;
+        d->queued--;
+        Connection *conn = job->conn;
+        char closed = conn->closed;
+        pthread_mutex_unlock(&d->lock);
+
+        if (!closed) solve_request(w, &job->payload);
+
+        // The main thread sends the result: a client that does not read its
+        // results cannot block the solver threads.
+        pthread_mutex_lock(&d->lock);
+        int err = !conn->closed
+            && (w->out.error || wire_append(&conn->out, DAEMON_RESULT, &w->out));
+        conn->pending--;
+        connection_release(conn);
+        pthread_mutex_unlock(&d->lock);
+        if (err) fprintf(stderr, "Error - Not enough memory for a result.\n");
+        wire_free(&job->payload);
+        free(job);
+
+        // A full pipe already holds a wake up.
+        char c = 0;
+        ssize_t r = write(d->wake[1], &c, 1);
+        (void) r;
+    }
+
+    return NULL;
+}
+
+// Read what 'conn' has sent and queue its complete requests. Returns 1 if the
+// connection must be closed.
+static int read_requests(Daemon *d, Connection *conn) {
+    int status = wire_read(conn->fd, &conn->in);
+    if (status < 0) return 1;
+    if (status) conn->eof = 1;
+
+    WireBuffer payload;
+    wire_init(&payload);
+    uint32_t type;
+    while ((status = wire_next(&conn->in, &type, &payload, WIRE_MAX_PAYLOAD)) == 1) {
+        Job *job = type == DAEMON_SOLVE ? malloc(sizeof(Job)) : NULL;
+        if (job == NULL) {
+            status = -1;
+            break;
+        }
+        job->payload = payload;
+        wire_init(&payload);
+
+        pthread_mutex_lock(&d->lock);
+        job->conn = conn;
+        job->next = NULL;
+        conn->refs++;
+        conn->pending++;
+        if (d->tail) d->tail->next = job;
+        else d->head = job;
+        d->tail = job;
+        d->queued++;
+        pthread_cond_signal(&d->ready);
+        pthread_mutex_unlock(&d->lock);
+    }
+    wire_free(&payload);
+
+    if (status < 0 || (conn->eof && conn->in.pos < conn->in.len)) {
+        fprintf(stderr, "Error - Bad request, closing the connection.\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Serve the poll events of 'conn': read its requests and send its results.
+// Returns 1 if the connection is over: the client left, or it sent its last
+// request and got all the results.
+static int serve_connection(Daemon *d, Connection *conn, short revents) {
+    if (revents & POLLERR) return 1;
+    if ((revents & POLLIN) && read_requests(d, conn)) return 1;
+
+    pthread_mutex_lock(&d->lock);
+    int err = conn->out.len && wire_write(conn->fd, &conn->out);
+    int over = err || (revents & POLLHUP)
+        || (conn->eof && !conn->pending && !conn->out.len);
+    pthread_mutex_unlock(&d->lock);
+    return over;
+}
+
+int solver_daemon(const char *addr, const SolverParams *params, int threads) {
+    if (threads <= 0) threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (threads <= 0) threads = 1;
+
+    Daemon d;
+    memset(&d, 0, sizeof(d));
+    d.params = *params;
+    d.params.verbose = 0;
+    d.params.checkpoint_path = NULL;
+    d.params.cut_stats = NULL;
+    d.params.incumbent = NULL;
+    d.params.cancel = &d.cancel;
+    atomic_init(&d.cancel, 0);
+    pthread_mutex_init(&d.lock, NULL);
+    pthread_cond_init(&d.ready, NULL);
+    d.wake[0] = d.wake[1] = -1;
+
+    int status = 1;
+    Connection **conns = NULL;
+    size_t n_conns = 0;
+    struct pollfd *pfd = NULL;
+
+    DaemonWorker *workers = calloc((size_t) threads, sizeof(DaemonWorker));
+    int started = 0;
+    int lfd = wire_listen(addr);
+    if (workers == NULL || lfd < 0) goto TERMINATE;
+    if (pipe(d.wake) || set_nonblocking(d.wake[0]) || set_nonblocking(d.wake[1])
+            || set_nonblocking(lfd)) {
+        fprintf(stderr, "Error - Cannot set up the daemon: %s.\n", strerror(errno));
+        goto TERMINATE;
+    }
+
+    for (; started < threads; started++) {
+        DaemonWorker *w = &workers[started];
+        w->d = &d;
+        arena_init(&w->arena, 0);
+        wire_init(&w->out);
+        incumbent_init(&w->incumbent);
+        atomic_init(&w->progress.pivots, 0);
+        atomic_init(&w->progress.rounds, 0);
+        atomic_init(&w->progress.objective, 0);
+        atomic_init(&w->progress.seconds, 0);
+        if (pthread_create(&w->thread, NULL, worker_main, w)) {
+            fprintf(stderr, "Error - Cannot start a solver thread.\n");
+            arena_destroy(&w->arena);
+            goto TERMINATE;
+        }
+    }
+
+    // Without SA_RESTART, poll() returns on the signal.
+    struct sigaction sa, old_int, old_term;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = request_stop;
+    sigemptyset(&sa.sa_mask);
+    stop_requested = 0;
+    sigaction(SIGINT, &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+
+    printf("Solver daemon listening on %s (%d threads).\n", addr, threads);
+    fflush(stdout);
+
+    size_t cap = 0;
+    while (!stop_requested) {
+        if (n_conns + 2 > cap) {
+            cap = 2 * (n_conns + 2);
+            struct pollfd *p = realloc(pfd, cap * sizeof(struct pollfd));
+            Connection **c = realloc(conns, cap * sizeof(Connection*));
+            if (p) pfd = p;
+            if (c) conns = c;
+            if (p == NULL || c == NULL) {
+                fprintf(stderr, "Error - Not enough memory for the connections.\n");
+                break;
+            }
+        }
+
+        // Clients are not read while the queue is full, nor while too many
+        // of their results are not sent.
+        pthread_mutex_lock(&d.lock);
+        char full = d.queued >= DAEMON_QUEUE_LIMIT;
+        for (size_t k = 0; k < n_conns; k++) {
+            Connection *conn = conns[k];
+            size_t unsent = conn->out.len - conn->out.pos;
+            pfd[k + 2].fd = conn->fd;
+            pfd[k + 2].events = 0;
+            if (!full && !conn->eof && unsent < DAEMON_OUTPUT_LIMIT)
+                pfd[k + 2].events |= POLLIN;
+            if (unsent) pfd[k + 2].events |= POLLOUT;
+            pfd[k + 2].revents = 0;
+        }
+        pthread_mutex_unlock(&d.lock);
+
+        pfd[0].fd = lfd;
+        pfd[0].events = POLLIN;
+        pfd[1].fd = d.wake[0];
+        pfd[1].events = POLLIN;
+        int ready = poll(pfd, n_conns + 2, full ? 1 : POLL_INTERVAL);
+        if (ready < 0 && errno != EINTR) {
+            fprintf(stderr, "Error - poll failed: %s.\n", strerror(errno));
+            break;
+        }
+        if (ready < 0) continue;
+
+        char drain[64];
+        if (pfd[1].revents & POLLIN)
+            while (read(d.wake[0], drain, sizeof(drain)) > 0) continue;
+
+        // Served in reverse, so that removing a connection keeps the indices
+        // of the ones still to serve. Every connection is served: the results
+        // of the solver threads are sent without waiting for a poll event.
+        for (size_t k = n_conns; k > 0; k--) {
+            Connection *conn = conns[k - 1];
+            if (!serve_connection(&d, conn, pfd[k + 1].revents)) continue;
+
+            pthread_mutex_lock(&d.lock);
+            conn->closed = 1;
+            connection_release(conn);
+            pthread_mutex_unlock(&d.lock);
+            conns[k - 1] = conns[--n_conns];
+        }
+
+        if (pfd[0].revents & POLLIN) {
+            int fd = wire_accept(lfd);
+            Connection *conn = fd >= 0 ? connection_create(fd) : NULL;
+            if (conn) conns[n_conns++] = conn;
+            else if (fd >= 0) close(fd);
+        }
+    }
+    status = stop_requested ? 0 : 1;
+    if (stop_requested) printf("Solver daemon shutting down.\n");
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+
+TERMINATE:
+    // Running solves stop at the next pivot and queued requests get the
+    // CANCELLED status.
+    atomic_store(&d.cancel, 1);
+    pthread_mutex_lock(&d.lock);
+    d.stopping = 1;
+    pthread_cond_broadcast(&d.ready);
+    pthread_mutex_unlock(&d.lock);
+    for (int t = 0; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+        arena_destroy(&workers[t].arena);
+        wire_free(&workers[t].out);
+        incumbent_free(&workers[t].incumbent);
+    }
+
+    // The results the clients accept without blocking are sent.
+    for (size_t k = 0; k < n_conns; k++) {
+        if (conns[k]->out.len) wire_write(conns[k]->fd, &conns[k]->out);
+        connection_release(conns[k]);
+    }
+    if (lfd >= 0) wire_close_listener(lfd, addr);
+    for (int k = 0; k < 2; k++)
+        if (d.wake[k] >= 0) close(d.wake[k]);
+    free(conns);
+    free(pfd);
+    free(workers);
+    pthread_cond_destroy(&d.ready);
+    pthread_mutex_destroy(&d.lock);
+
+    return status;
+}
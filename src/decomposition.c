@@ -0,0 +1,648 @@
+#include "../include/decomposition.h"
+#include "../include/colgen.h"
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Big-M escalations of the master before giving up, and the factor of each.
+#define MAX_ESCALATIONS 3
+#define ESCALATION_FACTOR 100
+
+// A subproblem: the rows and the columns of a block.
+typedef struct {
+    size_t m, n;
+    size_t *rows;     // Original rows (1..m of the problem).
+    size_t *cols;     // Original columns (1..n of the problem).
+    Tableau tab;      // Canonical form after the first solve (malloc'd).
+    size_t *basis;
+    Fraction *cost;   // Costs of the current round, n+1 entries.
+    char started;     // A feasible basis was found.
+    int status;       // Status of the last solve.
+    char ray;         // 'point' is a ray (UNBOUNDED).
+    Fraction *point;  // Solution (or ray) of the last solve, n+1 entries.
+    Fraction rc;      // Its cost, c' point.
+} Block;
+
+// An extreme point (or ray) of a block, a column of the master.
+typedef struct {
+    size_t block;
+    char ray;
+    Fraction *x;      // Values of the columns of the block, n+1 entries.
+} Proposal;
+
+typedef struct {
+    const Tableau *orig;
+    SolverParams block_params; // Params of the subproblems (quiet).
+    size_t n_linking;
+    size_t *linking;  // Linking rows.
+    int *sign;        // -1 if the linking row is negated in the master.
+    size_t n_blocks;
+    Block *blocks;
+    size_t n_direct;
+    size_t *direct;   // Columns that appear only in the linking rows.
+    Proposal *props;
+    size_t n_props, props_cap;
+    char phase_one;   // Feasibility master: zero costs, artificials cost 1.
+    int status;       // Failure of a subproblem (OPTIMAL if none).
+    size_t rounds;
+    const Fraction *duals;
+    Arena *arena;
+} Decomposition;
+
+static Fraction entry(const Tableau *tab, size_t i, size_t j) {
+    return tab->data[i * tableau_stride(tab) + j];
+}
+
+// Return 1 if 'x' solves Ax = b, x >= 0 of 'tab', checked in floating point:
+// a wrapped fraction of the master gives a solution far from it.
+static int solution_valid(const Tableau *tab, const Fraction *x) {
+    for (size_t j = 1; j <= tab->n; j++)
+        if (x[j].den <= 0 || x[j].num < 0) return 0;
+    for (size_t i = 1; i <= tab->m; i++) {
+        double b = fraction_to_double(entry(tab, i, 0));
+        double ax = 0;
+        for (size_t j = 1; j <= tab->n; j++)
+            if (x[j].num) ax += fraction_to_double(entry(tab, i, j)) * fraction_to_double(x[j]);
+        double scale = b < 0 ? 1 - b : 1 + b;
+        if (ax - b > 1e-6 * scale || b - ax > 1e-6 * scale) return 0;
+    }
+    return 1;
+}
+
+// Union-find over the rows.
+static size_t find(size_t *parent, size_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+size_t decomposition_detect(const Tableau *tab, int *row_block) {
+    size_t m = tab->m;
+    size_t n_blocks = 1;
+    size_t *parent = malloc((m + 1) * sizeof(size_t));
+    size_t *root = malloc((m + 1) * sizeof(size_t));
+    size_t *count = malloc((m + 1) * sizeof(size_t));
+    if (parent == NULL || root == NULL || count == NULL) {
+        fprintf(stderr, "Error - Not enough memory to detect the blocks.\n");
+        goto TERMINATE;
+    }
+
+    // Nonzeros of each row.
+    for (size_t i = 1; i <= m; i++) {
+        count[i] = 0;
+        for (size_t j = 1; j <= tab->n; j++)
+            if (entry(tab, i, j).num) count[i]++;
+        row_block[i - 1] = 0;
+    }
+
+    for (size_t n_linking = 0; 2 * n_linking < m; n_linking++) {
+        // Rows sharing a column are in the same block.
+        for (size_t i = 1; i <= m; i++) parent[i] = i;
+        for (size_t j = 1; j <= tab->n; j++) {
+            size_t first = 0;
+            for (size_t i = 1; i <= m; i++) {
+                if (row_block[i - 1] == LINKING_ROW || !entry(tab, i, j).num) continue;
+                if (!first) first = i;
+                else parent[find(parent, i)] = find(parent, first);
+            }
+        }
+
+        size_t blocks = 0;
+        for (size_t i = 1; i <= m; i++) root[i] = 0;
+        for (size_t i = 1; i <= m; i++) {
+            if (row_block[i - 1] == LINKING_ROW) continue;
+            size_t r = find(parent, i);
+            if (!root[r]) root[r] = ++blocks;
+        }
+        if (blocks >= 2) {
+            for (size_t i = 1; i <= m; i++)
+                if (row_block[i - 1] != LINKING_ROW)
+                    row_block[i - 1] = (int) root[find(parent, i)] - 1;
+            n_blocks = blocks;
+            goto TERMINATE;
+        }
+
+        // Move the densest row to the linking ones.
+        size_t densest = 0;
+        for (size_t i = 1; i <= m; i++)
+            if (row_block[i - 1] != LINKING_ROW && (!densest || count[i] > count[densest]))
+                densest = i;
+        row_block[densest - 1] = LINKING_ROW;
+    }
+
+    // No structure: a single block.
+    for (size_t i = 0; i < m; i++) row_block[i] = 0;
+
+TERMINATE:
+    free(parent);
+    free(root);
+    free(count);
+
+    return n_blocks;
+}
+
+// Price the subproblem out with the costs in block->cost: row 0 becomes
+// c' - c'_B B^-1 A, with -c'_B B^-1 b in column 0.
+static void set_block_costs(Block *block) {
+    Tableau *tab = &block->tab;
+    size_t cols = tableau_stride(tab);
+    for (size_t j = 0; j <= tab->n; j++)
+        tab->data[j] = block->cost[j];
+    for (size_t i = 1; i <= tab->m; i++) {
+        Fraction c = block->cost[block->basis[i - 1]];
+        if (c.num) fraction_row_fms(tab->data, &tab->data[i * cols], c, tab->n + 1);
+    }
+}
+
+// Solve the subproblem with the costs of the current duals: an improving
+// extreme point, or a ray if it is unbounded.
+static void solve_block(Decomposition *dec, Block *block) {
+    const Tableau *orig = dec->orig;
+    Tableau *tab = &block->tab;
+    size_t cols = tableau_stride(tab);
+
+    // c'_j = c_j - sum_l y_l a_lj over the linking rows (as in the master).
+    block->cost[0] = fraction_create(0, 1);
+    for (size_t j = 1; j <= block->n; j++) {
+        size_t col = block->cols[j - 1];
+        Fraction c = dec->phase_one ? fraction_create(0, 1) : entry(orig, 0, col);
+        for (size_t l = 0; l < dec->n_linking; l++) {
+            Fraction a = entry(orig, dec->linking[l], col);
+            if (!a.num || !dec->duals[l + 1].num) continue;
+            if (dec->sign[l] < 0) a = fraction_chg_sign(a);
+            c = fraction_subtract(c, fraction_multiply(dec->duals[l + 1], a));
+        }
+        block->cost[j] = c;
+    }
+
+    if (!block->started) {
+        // Any feasible basis: solve with zero costs.
+        for (size_t j = 0; j <= tab->n; j++)
+            tab->data[j] = fraction_create(0, 1);
+        block->status = two_phase_simplex(tab, block->basis);
+        if (block->status != OPTIMAL) return;
+        block->started = 1;
+    }
+
+    set_block_costs(block);
+    block->status = simplex(tab, block->basis);
+
+    for (size_t j = 0; j <= block->n; j++)
+        block->point[j] = fraction_create(0, 1);
+    block->ray = block->status == UNBOUNDED;
+
+    if (block->status == OPTIMAL) {
+        tableau_vertex(tab, block->basis, block->n, block->point);
+        block->rc = fraction_chg_sign(tab->data[0]);
+    } else if (block->ray) {
+        // The entering column: negative reduced cost, no positive entry.
+        for (size_t h = 1; h <= tab->n; h++) {
+            if (tab->data[h].num >= 0) continue;
+            char ray = 1;
+            for (size_t i = 1; i <= tab->m && ray; i++)
+                if (tab->data[i * cols + h].num > 0) ray = 0;
+            if (!ray) continue;
+
+            block->point[h] = fraction_create(1, 1);
+            for (size_t i = 1; i <= tab->m; i++)
+                block->point[block->basis[i - 1]] = fraction_chg_sign(tab->data[i * cols + h]);
+            block->rc = tab->data[h];
+            block->status = OPTIMAL;
+            break;
+        }
+    }
+}
+
+// Work assigned to a thread: blocks first, first + step, ...
+typedef struct {
+    Decomposition *dec;
+    size_t first;
+    size_t step;
+} BlockTask;
+
+static void *solve_blocks(void *arg) {
+    BlockTask *task = arg;
+    for (size_t k = task->first; k < task->dec->n_blocks; k += task->step)
+        solve_block(task->dec, &task->dec->blocks[k]);
+    return NULL;
+}
+
+// Master column of a proposal: cost, linking rows, convexity rows.
+static void master_column(const Decomposition *dec, const Proposal *p, Fraction *col) {
+    const Tableau *orig = dec->orig;
+    const Block *block = &dec->blocks[p->block];
+    size_t m = dec->n_linking + dec->n_blocks;
+
+    for (size_t i = 0; i <= m; i++)
+        col[i] = fraction_create(0, 1);
+    for (size_t j = 1; j <= block->n; j++) {
+        Fraction x = p->x[j];
+        if (!x.num) continue;
+        size_t c = block->cols[j - 1];
+        if (!dec->phase_one)
+            col[0] = fraction_add(col[0], fraction_multiply(entry(orig, 0, c), x));
+        for (size_t l = 0; l < dec->n_linking; l++) {
+            Fraction a = entry(orig, dec->linking[l], c);
+            if (!a.num) continue;
+            if (dec->sign[l] < 0) a = fraction_chg_sign(a);
+            col[l + 1] = fraction_add(col[l + 1], fraction_multiply(a, x));
+        }
+    }
+    if (!p->ray) col[dec->n_linking + 1 + p->block] = fraction_create(1, 1);
+}
+
+static int add_proposal(Decomposition *dec, size_t k) {
+    const Block *block = &dec->blocks[k];
+    if (dec->n_props == dec->props_cap) {
+        size_t cap = dec->props_cap ? 2 * dec->props_cap : 16;
+        Proposal *props = arena_realloc(dec->arena, dec->props,
+                dec->props_cap * sizeof(Proposal), cap * sizeof(Proposal));
+        if (props == NULL) return 1;
+        dec->props = props;
+        dec->props_cap = cap;
+    }
+
+    Proposal *p = &dec->props[dec->n_props];
+    p->block = k;
+    p->ray = block->ray;
+    p->x = arena_alloc(dec->arena, (block->n + 1) * sizeof(Fraction));
+    if (p->x == NULL) return 1;
+    memcpy(p->x, block->point, (block->n + 1) * sizeof(Fraction));
+    dec->n_props++;
+
+    return 0;
+}
+
+// Pricing oracle of the master: every block, in parallel.
+static size_t dw_pricing(const Fraction *duals, size_t m, Fraction *cols,
+        size_t max_cols, void *data) {
+    Decomposition *dec = data;
+    const SolverParams *params = tableau_params(dec->orig);
+    dec->duals = duals;
+    dec->rounds++;
+
+    size_t n_threads = params->threads > 1 ? (size_t) params->threads : 1;
+    if (n_threads > dec->n_blocks) n_threads = dec->n_blocks;
+    if (!n_threads) return 0;
+
+    BlockTask tasks[n_threads];
+    pthread_t threads[n_threads];
+    for (size_t t = 0; t < n_threads; t++) {
+        tasks[t].dec = dec;
+        tasks[t].first = t;
+        tasks[t].step = n_threads;
+    }
+
+    size_t started = 1; // Task 0 runs on the calling thread.
+    for (; started < n_threads; started++) {
+        if (pthread_create(&threads[started], NULL, solve_blocks, &tasks[started]))
+            break;
+    }
+    solve_blocks(&tasks[0]);
+    // Tasks that could not be started run here.
+    for (size_t t = started; t < n_threads; t++)
+        solve_blocks(&tasks[t]);
+    for (size_t t = 1; t < started; t++)
+        pthread_join(threads[t], NULL);
+
+    // Improving proposals: c' x - y_k < 0 (c' d < 0 for a ray).
+    size_t count = 0;
+    for (size_t k = 0; k < dec->n_blocks && count < max_cols; k++) {
+        Block *block = &dec->blocks[k];
+        if (block->status != OPTIMAL) {
+            dec->status = block->status;
+            return 0;
+        }
+
+        Fraction rc = block->rc;
+        if (!block->ray) rc = fraction_subtract(rc, duals[dec->n_linking + 1 + k]);
+        if (rc.num >= 0) continue;
+
+        if (add_proposal(dec, k)) {
+            fprintf(stderr, "Error - Not enough memory for the proposals.\n");
+            dec->status = INFEASIBLE;
+            return 0;
+        }
+        master_column(dec, &dec->props[dec->n_props - 1], &cols[count * (m + 1)]);
+        count++;
+    }
+
+    return count;
+}
+
+// Solve the master problem with the proposals generated so far and the
+// artificial columns at cost 'big_m' (1 in phase one). On OPTIMAL, writes in
+// '*artificial' if an artificial column is still positive and the solution
+// in 'x'. The master is rebuilt on every call, so it lives on malloc and is
+// released before returning: the proposals keep growing dec->arena meanwhile.
+static int solve_master(Decomposition *dec, Fraction big_m, char *artificial,
+        Fraction *x) {
+    const Tableau *orig = dec->orig;
+    size_t m = dec->n_linking + dec->n_blocks;
+    size_t n = m + dec->n_direct + dec->n_props;
+    size_t first_prop = m + dec->n_direct + 1;
+    size_t n_props = dec->n_props; // The master keeps these ones.
+
+    SolverParams params = *tableau_params(orig);
+    params.colgen_batch = dec->n_blocks ? (int) dec->n_blocks : 1;
+
+    int status = INFEASIBLE;
+    Tableau master;
+    master.n = n;
+    master.m = m;
+    master.arena = NULL;
+    master.params = &params;
+    master.stride = 0;
+    master.row_cap = 0;
+    master.data = malloc((m + 1) * (n + 1) * sizeof(Fraction));
+    size_t *basis = malloc(m * sizeof(size_t));
+    Fraction *col = malloc((m + 1) * sizeof(Fraction));
+    if (master.data == NULL || basis == NULL || col == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the master problem.\n");
+        goto TERMINATE;
+    }
+
+    for (size_t k = 0; k < (m + 1) * (n + 1); k++)
+        master.data[k] = fraction_create(0, 1);
+    Fraction *row0 = master.data;
+    size_t cols = n + 1;
+
+    // Rhs: linking rows (b >= 0 after the sign change), convexity rows.
+    for (size_t l = 0; l < dec->n_linking; l++) {
+        Fraction b = entry(orig, dec->linking[l], 0);
+        master.data[(l + 1) * cols] = dec->sign[l] < 0 ? fraction_chg_sign(b) : b;
+    }
+    for (size_t k = 0; k < dec->n_blocks; k++)
+        master.data[(dec->n_linking + 1 + k) * cols] = fraction_create(1, 1);
+
+    // Artificial columns.
+    for (size_t i = 1; i <= m; i++) {
+        row0[i] = big_m;
+        master.data[i * cols + i] = fraction_create(1, 1);
+    }
+
+    // Columns of the linking rows only.
+    for (size_t d = 0; d < dec->n_direct; d++) {
+        size_t j = m + 1 + d;
+        size_t c = dec->direct[d];
+        row0[j] = dec->phase_one ? fraction_create(0, 1) : entry(orig, 0, c);
+        for (size_t l = 0; l < dec->n_linking; l++) {
+            Fraction a = entry(orig, dec->linking[l], c);
+            master.data[(l + 1) * cols + j] = dec->sign[l] < 0 ? fraction_chg_sign(a) : a;
+        }
+    }
+
+    // Proposals of the previous solves.
+    for (size_t p = 0; p < n_props; p++) {
+        master_column(dec, &dec->props[p], col);
+        for (size_t i = 0; i <= m; i++)
+            master.data[i * cols + first_prop + p] = col[i];
+    }
+
+    ColGenStats cg;
+    status = column_generation(&master, basis, dw_pricing, dec, &cg);
+    if (dec->status != OPTIMAL) status = dec->status;
+    if (status != OPTIMAL) goto TERMINATE;
+
+    // Solution: the proposals combined by the master.
+    *artificial = 0;
+    for (size_t j = 0; j <= orig->n; j++)
+        x[j] = fraction_create(0, 1);
+    cols = tableau_stride(&master);
+    for (size_t i = 1; i <= m; i++) {
+        size_t var = basis[i - 1];
+        Fraction value = master.data[i * cols];
+        // M times the master entries may wrap the classic fractions.
+        if (value.den <= 0 || master.data[0].den <= 0) {
+            status = NUMERIC_OVERFLOW;
+            goto TERMINATE;
+        }
+        if (!value.num) continue;
+
+        if (var <= m) {
+            *artificial = 1;
+        } else if (var < first_prop) {
+            x[dec->direct[var - m - 1]] = value;
+        } else {
+            const Proposal *p = &dec->props[var - first_prop];
+            const Block *block = &dec->blocks[p->block];
+            for (size_t j = 1; j <= block->n; j++) {
+                if (!p->x[j].num) continue;
+                size_t c = block->cols[j - 1];
+                x[c] = fraction_add(x[c], fraction_multiply(value, p->x[j]));
+            }
+        }
+    }
+
+TERMINATE:
+    free(master.data);
+    free(basis);
+    free(col);
+
+    return status;
+}
+
+// Split the problem in the master (linking rows and columns of the linking
+// rows only) and the blocks. Returns 0 on success.
+static int build_blocks(Decomposition *dec, const int *row_block) {
+    const Tableau *orig = dec->orig;
+    Arena *arena = dec->arena;
+    size_t m = orig->m, n = orig->n;
+
+    size_t n_blocks = 0;
+    for (size_t i = 0; i < m; i++) {
+        if (row_block[i] == LINKING_ROW) dec->n_linking++;
+        else if (row_block[i] < 0) return 1;
+        else if ((size_t) row_block[i] + 1 > n_blocks) n_blocks = row_block[i] + 1;
+    }
+
+    // Block of each column: the one of its rows, they must agree.
+    int *col_block = arena_alloc(arena, (n + 1) * sizeof(int));
+    dec->linking = arena_alloc(arena, (dec->n_linking + 1) * sizeof(size_t));
+    dec->sign = arena_alloc(arena, (dec->n_linking + 1) * sizeof(int));
+    dec->direct = arena_alloc(arena, (n + 1) * sizeof(size_t));
+    dec->blocks = arena_alloc(arena, (n_blocks + 1) * sizeof(Block));
+    if (!col_block || !dec->linking || !dec->sign || !dec->direct || !dec->blocks)
+        return 1;
+
+    size_t l = 0;
+    for (size_t i = 1; i <= m; i++) {
+        if (row_block[i - 1] != LINKING_ROW) continue;
+        dec->linking[l] = i;
+        dec->sign[l] = entry(orig, i, 0).num < 0 ? -1 : 1;
+        l++;
+    }
+
+    for (size_t j = 1; j <= n; j++) {
+        col_block[j] = LINKING_ROW;
+        for (size_t i = 1; i <= m; i++) {
+            int b = row_block[i - 1];
+            if (b == LINKING_ROW || !entry(orig, i, j).num) continue;
+            if (col_block[j] != LINKING_ROW && col_block[j] != b) {
+                fprintf(stderr, "Error - Column %lu is in the blocks %d and %d.\n",
+                        j, col_block[j], b);
+                return 1;
+            }
+            col_block[j] = b;
+        }
+        if (col_block[j] == LINKING_ROW) dec->direct[dec->n_direct++] = j;
+    }
+
+    dec->n_blocks = n_blocks;
+    memset(dec->blocks, 0, n_blocks * sizeof(Block));
+    for (size_t k = 0; k < n_blocks; k++) {
+        Block *block = &dec->blocks[k];
+        for (size_t i = 0; i < m; i++)
+            if (row_block[i] == (int) k) block->m++;
+        for (size_t j = 1; j <= n; j++)
+            if (col_block[j] == (int) k) block->n++;
+        if (!block->m || !block->n) {
+            fprintf(stderr, "Error - Block %lu is empty.\n", k);
+            return 1;
+        }
+
+        // The subproblems are solved on other threads: malloc, not the arena.
+        block->rows = arena_alloc(arena, block->m * sizeof(size_t));
+        block->cols = arena_alloc(arena, block->n * sizeof(size_t));
+        block->cost = arena_alloc(arena, (block->n + 1) * sizeof(Fraction));
+        block->point = arena_alloc(arena, (block->n + 1) * sizeof(Fraction));
+        block->basis = malloc(block->m * sizeof(size_t));
+        block->tab.data = malloc((block->m + 1) * (block->n + 1) * sizeof(Fraction));
+        if (!block->rows || !block->cols || !block->cost || !block->point
+                || !block->basis || !block->tab.data)
+            return 1;
+
+        size_t r = 0, c = 0;
+        for (size_t i = 1; i <= m; i++)
+            if (row_block[i - 1] == (int) k) block->rows[r++] = i;
+        for (size_t j = 1; j <= n; j++)
+            if (col_block[j] == (int) k) block->cols[c++] = j;
+
+        Tableau *tab = &block->tab;
+        tab->m = block->m;
+        tab->n = block->n;
+        tab->arena = NULL;
+        tab->params = &dec->block_params;
+        tab->stride = 0;
+        tab->row_cap = 0;
+        for (size_t i = 1; i <= block->m; i++) {
+            Fraction *row = &tab->data[i * (block->n + 1)];
+            row[0] = entry(orig, block->rows[i - 1], 0);
+            for (size_t j = 1; j <= block->n; j++)
+                row[j] = entry(orig, block->rows[i - 1], block->cols[j - 1]);
+        }
+    }
+
+    return 0;
+}
+
+int dantzig_wolfe(const Tableau *tab, const int *row_block, Fraction *x,
+        DecompositionStats *stats) {
+    const SolverParams *params = tableau_params(tab);
+    int status = INFEASIBLE;
+
+    Decomposition dec;
+    memset(&dec, 0, sizeof(Decomposition));
+    dec.orig = tab;
+    dec.arena = tab->arena;
+    dec.status = OPTIMAL;
+    dec.block_params = *params;
+    dec.block_params.verbose = 0;
+    dec.block_params.progress = NULL;
+
+    memset(stats, 0, sizeof(DecompositionStats));
+    solve_begin(params);
+    // The subproblems count against this solve on every thread.
+    dec.block_params.scope = solve_scope();
+
+    int *detected = NULL;
+    if (row_block == NULL) {
+        detected = arena_alloc(tab->arena, (tab->m + 1) * sizeof(int));
+        if (detected == NULL) goto TERMINATE;
+        decomposition_detect(tab, detected);
+        row_block = detected;
+    }
+    if (build_blocks(&dec, row_block)) {
+        fprintf(stderr, "Error - Bad block structure.\n");
+        goto TERMINATE;
+    }
+    stats->blocks = dec.n_blocks;
+    stats->linking = dec.n_linking;
+    solver_log(params, "%lu blocks, %lu linking rows, %lu linking columns.\n",
+            dec.n_blocks, dec.n_linking, dec.n_direct);
+
+    // Big-M master: M = 100 (1 + max |c_j|), raised if an artificial column
+    // is still positive while the phase one master proves feasibility. M
+    // must fit the classic fractions: past INT_MAX the master cannot be
+    // solved (NUMERIC_OVERFLOW).
+    long long max_cost = 0;
+    for (size_t j = 1; j <= tab->n; j++) {
+        Fraction c = entry(tab, 0, j);
+        long long a = llabs((long long) c.num / c.den) + 1;
+        if (a > max_cost) max_cost = a;
+    }
+    if (ESCALATION_FACTOR * (1 + max_cost) > INT_MAX) {
+        fprintf(stderr, "Error - The costs are too large for the big-M master.\n");
+        status = NUMERIC_OVERFLOW;
+        goto TERMINATE;
+    }
+    Fraction big_m = fraction_create((int) (ESCALATION_FACTOR * (1 + max_cost)), 1);
+
+    char artificial = 0;
+    status = solve_master(&dec, big_m, &artificial, x);
+    for (int esc = 0; status == OPTIMAL && artificial; esc++) {
+        if (esc == 0) {
+            solver_log(params, "\n### Phase one master ###\n");
+            dec.phase_one = 1;
+            Fraction one = fraction_create(1, 1);
+            status = solve_master(&dec, one, &artificial, x);
+            dec.phase_one = 0;
+            if (status != OPTIMAL) break;
+            if (artificial) {
+                solver_log(params, "No solution - Problem is infeasible.\n");
+                status = INFEASIBLE;
+                break;
+            }
+        }
+        if (esc == MAX_ESCALATIONS) {
+            fprintf(stderr, "Error - The artificial columns cannot be driven out.\n");
+            status = INFEASIBLE;
+            break;
+        }
+        if ((long long) big_m.num * ESCALATION_FACTOR > INT_MAX) {
+            fprintf(stderr, "Error - M of the master overflows.\n");
+            status = NUMERIC_OVERFLOW;
+            break;
+        }
+        big_m = fraction_create(big_m.num * ESCALATION_FACTOR, 1);
+        solver_log(params, "\n### Master with M = %d ###\n", big_m.num);
+        status = solve_master(&dec, big_m, &artificial, x);
+    }
+
+    if (status == OPTIMAL && !solution_valid(tab, x)) {
+        fprintf(stderr, "Error - The master overflowed, its solution is not valid.\n");
+        status = NUMERIC_OVERFLOW;
+    }
+    if (status == OPTIMAL) {
+        stats->cost = fraction_create(0, 1);
+        for (size_t j = 1; j <= tab->n; j++)
+            if (x[j].num)
+                stats->cost = fraction_add(stats->cost, fraction_multiply(entry(tab, 0, j), x[j]));
+    }
+
+TERMINATE:
+    stats->rounds = dec.rounds;
+    stats->proposals = dec.n_props;
+    for (size_t k = 0; dec.blocks && k < dec.n_blocks; k++) {
+        free(dec.blocks[k].basis);
+        free(dec.blocks[k].tab.data);
+    }
+    solve_end();
+
+    return status;
+}
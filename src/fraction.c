@@ -2,88 +2,136 @@
 #include <stdio.h>  // For fprintf, printf
 #include <stdlib.h> // For abs
 
+// Greatest Common Divisor of two 64 bits values (binary / Stein algorithm).
+// Handles negative numbers by using their absolute values.
+long long fraction_gcd64(long long a, long long b) {
+    unsigned long long u = a < 0 ? -(unsigned long long) a : (unsigned long long) a;
+    unsigned long long v = b < 0 ? -(unsigned long long) b : (unsigned long long) b;
+
+    if (u == 0) return (long long) v;
+    if (v == 0) return (long long) u;
+
+    // Common power of two.
+    int shift = __builtin_ctzll(u | v);
+    u >>= __builtin_ctzll(u);
+
+    do {
+        v >>= __builtin_ctzll(v);
+        if (u > v) {
+            unsigned long long tmp = v;
+            v = u;
+            u = tmp;
+        }
+        v -= u;
+    } while (v != 0);
+
+    return (long long) (u << shift);
+}
+
 // Helper function to calculate the Greatest Common Divisor (GCD)
-// Uses the Euclidean algorithm. Handles negative numbers by using abs().
+// Uses the binary algorithm. Handles negative numbers by using abs().
 int gcd(int a, int b) {
-    // Use absolute values for GCD calculation
-    a = abs(a);
-    b = abs(b);
-
-    while (b != 0) {
-        int temp = b;
-        b = a % b;
-        a = temp;
+    return (int) fraction_gcd64(a, b);
+}
+
+// Build the simplified fraction num/den, computed on 64 bits.
+// The result must fit in an int (NOT checked).
+static inline Fraction fraction_from64(long long num, long long den) {
+    Fraction f;
+
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+
+    if (num == 0) {
+        f.num = 0;
+        f.den = 1;
+    } else if (den == 1) {
+        f.num = (int) num;
+        f.den = 1;
+    } else {
+        long long g = fraction_gcd64(num, den);
+        f.num = (int) (num / g);
+        f.den = (int) (den / g);
     }
-    return a;
+
+    return f;
 }
 
 // Function to create/initialize and simplify a fraction
 Fraction fraction_create(int num, int den) {
     Fraction f;
-    f.num = num;
-    f.den = den;
+
+    // Integers do not need any simplification.
+    if (den == 1) {
+        f.num = num;
+        f.den = 1;
+        return f;
+    }
 
     // Basic check for division by zero when creating
-    if (f.den == 0) {
+    if (den == 0) {
         fprintf(stderr, "Error (fraction_create): Denominator cannot be zero. Setting to 0/1.\n");
         f.num = 0;
         f.den = 1; // Represent as 0/1 in case of error
         return f; // Return immediately after handling error
     }
 
-    // Handle the sign: Ensure the.den is positive
-    if (f.den < 0) {
-        f.num = -f.num;
-        f.den = -f.den;
-    }
-
-    // Simplify the fraction using GCD
-    if (f.num != 0) { // No need to simplify if.num is 0
-        int common_divisor = gcd(f.num, f.den);
-        f.num /= common_divisor;
-        f.den /= common_divisor;
-    } else {
-        // If.num is 0, simplify to 0/1
-        f.den = 1;
-    }
-
-    return f;
+    return fraction_from64(num, den);
 }
 
 // Addition: (a/b) + (c/d) = (ad + bc) / bd
-// Uses only int. Integer overflow is NOT checked.
-// The result is created and simplified by fraction_create.
+// Intermediate values are computed on 64 bits. The result is NOT checked
+// for int overflow.
 Fraction fraction_add(Fraction f1, Fraction f2) {
-    int result_num = (f1.num * f2.den) + (f2.num * f1.den);
-    int result_den = f1.den * f2.den;
-    // Note: Intermediate multiplication might overflow if inputs are large.
-    return fraction_create(result_num, result_den);
+    if (f1.num == 0) return f2;
+    if (f2.num == 0) return f1;
+
+    // Same denominator: (a + c) / b.
+    if (f1.den == f2.den) {
+        long long num = (long long) f1.num + f2.num;
+        if (f1.den == 1) return (Fraction) {(int) num, 1};
+        return fraction_from64(num, f1.den);
+    }
+
+    long long num = (long long) f1.num * f2.den + (long long) f2.num * f1.den;
+    long long den = (long long) f1.den * f2.den;
+    return fraction_from64(num, den);
 }
 
 // Subtraction: (a/b) - (c/d) = (ad - bc) / bd
-// Uses only int. Integer overflow is NOT checked.
-// The result is created and simplified by fraction_create.
+// Intermediate values are computed on 64 bits. The result is NOT checked
+// for int overflow.
 Fraction fraction_subtract(Fraction f1, Fraction f2) {
-    int result_num = (f1.num * f2.den) - (f2.num * f1.den);
-    int result_den = f1.den * f2.den;
-    // Note: Intermediate multiplication/subtraction might overflow if inputs are large.
-    return fraction_create(result_num, result_den);
+    return fraction_add(f1, fraction_chg_sign(f2));
 }
 
 // Multiplication: (a/b) * (c/d) = ac / bd
-// Uses only int. Integer overflow is NOT checked.
-// The result is created and simplified by fraction_create.
+// Intermediate values are computed on 64 bits. The result is NOT checked
+// for int overflow.
 Fraction fraction_multiply(Fraction f1, Fraction f2) {
-    int result_num = f1.num * f2.num;
-    int result_den = f1.den * f2.den;
-    // Note: Intermediate multiplication might overflow if inputs are large.
-    return fraction_create(result_num, result_den);
+    if (f1.num == 0 || f2.num == 0) return (Fraction) {0, 1};
+
+    // Multiplication by +-1.
+    if (f1.den == 1 && (f1.num == 1 || f1.num == -1))
+        return f1.num == 1 ? f2 : fraction_chg_sign(f2);
+    if (f2.den == 1 && (f2.num == 1 || f2.num == -1))
+        return f2.num == 1 ? f1 : fraction_chg_sign(f1);
+
+    // Integers.
+    if (f1.den == 1 && f2.den == 1)
+        return (Fraction) {f1.num * f2.num, 1};
+
+    long long num = (long long) f1.num * f2.num;
+    long long den = (long long) f1.den * f2.den;
+    return fraction_from64(num, den);
 }
 
 // Division: (a/b) / (c/d) = ad / bc
 // Handles division by zero fraction (c/d where c is 0).
-// Uses only int. Integer overflow is NOT checked.
-// The result is created and simplified by fraction_create.
+// Intermediate values are computed on 64 bits. The result is NOT checked
+// for int overflow.
 Fraction fraction_divide(Fraction f1, Fraction f2) {
     // Basic check for division by zero fraction (c/d where c is 0)
     if (f2.num == 0) {
@@ -92,30 +140,33 @@ Fraction fraction_divide(Fraction f1, Fraction f2) {
         return fraction_create(0, 1);
     }
 
-    int result_num = f1.num * f2.den;
-    int result_den = f1.den * f2.num;
-    // Note: Intermediate multiplication might overflow if inputs are large.
+    // Division by the reciprocal (already simplified, sign on numerator).
+    Fraction inv;
+    if (f2.num < 0) {
+        inv.num = -f2.den;
+        inv.den = -f2.num;
+    } else {
+        inv.num = f2.den;
+        inv.den = f2.num;
+    }
 
-    return fraction_create(result_num, result_den);
+    return fraction_multiply(f1, inv);
 }
 
-// Absolute value: |(a/b)| = |a| / |b|.
-// The result is created and simplified by fraction_create.
+// Absolute value: |(a/b)| = |a| / b (b is always positive).
 Fraction fraction_abs(Fraction f) {
-    int num = f.num, den = f.den;
-    if (num < 0) {
-        num *= -1;
-    } else if (den < 0) {
-        den *= -1;
-    }
-
-    return fraction_create(num, den);
+    if (f.num < 0) f.num = -f.num;
+    return f;
 }
 
-// Change sign: -(a/b) = -1/1 * (a/b)
-// The result is created and simplified by fraction_create.
+// Change sign: -(a/b) = (-a)/b.
 Fraction fraction_chg_sign(Fraction f) {
-    return fraction_multiply(f, fraction_create(-1, 1));
+    f.num = -f.num;
+    return f;
+}
+
+double fraction_to_double(Fraction f) {
+    return (double) f.num / f.den;
 }
 
 // Floor function.
@@ -135,9 +186,9 @@ Fraction fraction_floor(Fraction f) {
 // Comparison functions (New implementations)
 // Use cross-multiplication: compare f1.num * f2.den vs f2.num * f1.den
 // Assumes denominators are positive due to fraction_create.
-// Integer overflow in intermediate products is NOT checked.
+// Products are computed on 64 bits, so they cannot overflow.
 int fraction_equal(Fraction f1, Fraction f2) {
-    return (f1.num * f2.den) == (f2.num * f1.den);
+    return ((long long) f1.num * f2.den) == ((long long) f2.num * f1.den);
 }
 
 int fraction_not_equal(Fraction f1, Fraction f2) {
@@ -145,19 +196,118 @@ int fraction_not_equal(Fraction f1, Fraction f2) {
 }
 
 int fraction_less(Fraction f1, Fraction f2) {
-    return (f1.num * f2.den) < (f2.num * f1.den);
+    return ((long long) f1.num * f2.den) < ((long long) f2.num * f1.den);
 }
 
 int fraction_less_equal(Fraction f1, Fraction f2) {
-    return (f1.num * f2.den) <= (f2.num * f1.den);
+    return ((long long) f1.num * f2.den) <= ((long long) f2.num * f1.den);
 }
 
 int fraction_greater(Fraction f1, Fraction f2) {
-    return (f1.num * f2.den) > (f2.num * f1.den);
+    return ((long long) f1.num * f2.den) > ((long long) f2.num * f1.den);
 }
 
 int fraction_greater_equal(Fraction f1, Fraction f2) {
-    return (f1.num * f2.den) >= (f2.num * f1.den);
+    return ((long long) f1.num * f2.den) >= ((long long) f2.num * f1.den);
+}
+
+// Batched operations.
+
+void fraction_row_scale(Fraction *row, Fraction k, size_t len) {
+    if (k.den == 1 && k.num == 1) return;
+
+    // Integer row and integer factor: no simplification at all.
+    for (size_t j = 0; j < len; j++) {
+        if (row[j].num == 0) continue;
+        if (row[j].den == 1 && k.den == 1) {
+            row[j].num *= k.num;
+        } else {
+            row[j] = fraction_from64((long long) row[j].num * k.num,
+                    (long long) row[j].den * k.den);
+        }
+    }
+}
+
+void fraction_row_fms(Fraction *dst, const Fraction *src, Fraction k, size_t len) {
+    if (k.num == 0) return;
+
+    for (size_t j = 0; j < len; j++) {
+        Fraction c = src[j];
+        if (c.num == 0) continue; // dst[j] is unchanged.
+
+        Fraction a = dst[j];
+
+        // All integers: a - k * c.
+        if ((a.den | c.den | k.den) == 1) {
+            dst[j].num = a.num - k.num * c.num;
+            continue;
+        }
+
+        // p = k * c, simplified so that the subtraction fits in 64 bits.
+        Fraction p = fraction_from64((long long) k.num * c.num,
+                (long long) k.den * c.den);
+
+        if (a.num == 0) {
+            dst[j] = fraction_chg_sign(p);
+        } else if (a.den == p.den) {
+            dst[j] = fraction_from64((long long) a.num - p.num, a.den);
+        } else {
+            dst[j] = fraction_from64(
+                    (long long) a.num * p.den - (long long) p.num * a.den,
+                    (long long) a.den * p.den);
+        }
+    }
+}
+
+size_t fraction_min_ratio(const Fraction *num, const Fraction *den,
+        size_t stride, size_t len, int sign, const size_t *key) {
+    size_t best = len;
+    long long best_n = 0, best_d = 1; // Best ratio, not simplified.
+
+    for (size_t i = 0; i < len; i++) {
+        Fraction d = den[i * stride];
+        if ((sign > 0 && d.num <= 0) || (sign < 0 && d.num >= 0)) continue;
+
+        // |n / d| = (|n.num| * d.den) / (n.den * |d.num|).
+        Fraction n = num[i * stride];
+        long long rn = (long long) (n.num < 0 ? -n.num : n.num) * d.den;
+        long long rd = (long long) n.den * (d.num < 0 ? -d.num : d.num);
+
+        if (best == len) {
+            best = i;
+            best_n = rn;
+            best_d = rd;
+            continue;
+        }
+
+        __int128 lhs = (__int128) rn * best_d;
+        __int128 rhs = (__int128) best_n * rd;
+        if (lhs < rhs || (lhs == rhs && key && key[i] < key[best])) {
+            best = i;
+            best_n = rn;
+            best_d = rd;
+        }
+    }
+
+    return best;
+}
+
+// Parse strings like "3", "-7/2".
+int fraction_parse(const char *str, Fraction *f) {
+    char *end = NULL;
+    long num = strtol(str, &end, 10);
+    long den = 1;
+
+    if (end == str) return 1;
+    if (*end == '/') {
+        const char *den_str = end + 1;
+        den = strtol(den_str, &end, 10);
+        if (end == den_str || den == 0) return 1;
+    }
+    if (*end != '\0') return 1;
+
+    *f = fraction_create((int) num, (int) den);
+    return 0;
 }
 
 // Function to print a fraction
@@ -0,0 +1,501 @@
+#include "../include/heuristics.h"
+#include "../include/arena.h"
+#include "../include/branch_bound.h"
+#include "../include/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Max LPs solved by a feasibility pump.
+#define PUMP_MAX_ROUNDS 50
+
+// Variables moved when the pump cycles on the same rounding.
+#define PUMP_FLIPS 10
+
+// RINS runs only if the LP vertex and the incumbent agree on at least this
+// share of the variables: a larger neighborhood is a problem as hard as the
+// original one.
+#define RINS_MIN_FIXED 0.3
+
+const char *const heuristic_names[N_HEURISTICS] = {
+    "rounding", "diving", "pump", "rins"
+};
+
+// Structure of the original problem that the heuristics round and complete
+// solutions with, and their buffers.
+typedef struct {
+    const OriginalProblem *orig;
+    Incumbent *inc;
+    size_t *slack;       // slack[i]: column of row i only (0 = none), whose
+                         // value follows from the others.
+    char *is_slack;      // is_slack[j] is set if x_j is the slack of a row.
+    size_t *down_locks;  // Rows that decreasing x_j may violate...
+    size_t *up_locks;    // ... and rows that increasing it may violate.
+    Fraction *x;         // Candidate solution.
+    Fraction *lp;        // Vertex of the LP.
+    Fraction *prev;      // Previous rounding of the pump.
+    char *mark;          // Flags of the variables, scratch of a heuristic.
+    SolverParams params; // Parameters of the sub-solves, with the deadline of
+                         // the running heuristic.
+    Arena arena;
+} Context;
+
+int heuristics_parse(const char *list, unsigned int *mask) {
+    return parse_name_list(list, heuristic_names, N_HEURISTICS, mask);
+}
+
+void incumbent_init(Incumbent *inc) {
+    memset(inc, 0, sizeof(Incumbent));
+    inc->cost = fraction_create(0, 1);
+    inc->bound = fraction_create(0, 1);
+    inc->gap = 1;
+    inc->source = N_HEURISTICS;
+}
+
+void incumbent_free(Incumbent *inc) {
+    free(inc->x);
+    inc->x = NULL;
+    inc->found = 0;
+}
+
+static void update_gap(Incumbent *inc) {
+    if (!inc->found || !inc->has_bound) {
+        inc->gap = 1;
+        return;
+    }
+    double cost = fraction_to_double(inc->cost);
+    double scale = cost < 0 ? -cost : cost;
+    inc->gap = (cost - fraction_to_double(inc->bound)) / (scale > 1 ? scale : 1);
+    if (inc->gap < 0) inc->gap = 0;
+}
+
+int incumbent_offer(Incumbent *inc, const OriginalProblem *orig,
+        const Fraction *x, int source) {
+    size_t n = orig->n;
+    for (size_t j = 1; j <= n; j++)
+        if (x[j].den != 1 || x[j].num < 0) return 0;
+
+    // a x = b for every row, exactly.
+    for (size_t i = 0; i < orig->m; i++) {
+        const Fraction *a = &orig->rows[i * (n + 1)];
+        Fraction lhs = fraction_create(0, 1);
+        for (size_t j = 1; j <= n; j++)
+            if (a[j].num != 0 && x[j].num != 0)
+                lhs = fraction_add(lhs, fraction_multiply(a[j], x[j]));
+        if (!fraction_equal(lhs, a[0])) return 0;
+    }
+
+    Fraction cost = fraction_chg_sign(orig->cost[0]);
+    for (size_t j = 1; j <= n; j++)
+        if (orig->cost[j].num != 0 && x[j].num != 0)
+            cost = fraction_add(cost, fraction_multiply(orig->cost[j], x[j]));
+    if (cost.den <= 0) return 0; // Overflow of the classic fractions.
+    if (inc->found && !fraction_less(cost, inc->cost)) return 0;
+
+    if (inc->x == NULL || inc->n != n) {
+        free(inc->x);
+        inc->x = malloc((n + 1) * sizeof(Fraction));
+        if (inc->x == NULL) {
+            fprintf(stderr, "Error - Not enough memory for the incumbent.\n");
+            inc->found = 0;
+            return 0;
+        }
+    }
+    memcpy(inc->x, x, (n + 1) * sizeof(Fraction));
+    inc->x[0] = fraction_create(0, 1);
+    inc->n = n;
+    inc->found = 1;
+    inc->cost = cost;
+    inc->source = source;
+    inc->seconds = solve_elapsed();
+    update_gap(inc);
+    return 1;
+}
+
+void incumbent_bound(Incumbent *inc, const OriginalProblem *orig, Fraction bound) {
+    // With integer c, c x - cost[0] >= ceil(bound + cost[0]) - cost[0].
+    char integer = orig != NULL;
+    for (size_t j = 1; integer && j <= orig->n; j++) integer = orig->cost[j].den == 1;
+    if (integer) {
+        Fraction t = fraction_add(bound, orig->cost[0]);
+        Fraction ceil = fraction_chg_sign(fraction_floor(fraction_chg_sign(t)));
+        Fraction rounded = fraction_subtract(ceil, orig->cost[0]);
+        if (t.den > 0 && rounded.den > 0) bound = rounded;
+    }
+    inc->bound = bound;
+    inc->has_bound = 1;
+    update_gap(inc);
+}
+
+static int context_init(Context *c, const OriginalProblem *orig, Incumbent *inc) {
+    size_t n = orig->n;
+    size_t m = orig->m;
+    memset(c, 0, sizeof(Context));
+    c->orig = orig;
+    c->inc = inc;
+    arena_init(&c->arena, 0);
+
+    c->slack = arena_alloc(&c->arena, (m + 1) * sizeof(size_t));
+    c->is_slack = arena_alloc(&c->arena, n + 1);
+    c->down_locks = arena_alloc(&c->arena, (n + 1) * sizeof(size_t));
+    c->up_locks = arena_alloc(&c->arena, (n + 1) * sizeof(size_t));
+    c->x = arena_alloc(&c->arena, (n + 1) * sizeof(Fraction));
+    c->lp = arena_alloc(&c->arena, (n + 1) * sizeof(Fraction));
+    c->prev = arena_alloc(&c->arena, (n + 1) * sizeof(Fraction));
+    c->mark = arena_alloc(&c->arena, n + 1);
+    if (c->slack == NULL || c->is_slack == NULL || c->down_locks == NULL
+            || c->up_locks == NULL || c->x == NULL || c->lp == NULL
+            || c->prev == NULL || c->mark == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the heuristics.\n");
+        arena_destroy(&c->arena);
+        return 1;
+    }
+
+    // The slack of a row is a column with a single nonzero in it, one with
+    // no cost if there is a choice.
+    memset(c->slack, 0, (m + 1) * sizeof(size_t));
+    memset(c->is_slack, 0, n + 1);
+    for (size_t j = 1; j <= n; j++) {
+        size_t row = m;
+        size_t count = 0;
+        for (size_t i = 0; i < m && count < 2; i++) {
+            if (orig->rows[i * (n + 1) + j].num == 0) continue;
+            row = i;
+            count++;
+        }
+        if (count != 1) continue;
+        size_t s = c->slack[row];
+        if (s == 0 || (orig->cost[s].num != 0 && orig->cost[j].num == 0))
+            c->slack[row] = j;
+    }
+    for (size_t i = 0; i < m; i++) c->is_slack[c->slack[i]] = 1;
+    c->is_slack[0] = 0;
+
+    // Moving x_j changes the slack of its rows: the directions that make one
+    // negative are locked. Rows without slack lock both.
+    memset(c->down_locks, 0, (n + 1) * sizeof(size_t));
+    memset(c->up_locks, 0, (n + 1) * sizeof(size_t));
+    for (size_t i = 0; i < m; i++) {
+        const Fraction *a = &orig->rows[i * (n + 1)];
+        size_t s = c->slack[i];
+        for (size_t j = 1; j <= n; j++) {
+            if (a[j].num == 0 || j == s) continue;
+            if (s == 0 || (a[j].num > 0) == (a[s].num > 0)) c->up_locks[j]++;
+            if (s == 0 || (a[j].num > 0) != (a[s].num > 0)) c->down_locks[j]++;
+        }
+    }
+    return 0;
+}
+
+// Closest integer to 'f'.
+static Fraction nearest(Fraction f) {
+    return fraction_floor(fraction_add(f, fraction_create(1, 2)));
+}
+
+// Set the slacks of x from the other variables. Returns 1 if x is a
+// solution of the original problem.
+static int complete(const Context *c, Fraction *x) {
+    const OriginalProblem *orig = c->orig;
+    size_t n = orig->n;
+    for (size_t j = 1; j <= n; j++)
+        if (!c->is_slack[j] && (x[j].den != 1 || x[j].num < 0)) return 0;
+
+    for (size_t i = 0; i < orig->m; i++) {
+        const Fraction *a = &orig->rows[i * (n + 1)];
+        size_t s = c->slack[i];
+        Fraction r = a[0];
+        for (size_t j = 1; j <= n; j++)
+            if (j != s && a[j].num != 0 && x[j].num != 0)
+                r = fraction_subtract(r, fraction_multiply(a[j], x[j]));
+        if (s == 0) {
+            if (r.num != 0 || r.den <= 0) return 0;
+            continue;
+        }
+        x[s] = fraction_divide(r, a[s]);
+        if (x[s].den != 1 || x[s].num < 0) return 0;
+    }
+    return 1;
+}
+
+// Round the fractional variables of 'lp' in c->x, in a direction without
+// locks if there is one. Returns 1 if the rounding is a solution.
+static int round_vertex(Context *c, const Fraction *lp) {
+    for (size_t j = 1; j <= c->orig->n; j++) {
+        Fraction v = lp[j];
+        if (c->is_slack[j] || v.den == 1) {
+            c->x[j] = v;
+            continue;
+        }
+        Fraction fl = fraction_floor(v);
+        if (!c->down_locks[j]) c->x[j] = fl;
+        else if (!c->up_locks[j]) c->x[j] = fraction_create(fl.num + 1, 1);
+        else c->x[j] = nearest(v);
+    }
+    return complete(c, c->x);
+}
+
+// Copy of the tableau that the heuristic may change, from c->arena.
+static int copy_tableau(Context *c, const Tableau *tab, const size_t *basis,
+        Tableau *work, size_t **work_basis) {
+    size_t cols = tableau_stride(tab);
+    work->n = tab->n;
+    work->m = tab->m;
+    work->arena = &c->arena;
+    work->stride = 0;
+    work->row_cap = 0;
+    work->params = &c->params;
+    work->data = arena_alloc(&c->arena, (tab->m + 1) * (tab->n + 1) * sizeof(Fraction));
+    *work_basis = arena_alloc(&c->arena, tab->m * sizeof(size_t));
+    if (work->data == NULL || *work_basis == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the heuristic tableau.\n");
+        return 1;
+    }
+    for (size_t i = 0; i <= tab->m; i++)
+        memcpy(&work->data[i * (tab->n + 1)], &tab->data[i * cols],
+                (tab->n + 1) * sizeof(Fraction));
+    memcpy(*work_basis, basis, tab->m * sizeof(size_t));
+    return 0;
+}
+
+static int rounding(Context *c, const Tableau *tab, const size_t *basis) {
+    if (tableau_vertex(tab, basis, c->orig->n, c->lp)) return 0;
+    return round_vertex(c, c->lp) && incumbent_offer(c->inc, c->orig, c->x, HEUR_ROUNDING);
+}
+
+static int diving(Context *c, const Tableau *tab, const size_t *basis) {
+    Tableau work;
+    size_t *work_basis;
+    if (copy_tableau(c, tab, basis, &work, &work_basis)) return 0;
+
+    size_t n = c->orig->n;
+    int improved = 0;
+    int status;
+    while (!solve_stop(&c->params, &status) && !tableau_vertex(&work, work_basis, n, c->lp)) {
+        // The dive cannot beat the incumbent anymore.
+        if (c->inc->found && !fraction_less(fraction_chg_sign(work.data[0]), c->inc->cost))
+            break;
+
+        // Every vertex of the dive is rounded: the last one is integer.
+        if (round_vertex(c, c->lp) && incumbent_offer(c->inc, c->orig, c->x, HEUR_DIVING))
+            improved = 1;
+
+        // Least fractional variable, rounded to the closest integer.
+        size_t cols = tableau_stride(&work);
+        size_t row = 0;
+        double best = 1;
+        for (size_t i = 1; i <= work.m; i++) {
+            Fraction v = work.data[i * cols];
+            if (work_basis[i - 1] > n || v.den == 1) continue;
+            double frac = fraction_to_double(v) - fraction_floor(v).num;
+            double dist = frac < 0.5 ? frac : 1 - frac;
+            if (dist < best) {
+                best = dist;
+                row = i;
+            }
+        }
+        if (row == 0) break;
+
+        // x_var <= floor as x_var + s = floor, or x_var >= floor + 1 as
+        // -x_var + s = -floor - 1, with x_var written through its row.
+        size_t var = work_basis[row - 1];
+        Fraction v = work.data[row * cols];
+        Fraction fl = fraction_floor(v);
+        int upper = fraction_less(fraction_subtract(v, fl), fraction_create(1, 2));
+        size_t old_n = work.n;
+        size_t old_m = work.m;
+        if (append_rows(&work, &work_basis, 1)) break;
+
+        cols = tableau_stride(&work);
+        const Fraction *src = &work.data[row * cols];
+        Fraction *dst = &work.data[(old_m + 1) * cols];
+        for (size_t j = 0; j <= old_n; j++)
+            dst[j] = upper ? fraction_chg_sign(src[j]) : src[j];
+        dst[0] = upper ? fraction_add(dst[0], fl)
+                       : fraction_subtract(dst[0], fraction_create(fl.num + 1, 1));
+        dst[var] = fraction_create(0, 1);
+
+        if (dual_simplex(&work, work_basis) != OPTIMAL) break;
+    }
+    return improved;
+}
+
+// Row 0 of 'work' minimizes the distance from the rounding c->x: x_j for
+// x~_j = 0, and the linearization of |x_j - x~_j| at the vertex 'lp'
+// otherwise. The row is then priced out w.r.t. the basis.
+static void distance_objective(Context *c, Tableau *work, const size_t *basis) {
+    size_t cols = tableau_stride(work);
+    Fraction *row0 = work->data;
+    for (size_t j = 0; j <= work->n; j++) row0[j] = fraction_create(0, 1);
+    for (size_t j = 1; j <= c->orig->n; j++) {
+        if (c->is_slack[j]) continue;
+        if (c->x[j].num == 0 || fraction_greater(c->lp[j], c->x[j]))
+            row0[j] = fraction_create(1, 1);
+        else if (fraction_less(c->lp[j], c->x[j]))
+            row0[j] = fraction_create(-1, 1);
+    }
+    for (size_t i = 1; i <= work->m; i++) {
+        Fraction k = row0[basis[i - 1]];
+        if (k.num != 0) fraction_row_fms(row0, &work->data[i * cols], k, work->n + 1);
+    }
+}
+
+// Move the PUMP_FLIPS variables of the rounding farthest from the vertex
+// towards it. Returns the # of variables moved.
+static size_t flip(Context *c) {
+    size_t n = c->orig->n;
+    memset(c->mark, 0, n + 1);
+    size_t moved = 0;
+    for (; moved < PUMP_FLIPS; moved++) {
+        size_t best = 0;
+        double best_dist = 0;
+        for (size_t j = 1; j <= n; j++) {
+            if (c->is_slack[j] || c->mark[j]) continue;
+            double dist = fraction_to_double(c->lp[j]) - fraction_to_double(c->x[j]);
+            if (dist < 0) dist = -dist;
+            if (dist > best_dist) {
+                best_dist = dist;
+                best = j;
+            }
+        }
+        if (best == 0) break;
+        c->mark[best] = 1;
+        int up = fraction_greater(c->lp[best], c->x[best]);
+        c->x[best] = fraction_create(c->x[best].num + (up ? 1 : -1), 1);
+    }
+    return moved;
+}
+
+static int pump(Context *c, const Tableau *tab, const size_t *basis) {
+    Tableau work;
+    size_t *work_basis;
+    if (copy_tableau(c, tab, basis, &work, &work_basis)) return 0;
+
+    size_t n = c->orig->n;
+    int status;
+    for (int round = 0; round < PUMP_MAX_ROUNDS; round++) {
+        if (solve_stop(&c->params, &status) || tableau_vertex(&work, work_basis, n, c->lp)) break;
+
+        for (size_t j = 1; j <= n; j++)
+            c->x[j] = c->is_slack[j] ? fraction_create(0, 1) : nearest(c->lp[j]);
+        if (complete(c, c->x))
+            return incumbent_offer(c->inc, c->orig, c->x, HEUR_PUMP);
+
+        // Same rounding as the previous round: the pump would stay there.
+        char same = round > 0;
+        for (size_t j = 1; j <= n && same; j++)
+            same = c->is_slack[j] || fraction_equal(c->x[j], c->prev[j]);
+        if (same && !flip(c)) break;
+        memcpy(c->prev, c->x, (n + 1) * sizeof(Fraction));
+
+        distance_objective(c, &work, work_basis);
+        if (simplex(&work, work_basis) != OPTIMAL) break;
+    }
+    return 0;
+}
+
+static int rins(Context *c, const Tableau *tab, const size_t *basis) {
+    const OriginalProblem *orig = c->orig;
+    const Incumbent *inc = c->inc;
+    size_t n = orig->n;
+    size_t m = orig->m;
+    if (tableau_vertex(tab, basis, n, c->lp)) return 0;
+
+    // The original problem, with the variables on which the vertex and the
+    // incumbent agree fixed: their columns move to the rhs (and to the cost).
+    // Slacks stay free, so that the rows keep full rank.
+    Tableau sub = {n, m, NULL, &c->arena, 0, 0, &c->params};
+    sub.data = arena_alloc(&c->arena, (m + 1) * (n + 1) * sizeof(Fraction));
+    Fraction *x = arena_alloc(&c->arena, (n + 1) * sizeof(Fraction));
+    if (sub.data == NULL || x == NULL) {
+        fprintf(stderr, "Error - Not enough memory for RINS.\n");
+        return 0;
+    }
+    memcpy(sub.data, orig->cost, (n + 1) * sizeof(Fraction));
+    memcpy(sub.data + n + 1, orig->rows, m * (n + 1) * sizeof(Fraction));
+
+    size_t fixed = 0;
+    size_t free_vars = 0;
+    for (size_t j = 1; j <= n; j++) {
+        c->mark[j] = !c->is_slack[j] && c->lp[j].den == 1
+            && fraction_equal(c->lp[j], inc->x[j]);
+        free_vars += !c->is_slack[j];
+        if (!c->mark[j]) continue;
+        fixed++;
+        for (size_t i = 0; i <= m; i++) {
+            Fraction *a = &sub.data[i * (n + 1)];
+            if (a[j].num == 0) continue;
+            a[0] = fraction_subtract(a[0], fraction_multiply(a[j], inc->x[j]));
+            a[j] = fraction_create(0, 1);
+        }
+    }
+    if (fixed == free_vars || fixed < RINS_MIN_FIXED * free_vars) return 0;
+    solver_log(tableau_params(tab), "RINS: %lu of %lu variables fixed.\n",
+            (unsigned long) fixed, (unsigned long) free_vars);
+
+    BranchBoundStats stats;
+    branch_and_bound(&sub, NULL, x, &stats);
+    if (!stats.incumbents) return 0;
+    for (size_t j = 1; j <= n; j++)
+        if (c->mark[j]) x[j] = inc->x[j];
+    return incumbent_offer(c->inc, orig, x, HEUR_RINS);
+}
+
+static int (*const heuristic_fns[N_HEURISTICS])(Context*, const Tableau*, const size_t*) = {
+    rounding, diving, pump, rins
+};
+
+int run_heuristics(const Tableau *tab, const size_t *basis,
+        const OriginalProblem *orig, Incumbent *inc) {
+    const SolverParams *params = tableau_params(tab);
+    Context c;
+    if (context_init(&c, orig, inc)) return 0;
+
+    // The sub-solves share the clock and the pivot count of the solve: the
+    // limits of a heuristic are deadlines from its start, and its pivots are
+    // taken back from the count.
+    solve_begin(params);
+    int improved = 0;
+    int status;
+    for (int h = 0; h < N_HEURISTICS; h++) {
+        if (!(params->heuristics & HEURISTIC_BIT(h))) continue;
+        if (h == HEUR_RINS && !inc->found) continue;
+        if (solve_stop(params, &status)) break;
+
+        double start = solve_elapsed();
+        long pivots = solve_pivots();
+        c.params = *params;
+        c.params.verbose = 0;
+        c.params.progress = NULL;
+        c.params.checkpoint_path = NULL;
+        c.params.cut_stats = NULL;
+        c.params.heuristics = 0;
+        c.params.incumbent = NULL;
+        if (params->heuristic_time > 0 && (params->time_limit <= 0
+                    || start + params->heuristic_time < params->time_limit))
+            c.params.time_limit = start + params->heuristic_time;
+        c.params.max_iterations = 0;
+        if (params->heuristic_iterations > 0)
+            c.params.max_iterations = (int) (pivots + params->heuristic_iterations);
+
+        ArenaMark mark = arena_mark(&c.arena);
+        int found = heuristic_fns[h](&c, tab, basis);
+        arena_rewind(&c.arena, mark);
+        solve_add_pivots(pivots - solve_pivots());
+
+        inc->stats[h].calls++;
+        inc->stats[h].seconds += solve_elapsed() - start;
+        if (!found) continue;
+        inc->stats[h].found++;
+        improved = 1;
+        if (params->verbose) {
+            printf("Heuristic %s: new incumbent, cost = ", heuristic_names[h]);
+            fraction_print(inc->cost);
+            printf(", gap = %.4g\n", inc->gap);
+        }
+    }
+    solve_end();
+
+    arena_destroy(&c.arena);
+    return improved;
+}
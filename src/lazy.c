@@ -0,0 +1,88 @@
+#include "../include/lazy.h"
+
+#include <stdio.h>
+
+// Return 1 if the row "a x <= b" is violated by 'x'.
+static int row_violated(const Fraction *row, const Fraction *x, size_t n) {
+    Fraction ax = fraction_create(0, 1);
+    for (size_t j = 1; j <= n; j++)
+        if (row[j].num && x[j].num) ax = fraction_add(ax, fraction_multiply(row[j], x[j]));
+    return fraction_less(row[0], ax);
+}
+
+int lazy_constraints(Tableau *tab, size_t **basis_ptr, LazyCallback separate,
+        void *data, LazyStats *stats) {
+    const SolverParams *params = tableau_params(tab);
+    int status = INFEASIBLE;
+    size_t n = tab->n; // Variables the oracle knows about.
+    size_t batch = params->lazy_batch > 0 ? (size_t) params->lazy_batch : 1;
+
+    stats->rounds = 0;
+    solve_begin(params);
+    stats->rows_added = 0;
+
+    // Not rewound at the end: the tableau grows in the same arena.
+    Fraction *x = arena_alloc(tab->arena, (n + 1) * sizeof(Fraction));
+    Fraction *rows = arena_alloc(tab->arena, batch * (n + 1) * sizeof(Fraction));
+    if (x == NULL || rows == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the lazy constraints.\n");
+        goto TERMINATE;
+    }
+
+    // Problem without the lazy constraints.
+    status = two_phase_simplex(tab, *basis_ptr);
+
+    while (status == OPTIMAL) {
+        if (solve_stop(params, &status)) break;
+
+        tableau_vertex(tab, *basis_ptr, n, x);
+        size_t count = separate(x, n, rows, batch, data);
+        stats->rounds++;
+
+        // Keep only the violated rows.
+        size_t kept = 0;
+        for (size_t k = 0; k < count && k < batch; k++) {
+            const Fraction *row = &rows[k * (n + 1)];
+            if (!row_violated(row, x, n)) continue;
+            if (kept != k) {
+                for (size_t j = 0; j <= n; j++)
+                    rows[kept * (n + 1) + j] = row[j];
+            }
+            kept++;
+        }
+        if (!kept) break;
+
+        size_t old_n = tab->n;
+        size_t old_m = tab->m;
+        if (append_rows(tab, basis_ptr, kept)) {
+            fprintf(stderr, "Error - Cannot append the rows.\n");
+            status = INFEASIBLE;
+            break;
+        }
+        // The new rows, in the basis of the old ones. Their slack columns
+        // were set by append_rows().
+        size_t cols = tableau_stride(tab);
+        for (size_t k = 0; k < kept; k++)
+            tableau_express_row(tab, *basis_ptr, old_m, &rows[k * (n + 1)], n,
+                    old_n + 1, &tab->data[(old_m + 1 + k) * cols]);
+        stats->rows_added += kept;
+
+        solver_log(params, "\n### Lazy constraints - round %lu: %lu rows ###\n",
+                stats->rounds, kept);
+
+        // The basis is still dual feasible: warm start.
+        status = dual_simplex(tab, *basis_ptr);
+        if (status == UNBOUNDED) {
+            solver_log(params, "No solution - Problem is infeasible.\n");
+            status = INFEASIBLE;
+        }
+        if (status == OPTIMAL) solve_round(params, tableau_cost(tab));
+    }
+
+TERMINATE:
+    solve_end();
+    arena_free(tab->arena, x);
+    arena_free(tab->arena, rows);
+
+    return status;
+}
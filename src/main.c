@@ -1,9 +1,27 @@
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
+#include "../include/async_solve.h"
+#include "../include/backend.h"
+#include "../include/branch_bound.h"
+#include "../include/colgen.h"
+#include "../include/concurrent.h"
+#include "../include/daemon.h"
+#include "../include/decomposition.h"
 #include "../include/fraction.h"
+#include "../include/heuristics.h"
+#include "../include/lazy.h"
+#include "../include/network.h"
 #include "../include/utils.h"
+#include "../include/parametric.h"
+#include "../include/separators.h"
 #include "../include/simple_simplex.h"
+#include "../include/soa_tableau.h"
+#include "../include/solver_client.h"
+
+// Requests a client keeps in flight when sending the problem many times.
+#define CLIENT_WINDOW 64
 
 // Function that tests the two phases simplex.
 void two_phase_tester(void);
@@ -11,8 +29,88 @@ void two_phase_tester(void);
 // Function that tests the dual simplex.
 void dual_simplex_tester(void);
 
+// Options of the command line that are not solver parameters.
+typedef struct {
+    char *direction; // "num_file,den_file" of the parametric direction.
+    char *lambda;    // "lo:hi" range of the parameter.
+    char *resume;    // Snapshot the cutting plane is resumed from.
+    char *columns;   // "num_file,den_file" of the column pool.
+    char *rows;      // "num_file,den_file" of the lazy row pool.
+    char *blocks;    // Block of each row, -1 for the linking ones (mode DW).
+    double progress; // Seconds between two progress reports (0 = synchronous).
+    char *listen;    // Address of the branch and bound workers (mode BB).
+    int workers;     // Workers to wait for before branching (mode BB).
+    int spawn;       // Local workers forked by the coordinator (mode BB).
+    char *out_of_core; // Directory of the file-backed tableau (NULL = in RAM).
+    char *connect;   // Address of a solver daemon the problem is sent to.
+    int requests;    // Times the problem is sent to the daemon (0 = once).
+} CliOptions;
+
+// Name of a solver status (enum tableau_status, or ENGINE_NOT_APPLICABLE).
+const char *status_name(int status);
+
+// Parse the optional "--name=value" arguments that follow the mode.
+// Returns 0 on success.
+int parse_options(int argc, char *argv[], SolverParams *params, CliOptions *cli);
+
+// Parametric analysis (modes PRHS and PCOST).
+int run_parametric(Tableau *tab, size_t *basis, const char *mode,
+        const CliOptions *cli);
+
+// Solve on a separate thread, reporting the progress every cli->progress
+// seconds (modes S, TPS, DS and CP with --progress).
+int run_async(Tableau *tab, size_t **basis, int algorithm, const CliOptions *cli);
+
+// Network simplex (mode NET, or modes S and TPS on network problems).
+int run_network(Tableau *tab, size_t *basis);
+
+// Column generation over a pool of columns read from file (mode CG).
+int run_column_generation(Tableau *tab, size_t *basis, const CliOptions *cli);
+
+// Lazy constraints from a pool of rows read from file (mode LAZY).
+int run_lazy_constraints(Tableau *tab, size_t **basis, const CliOptions *cli);
+
+// Dantzig-Wolfe decomposition, blocks declared by the user or detected
+// (mode DW).
+int run_decomposition(Tableau *tab, const CliOptions *cli);
+
+// Branch and bound, in this process or on the workers that connect to
+// cli->listen (mode BB).
+int run_branch_and_bound(Tableau *tab, const CliOptions *cli);
+
+// Send the problem to the daemon at cli->connect, cli->requests times, and
+// report the first result and the throughput (modes S, TPS, DS and CP).
+int run_client(Tableau *tab, const char *mode, const CliOptions *cli);
+
+// Print the statistics of the cut separators that ran (mode CP).
+void print_cut_stats(const SeparatorStats *stats);
+
+// Print the statistics of the heuristics and their incumbent (mode CP).
+void print_incumbent(const Incumbent *inc, int status);
+
 
 int main(int argc, char *argv[]) {
+    // Branch and bound worker: the coordinator sends the problem.
+    if (argc == 2 && !strncmp(argv[1], "--worker=", 9))
+        return bb_worker(argv[1] + 9);
+
+    // Solver daemon: the clients send the problems, the options are the
+    // defaults of their requests.
+    if (argc >= 2 && !strncmp(argv[1], "--daemon=", 9)) {
+        SolverParams params;
+        CliOptions cli = {NULL, NULL, NULL, NULL, NULL, NULL, 0, NULL, 0, 0, NULL, NULL, 0};
+        solver_params_default(&params);
+        if (parse_options(argc - 2, argv + 2, &params, &cli)) return 1;
+        return solver_daemon(argv[1] + 9, &params, cli.workers);
+    }
+
+    if (argc < 6) {
+        fprintf(stderr, "Usage: %s num_file den_file rows cols mode [options]\n"
+                "       %s --worker=ADDRESS\n"
+                "       %s --daemon=ADDRESS [options]\n", argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
     char *num_fn = argv[1];
     char *den_fn = argv[2];
     char *mode = argv[5];
@@ -20,24 +118,92 @@ int main(int argc, char *argv[]) {
     int rows = atoi(argv[3]);
     int cols = atoi(argv[4]);
 
+    // Solver parameters.
+    SolverParams params;
+    CliOptions cli = {NULL, NULL, NULL, NULL, NULL, NULL, 0, NULL, 0, 0, NULL, NULL, 0};
+    SeparatorStats cut_stats[N_CUT_FAMILIES] = {{0}};
+    Incumbent incumbent;
+    incumbent_init(&incumbent);
+    solver_params_default(&params);
+    params.cut_stats = cut_stats;
+    params.incumbent = &incumbent;
+    if (parse_options(argc - 6, argv + 6, &params, &cli)) return 1;
+
+    // All the memory of the solver run comes from this arena, mapped from a
+    // file for the models that do not fit in RAM.
+    Arena arena;
+    if (cli.out_of_core == NULL) {
+        arena_init(&arena, 0);
+    } else if (arena_init_mapped(&arena, 0, cli.out_of_core)) {
+        return 1;
+    }
+
     Tableau tab;
-    int status = load_tableau(num_fn, den_fn, rows, cols, &tab);
+    int status = load_tableau(num_fn, den_fn, rows, cols, &arena, &tab);
     if (!status) {
         printf("Tableau loaded from file:\n");
         pretty_print_tableau(&tab, NULL);
     } else {
         fprintf(stderr, "Error - Could not load tableau from file.\n");
+        arena_destroy(&arena);
         return 1;
     }
+    tab.params = &params;
 
     // Allocate memory for the basis.
     size_t *basis = NULL;
-    basis = (size_t*) malloc(tab.m * sizeof(size_t));
+    basis = (size_t*) arena_alloc(&arena, tab.m * sizeof(size_t));
     if (basis == NULL) {
         fprintf(stderr, "Error - Not enough memory to allocate the basis.\n");
         goto TERMINATE;
     }
 
+    // Solve on a daemon.
+    if (cli.connect) {
+        run_client(&tab, mode, &cli);
+        goto TERMINATE;
+    }
+
+    // Asynchronous solve with progress reports.
+    if (cli.progress > 0 && (!strcmp("S", mode) || !strcmp("TPS", mode)
+                || !strcmp("DS", mode) || !strcmp("CP", mode))) {
+        int algorithm = ALGO_SIMPLEX;
+        if (!strcmp("DS", mode)) algorithm = ALGO_DUAL_SIMPLEX;
+        if (!strcmp("CP", mode)) algorithm = ALGO_CUTTING_PLANE;
+
+        // The reports replace the log of the iterations, which the solver
+        // thread would print in the middle of them.
+        params.verbose = 0;
+        run_async(&tab, &basis, algorithm, &cli);
+        goto TERMINATE;
+    }
+
+    // Generated solver core, with the numeric backend chosen by the user.
+    if (params.backend != BACKEND_CLASSIC && (!strcmp("S", mode)
+                || !strcmp("TPS", mode) || !strcmp("DS", mode) || !strcmp("CP", mode))) {
+        int algorithm = ALGO_SIMPLEX;
+        if (!strcmp("DS", mode)) algorithm = ALGO_DUAL_SIMPLEX;
+        if (!strcmp("CP", mode)) algorithm = ALGO_CUTTING_PLANE;
+
+        printf("\n### Starting %s backend... ###\n", backend_name(params.backend));
+        BackendResult res;
+        int status = backend_solve(&tab, &basis, params.backend, algorithm, &res);
+        printf("Status: %s (%s backend, %d pivots).\n", status_name(status),
+                backend_name(res.backend), res.iterations);
+        if (status == OPTIMAL && res.exact) {
+            printf("Final tableau:\n");
+            pretty_print_tableau(&tab, basis);
+        }
+        goto TERMINATE;
+    }
+
+    // Network structure: spanning tree simplex.
+    if (!strcmp("NET", mode) || (params.network && (!strcmp("S", mode)
+                    || !strcmp("TPS", mode)) && network_detect(&tab, NULL))) {
+        run_network(&tab, basis);
+        goto TERMINATE;
+    }
+
     // Check mode and lauch solver.
     if (!strcmp("S", mode)) {
 
@@ -84,31 +250,714 @@ int main(int argc, char *argv[]) {
         printf("\n### Starting dual simplex... ###\n");
         dual_simplex(&tab, basis);
         
+    } else if (!strcmp("SOA", mode) || !strcmp("DSOA", mode)) {
+
+        // Retrieve the basis.
+        int status = search_starting_basis(&tab, basis);
+        if (status) {
+            fprintf(stderr, "Error - No full basis found.\n");
+            goto TERMINATE;
+        }
+
+        // Switch to the structure-of-arrays layout.
+        SoaTableau soa;
+        if (soa_tableau_from_tableau(&soa, &tab)) goto TERMINATE;
+
+        if (!strcmp("SOA", mode)) {
+            printf("\n### Starting simplex (SoA layout)... ###\n");
+            soa_simplex(&soa, basis);
+        } else {
+            printf("\n### Starting dual simplex (SoA layout)... ###\n");
+            soa_dual_simplex(&soa, basis);
+        }
+
+        soa_tableau_to_tableau(&soa, &tab);
+        soa_tableau_free(&soa);
+
+        printf("Final tableau:\n");
+        pretty_print_tableau(&tab, basis);
+
+    } else if (!strcmp("CONC", mode)) { // Concurrent optimizer.
+
+        printf("\n### Starting concurrent optimizer... ###\n");
+        ConcurrentResult res;
+        concurrent_simplex(&tab, basis, ENGINES_ALL, &res);
+
+        for (int e = 0; e < N_ENGINES; e++) {
+            printf("%*s%-24s %s\n", 8, "",
+                    concurrent_engine_name(e), status_name(res.engine_status[e]));
+        }
+        if (res.engine < 0) {
+            printf("No engine could solve the problem (%s).\n", status_name(res.status));
+            goto TERMINATE;
+        }
+        printf("Winner: %s engine (%s) in %.6f s.\n",
+                concurrent_engine_name(res.engine), status_name(res.status), res.seconds);
+
+        if (res.status == OPTIMAL) {
+            printf("Final tableau:\n");
+            pretty_print_tableau(&tab, basis);
+            printf("%*sCost = ", 8, "");
+            fraction_print(fraction_chg_sign(tab.data[0]));
+            printf("\n");
+        }
+
+    } else if (!strcmp("PRHS", mode) || !strcmp("PCOST", mode)) {
+
+        run_parametric(&tab, basis, mode, &cli);
+
+    } else if (!strcmp("CG", mode)) {
+
+        run_column_generation(&tab, basis, &cli);
+
+    } else if (!strcmp("LAZY", mode)) {
+
+        run_lazy_constraints(&tab, &basis, &cli);
+
+    } else if (!strcmp("DW", mode)) {
+
+        run_decomposition(&tab, &cli);
+
+    } else if (!strcmp("BB", mode)) {
+
+        run_branch_and_bound(&tab, &cli);
+
     } else if (!strcmp("CP", mode)) {
 
-        printf("\n### Starting cutting plane... ###\n");
-        cutting_plane(&tab, basis);
+        if (cli.resume) {
+            printf("\n### Resuming cutting plane... ###\n");
+            status = cutting_plane_resume(cli.resume, &tab, &basis);
+        } else {
+            printf("\n### Starting cutting plane... ###\n");
+            status = cutting_plane(&tab, &basis);
+        }
+        print_cut_stats(cut_stats);
+        if (params.heuristics) print_incumbent(&incumbent, status);
 
     } else {
         fprintf(stderr, "Error - Mode specified not defined.");
     }
 
 TERMINATE:
-    
+
+    printf("\nPeak memory usage: %zu bytes.\n", arena_peak(&arena));
+
     // Free memory.
-    free_and_null((char**) &tab.data);
-    free_and_null((char**) &basis);
+    arena_destroy(&arena);
+    incumbent_free(&incumbent);
+
+    return 0;
+}
+
+
+const char *status_name(int status) {
+    static const char *names[] = {
+        "infeasible", "feasible", "optimal", "unbounded", "iteration limit", "cancelled",
+        "numeric overflow", "time limit"
+    };
+    if (status < 0 || status > TIME_LIMIT) return "not applicable";
+    return names[status];
+}
+
+int parse_options(int argc, char *argv[], SolverParams *params, CliOptions *cli) {
+    for (int i = 0; i < argc; i++) {
+        char *arg = argv[i];
+        char *value = strchr(arg, '=');
+        if (strncmp(arg, "--", 2) || value == NULL) {
+            fprintf(stderr, "Error - Bad option '%s'.\n", arg);
+            return 1;
+        }
+        value++;
+
+        if (!strncmp(arg, "--max-itr=", 10)) {
+            params->max_iterations = atoi(value);
+        } else if (!strncmp(arg, "--time-limit=", 13)) {
+            params->time_limit = atof(value);
+        } else if (!strncmp(arg, "--progress=", 11)) {
+            cli->progress = atof(value);
+        } else if (!strncmp(arg, "--stall=", 8)) {
+            params->stall_threshold = atoi(value);
+        } else if (!strncmp(arg, "--seed=", 7)) {
+            params->seed = (unsigned int) strtoul(value, NULL, 10);
+        } else if (!strncmp(arg, "--threads=", 10)) {
+            params->threads = atoi(value);
+        } else if (!strncmp(arg, "--cuts=", 7)) {
+            params->cuts_per_round = atoi(value);
+        } else if (!strncmp(arg, "--separators=", 13)) {
+            if (cut_families_parse(value, &params->cut_families)) {
+                fprintf(stderr, "Error - Bad list of separators '%s'.\n", value);
+                return 1;
+            }
+        } else if (!strncmp(arg, "--heuristics=", 13)) {
+            if (heuristics_parse(value, &params->heuristics)) {
+                fprintf(stderr, "Error - Bad list of heuristics '%s'.\n", value);
+                return 1;
+            }
+        } else if (!strncmp(arg, "--heuristic-time=", 17)) {
+            params->heuristic_time = atof(value);
+        } else if (!strncmp(arg, "--heuristic-itr=", 16)) {
+            params->heuristic_iterations = atoi(value);
+        } else if (!strncmp(arg, "--gap=", 6)) {
+            params->gap_limit = atof(value);
+        } else if (!strncmp(arg, "--gmi-scale=", 12)) {
+            params->cut_max_scale = atoi(value);
+        } else if (!strncmp(arg, "--checkpoint=", 13)) {
+            params->checkpoint_path = value;
+        } else if (!strncmp(arg, "--checkpoint-every=", 19)) {
+            params->checkpoint_interval = atof(value);
+        } else if (!strncmp(arg, "--resume=", 9)) {
+            cli->resume = value;
+        } else if (!strncmp(arg, "--columns=", 10)) {
+            cli->columns = value;
+        } else if (!strncmp(arg, "--colgen-batch=", 15)) {
+            params->colgen_batch = atoi(value);
+        } else if (!strncmp(arg, "--rows=", 7)) {
+            cli->rows = value;
+        } else if (!strncmp(arg, "--blocks=", 9)) {
+            cli->blocks = value;
+        } else if (!strncmp(arg, "--out-of-core=", 14)) {
+            cli->out_of_core = value;
+        } else if (!strncmp(arg, "--connect=", 10)) {
+            cli->connect = value;
+        } else if (!strncmp(arg, "--requests=", 11)) {
+            cli->requests = atoi(value);
+        } else if (!strncmp(arg, "--listen=", 9)) {
+            cli->listen = value;
+        } else if (!strncmp(arg, "--workers=", 10)) {
+            cli->workers = atoi(value);
+        } else if (!strncmp(arg, "--spawn=", 8)) {
+            cli->spawn = atoi(value);
+        } else if (!strncmp(arg, "--lazy-batch=", 13)) {
+            params->lazy_batch = atoi(value);
+        } else if (!strncmp(arg, "--direction=", 12)) {
+            cli->direction = value;
+        } else if (!strncmp(arg, "--lambda=", 9)) {
+            cli->lambda = value;
+        } else if (!strncmp(arg, "--network=", 10)) {
+            params->network = atoi(value);
+        } else if (!strncmp(arg, "--backend=", 10)) {
+            int b = BACKEND_CLASSIC;
+            while (b <= BACKEND_AUTO && strcmp(value, backend_name(b))) b++;
+            if (!backend_available(b)) {
+                fprintf(stderr, "Error - Backend '%s' is not available.\n", value);
+                return 1;
+            }
+            params->backend = b;
+        } else if (!strncmp(arg, "--degeneracy=", 13)) {
+            if (!strcmp(value, "none")) params->degeneracy = DEGEN_NONE;
+            else if (!strcmp(value, "perturb")) params->degeneracy = DEGEN_PERTURB;
+            else if (!strcmp(value, "lex")) params->degeneracy = DEGEN_LEXICOGRAPHIC;
+            else {
+                fprintf(stderr, "Error - Unknown degeneracy mode '%s'.\n", value);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Error - Unknown option '%s'.\n", arg);
+            return 1;
+        }
+    }
+
+    // The generated backends only have the core of the solver.
+    const char *option = backend_unsupported(params);
+    if (option == NULL && params->backend != BACKEND_CLASSIC && cli->resume)
+        option = "--resume";
+    if (option) {
+        fprintf(stderr, "Error - %s needs --backend=classic.\n", option);
+        return 1;
+    }
+
+    return 0;
+}
+
+int run_parametric(Tableau *tab, size_t *basis, const char *mode,
+        const CliOptions *cli) {
+    char rhs = !strcmp("PRHS", mode);
+
+    // Range of lambda.
+    Fraction lo, hi;
+    char range[64];
+    char *sep = NULL;
+    if (cli->lambda && strlen(cli->lambda) < sizeof(range)) {
+        strcpy(range, cli->lambda);
+        sep = strchr(range, ':');
+    }
+    if (sep == NULL) {
+        fprintf(stderr, "Error - Specify the range with --lambda=lo:hi.\n");
+        return 1;
+    }
+    *sep = '\0';
+    if (fraction_parse(range, &lo) || fraction_parse(sep + 1, &hi)
+            || fraction_greater(lo, hi)) {
+        fprintf(stderr, "Error - Bad range of lambda '%s'.\n", cli->lambda);
+        return 1;
+    }
+
+    // Direction: a column (rhs) or a row (cost) of the tableau.
+    char files[512];
+    sep = NULL;
+    if (cli->direction && strlen(cli->direction) < sizeof(files)) {
+        strcpy(files, cli->direction);
+        sep = strchr(files, ',');
+    }
+    if (sep == NULL) {
+        fprintf(stderr, "Error - Specify the direction with"
+                        " --direction=num_file,den_file.\n");
+        return 1;
+    }
+    *sep = '\0';
+
+    Tableau dir;
+    int len = rhs ? tab->m + 1 : tab->n + 1;
+    if (load_tableau(files, sep + 1, 1, len, tab->arena, &dir)) {
+        fprintf(stderr, "Error - Could not load the direction.\n");
+        return 1;
+    }
+
+    ParametricResult res;
+    if (rhs) {
+        printf("\n### Starting parametric rhs... ###\n");
+        parametric_rhs(tab, basis, dir.data, lo, hi, &res);
+    } else {
+        printf("\n### Starting parametric cost... ###\n");
+        parametric_cost(tab, basis, dir.data, lo, hi, &res);
+    }
+    parametric_print(&res);
+
+    return 0;
+}
+
+int run_async(Tableau *tab, size_t **basis, int algorithm, const CliOptions *cli) {
+    const char *names[] = {"simplex", "dual simplex", "cutting plane"};
+    printf("\n### Starting %s (asynchronous)... ###\n", names[algorithm]);
+
+    AsyncSolve solve;
+    if (async_solve_start(&solve, tab, basis, algorithm)) return 1;
+
+    struct timespec period;
+    period.tv_sec = (time_t) cli->progress;
+    period.tv_nsec = (long) ((cli->progress - period.tv_sec) * 1e9);
+    while (!async_solve_done(&solve)) {
+        nanosleep(&period, NULL);
+        printf("%*s%8.3f s: %ld pivots, %ld rounds, cost %.10g\n", 8, "",
+                atomic_load(&solve.progress.seconds),
+                atomic_load(&solve.progress.pivots),
+                atomic_load(&solve.progress.rounds),
+                atomic_load(&solve.progress.objective));
+    }
+
+    int status = async_solve_wait(&solve);
+    printf("Status: %s (%ld pivots).\n", status_name(status),
+            atomic_load(&solve.progress.pivots));
+    if (status != OPTIMAL && status != ITERATION_LIMIT && status != TIME_LIMIT
+            && status != CANCELLED) return 0;
+
+    // The tableau is only written back by the classic backend.
+    if (tableau_params(tab)->backend == BACKEND_CLASSIC) {
+        printf("%s tableau:\n", status == OPTIMAL ? "Final" : "Last");
+        pretty_print_tableau(tab, *basis);
+        printf("%*sCost = ", 8, "");
+        fraction_print(fraction_chg_sign(tab->data[0]));
+        printf("\n");
+    } else {
+        printf("%*sCost = %.10g\n", 8, "", atomic_load(&solve.progress.objective));
+    }
+
+    return 0;
+}
+
+int run_network(Tableau *tab, size_t *basis) {
+    printf("\n### Starting network simplex... ###\n");
+    NetworkResult res;
+    int status = network_simplex(tab, basis, &res);
+
+    printf("Status: %s (%ld pivots).\n", status_name(status), res.pivots);
+    if (status == OPTIMAL && res.written) {
+        if (res.redundant)
+            printf("Removed %lu redundant rows.\n", (unsigned long) res.redundant);
+        printf("Final tableau:\n");
+        pretty_print_tableau(tab, basis);
+        printf("%*sCost = ", 8, "");
+        fraction_print(fraction_chg_sign(tab->data[0]));
+        printf("\n");
+    } else if (status == OPTIMAL) {
+        printf("%*sCost = %.10g\n", 8, "", res.cost);
+    }
+
+    return 0;
+}
+
+// Pool of candidate columns, priced by full enumeration.
+typedef struct {
+    Fraction *cols; // 'count' columns of m+1 entries (cost first).
+    char *used;     // Columns already given to the master.
+    size_t count;
+} ColumnPool;
+
+// Pricing oracle of mode CG: the most negative reduced costs of the pool.
+static size_t pool_pricing(const Fraction *duals, size_t m, Fraction *cols,
+        size_t max_cols, void *data) {
+    ColumnPool *pool = data;
+    size_t found = 0;
+
+    while (found < max_cols) {
+        size_t best = pool->count;
+        Fraction best_rc = fraction_create(0, 1);
+        for (size_t k = 0; k < pool->count; k++) {
+            if (pool->used[k]) continue;
+            const Fraction *col = &pool->cols[k * (m + 1)];
+            Fraction rc = col[0];
+            for (size_t i = 1; i <= m; i++)
+                if (col[i].num) rc = fraction_subtract(rc, fraction_multiply(duals[i], col[i]));
+            if (fraction_less(rc, best_rc)) {
+                best = k;
+                best_rc = rc;
+            }
+        }
+        if (best == pool->count) break;
+
+        pool->used[best] = 1;
+        for (size_t i = 0; i <= m; i++)
+            cols[found * (m + 1) + i] = pool->cols[best * (m + 1) + i];
+        found++;
+    }
+
+    return found;
+}
+
+// Load a pool of vectors of 'len' entries from "num_file,den_file" (the
+// # of vectors comes from the size of the file). Returns 0 on success.
+static int load_pool(const char *spec, const char *option, size_t len,
+        Arena *arena, Tableau *pool) {
+    char files[512];
+    char *sep = NULL;
+    if (spec && strlen(spec) < sizeof(files)) {
+        strcpy(files, spec);
+        sep = strchr(files, ',');
+    }
+    if (sep == NULL) {
+        fprintf(stderr, "Error - Specify the pool with --%s=num_file,den_file.\n", option);
+        return 1;
+    }
+    *sep = '\0';
+
+    FILE *fp = fopen(files, "rb");
+    long size = -1;
+    if (fp) {
+        if (!fseek(fp, 0, SEEK_END)) size = ftell(fp);
+        fclose(fp);
+    }
+    if (size <= 0 || size % (len * sizeof(int))) {
+        fprintf(stderr, "Error - Bad pool '%s'.\n", files);
+        return 1;
+    }
+
+    if (load_tableau(files, sep + 1, size / (len * sizeof(int)), len, arena, pool)) {
+        fprintf(stderr, "Error - Could not load the pool.\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+int run_column_generation(Tableau *tab, size_t *basis, const CliOptions *cli) {
+    ColumnPool pool;
+    Tableau cols;
+    if (load_pool(cli->columns, "columns", tab->m + 1, tab->arena, &cols)) return 1;
+    pool.count = cols.m + 1;
+    pool.cols = cols.data;
+    pool.used = arena_alloc(tab->arena, pool.count);
+    if (pool.used == NULL) return 1;
+    memset(pool.used, 0, pool.count);
+
+    printf("\n### Starting column generation (%lu columns in the pool)... ###\n",
+            pool.count);
+    ColGenStats stats;
+    int status = column_generation(tab, basis, pool_pricing, &pool, &stats);
+
+    printf("\nColumn generation: %s, %lu rounds, %lu columns added.\n",
+            status_name(status), stats.rounds, stats.columns_added);
+    if (status == OPTIMAL) {
+        printf("Final tableau:\n");
+        pretty_print_tableau(tab, basis);
+    }
+
+    return 0;
+}
+
+// Pool of candidate rows "a x <= b", separated by full enumeration.
+typedef struct {
+    Fraction *rows; // 'count' rows of n+1 entries (b first).
+    char *used;     // Rows already given to the problem.
+    size_t count;
+} RowPool;
+
+// Separation oracle of mode LAZY: the most violated rows of the pool.
+static size_t pool_separation(const Fraction *x, size_t n, Fraction *rows,
+        size_t max_rows, void *data) {
+    RowPool *pool = data;
+    size_t found = 0;
+
+    while (found < max_rows) {
+        size_t best = pool->count;
+        Fraction best_viol = fraction_create(0, 1);
+        for (size_t k = 0; k < pool->count; k++) {
+            if (pool->used[k]) continue;
+            const Fraction *row = &pool->rows[k * (n + 1)];
+            Fraction viol = fraction_chg_sign(row[0]);
+            for (size_t j = 1; j <= n; j++)
+                if (row[j].num && x[j].num) viol = fraction_add(viol, fraction_multiply(row[j], x[j]));
+            if (fraction_less(best_viol, viol)) {
+                best = k;
+                best_viol = viol;
+            }
+        }
+        if (best == pool->count) break;
+
+        pool->used[best] = 1;
+        for (size_t j = 0; j <= n; j++)
+            rows[found * (n + 1) + j] = pool->rows[best * (n + 1) + j];
+        found++;
+    }
+
+    return found;
+}
+
+int run_lazy_constraints(Tableau *tab, size_t **basis, const CliOptions *cli) {
+    RowPool pool;
+    Tableau rows;
+    if (load_pool(cli->rows, "rows", tab->n + 1, tab->arena, &rows)) return 1;
+    pool.count = rows.m + 1;
+    pool.rows = rows.data;
+    pool.used = arena_alloc(tab->arena, pool.count);
+    if (pool.used == NULL) return 1;
+    memset(pool.used, 0, pool.count);
+
+    printf("\n### Starting lazy constraints (%lu rows in the pool)... ###\n",
+            pool.count);
+    LazyStats stats;
+    int status = lazy_constraints(tab, basis, pool_separation, &pool, &stats);
+
+    printf("\nLazy constraints: %s, %lu rounds, %lu rows added.\n",
+            status_name(status), stats.rounds, stats.rows_added);
+    if (status == OPTIMAL) {
+        printf("Final tableau:\n");
+        pretty_print_tableau(tab, *basis);
+    }
+
+    return 0;
+}
+
+int run_decomposition(Tableau *tab, const CliOptions *cli) {
+    int *row_block = NULL;
+    if (cli->blocks) {
+        row_block = arena_alloc(tab->arena, tab->m * sizeof(int));
+        if (row_block == NULL) return 1;
+
+        // One block per row, comma separated.
+        char *p = cli->blocks;
+        for (size_t i = 0; i < tab->m; i++) {
+            char *end;
+            row_block[i] = (int) strtol(p, &end, 10);
+            if (end == p || (*end != ',' && i + 1 < tab->m) || (*end && i + 1 == tab->m)) {
+                fprintf(stderr, "Error - Specify the block of the %lu rows with"
+                        " --blocks=b1,b2,...\n", tab->m);
+                return 1;
+            }
+            p = end + 1;
+        }
+    }
+
+    Fraction *x = arena_alloc(tab->arena, (tab->n + 1) * sizeof(Fraction));
+    if (x == NULL) return 1;
+
+    printf("\n### Starting Dantzig-Wolfe decomposition... ###\n");
+    DecompositionStats stats;
+    int status = dantzig_wolfe(tab, row_block, x, &stats);
+
+    printf("\nDantzig-Wolfe: %s, %lu blocks, %lu linking rows, %lu rounds,"
+            " %lu proposals.\n", status_name(status), stats.blocks, stats.linking,
+            stats.rounds, stats.proposals);
+    if (status == OPTIMAL) {
+        printf("Cost = ");
+        fraction_print(stats.cost);
+        printf("\n");
+        for (size_t j = 1; j <= tab->n; j++) {
+            if (!x[j].num) continue;
+            printf("x[%lu] = ", j);
+            fraction_print(x[j]);
+            printf("\n");
+        }
+    }
 
     return 0;
 }
 
+int run_branch_and_bound(Tableau *tab, const CliOptions *cli) {
+    if ((cli->workers > 0 || cli->spawn > 0) && cli->listen == NULL) {
+        fprintf(stderr, "Error - Specify the address of the workers with --listen=.\n");
+        return 1;
+    }
+
+    Fraction *x = arena_alloc(tab->arena, (tab->n + 1) * sizeof(Fraction));
+    if (x == NULL) return 1;
+
+    BranchBoundConfig config = {cli->listen, cli->workers, cli->spawn};
+    if (cli->listen) {
+        printf("\n### Starting branch and bound on %s... ###\n", cli->listen);
+    } else {
+        printf("\n### Starting branch and bound... ###\n");
+    }
+    BranchBoundStats stats;
+    int status = branch_and_bound(tab, &config, x, &stats);
+
+    printf("\nBranch and bound: %s, %lu nodes, %lu pruned, %lu incumbents,"
+            " %lu max open, %lu workers, %lu requeued.\n", status_name(status),
+            stats.nodes, stats.pruned, stats.incumbents, stats.max_open,
+            stats.workers, stats.requeued);
+    if (stats.incumbents > 0) {
+        printf("Cost = ");
+        fraction_print(stats.cost);
+        printf("\n");
+        for (size_t j = 1; j <= tab->n; j++) {
+            if (!x[j].num) continue;
+            printf("x[%lu] = ", j);
+            fraction_print(x[j]);
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
+
+static double client_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int run_client(Tableau *tab, const char *mode, const CliOptions *cli) {
+    const SolverParams *params = tableau_params(tab);
+    DaemonRequest req = {ALGO_SIMPLEX, params->max_iterations, params->time_limit};
+    if (!strcmp("DS", mode)) {
+        req.algorithm = ALGO_DUAL_SIMPLEX;
+    } else if (!strcmp("CP", mode)) {
+        req.algorithm = ALGO_CUTTING_PLANE;
+    } else if (strcmp("S", mode) && strcmp("TPS", mode)) {
+        fprintf(stderr, "Error - Mode %s cannot be solved by the daemon.\n", mode);
+        return 1;
+    }
+
+    size_t total = cli->requests > 0 ? (size_t) cli->requests : 1;
+    double *sent = malloc(total * sizeof(double));
+    if (sent == NULL) return 1;
+
+    SolverClient client;
+    if (solver_client_connect(&client, cli->connect)) {
+        free(sent);
+        return 1;
+    }
+    printf("\n### Sending %zu requests to %s... ###\n", total, cli->connect);
+
+    // Up to CLIENT_WINDOW requests in flight, results in any order.
+    int err = 0;
+    size_t submitted = 0, received = 0;
+    double latency = 0, worst = 0;
+    double start = client_seconds();
+    while (received < total && !err) {
+        while (submitted < total && submitted - received < CLIENT_WINDOW && !err) {
+            uint64_t id;
+            sent[submitted] = client_seconds();
+            err = solver_client_submit(&client, tab, &req, &id);
+            submitted++;
+        }
+        if (err) break;
+
+        DaemonResult res;
+        if (solver_client_receive(&client, &res) || res.id == 0 || res.id > submitted) {
+            fprintf(stderr, "Error - The daemon did not answer.\n");
+            err = 1;
+            break;
+        }
+        double elapsed = client_seconds() - sent[res.id - 1];
+        latency += elapsed;
+        if (elapsed > worst) worst = elapsed;
+
+        if (received++ == 0) {
+            printf("Status: %s (%lu pivots, %.4f s).\n", res.status == DAEMON_REJECTED
+                    ? "rejected" : status_name(res.status),
+                    (unsigned long) res.pivots, res.seconds);
+            if (res.n) {
+                printf("%*sCost = ", 8, "");
+                fraction_print(res.cost);
+                printf("\n");
+                for (size_t j = 1; j <= res.n; j++) {
+                    if (res.x[j].num == 0) continue;
+                    printf("%*sx[%lu] = ", 8, "", j);
+                    fraction_print(res.x[j]);
+                    printf("\n");
+                }
+            } else if (res.status != DAEMON_REJECTED) {
+                printf("%*sCost = %.10g\n", 8, "", res.objective);
+            }
+        }
+        daemon_result_free(&res);
+    }
+
+    double elapsed = client_seconds() - start;
+    if (received)
+        printf("%zu requests in %.4f s: %.1f solves/s, latency %.3f ms avg, %.3f ms max.\n",
+                received, elapsed, received / elapsed, 1e3 * latency / received, 1e3 * worst);
+
+    solver_client_close(&client);
+    free(sent);
+    return err;
+}
+
+void print_cut_stats(const SeparatorStats *stats) {
+    printf("\nSeparator   calls   found   added   seconds\n");
+    for (int f = 0; f < N_CUT_FAMILIES; f++) {
+        if (!stats[f].calls) continue;
+        printf("%-9s %7zu %7zu %7zu %9.4f\n", cut_separators[f].name, stats[f].calls,
+                stats[f].found, stats[f].selected, stats[f].seconds);
+    }
+}
+
+void print_incumbent(const Incumbent *inc, int status) {
+    printf("\nHeuristic   calls   found   seconds\n");
+    for (int h = 0; h < N_HEURISTICS; h++) {
+        if (!inc->stats[h].calls) continue;
+        printf("%-9s %7zu %7zu %9.4f\n", heuristic_names[h], inc->stats[h].calls,
+                inc->stats[h].found, inc->stats[h].seconds);
+    }
+
+    printf("Status: %s.\n", status_name(status));
+    if (!inc->found) {
+        printf("No incumbent.\n");
+        return;
+    }
+    printf("Incumbent (%s, %.4f s): cost = ", inc->source < N_HEURISTICS
+            ? heuristic_names[inc->source] : "LP", inc->seconds);
+    fraction_print(inc->cost);
+    printf(", bound = ");
+    fraction_print(inc->bound);
+    printf(", gap = %.4g\n", inc->gap);
+    for (size_t j = 1; j <= inc->n; j++) {
+        if (inc->x[j].num == 0) continue;
+        printf("%*sx[%lu] = ", 8, "", j);
+        fraction_print(inc->x[j]);
+        printf("\n");
+    }
+}
 
 void two_phase_tester(void) {
     // Define the tableau.
     Tableau tab = {
         3, // # cols 
         2, // # rows
-        NULL
+        NULL, // data
+        NULL, // arena: malloc/free
+        0, 0, // stride, row_cap: n+1, m+1
+        NULL // params: defaults
     };
 
     // Define the original tableau.
@@ -143,7 +992,10 @@ void dual_simplex_tester(void) {
     Tableau tab = {
         5, // # cols
         2, // # rows
-        NULL
+        NULL, // data
+        NULL, // arena: malloc/free
+        0, 0, // stride, row_cap: n+1, m+1
+        NULL // params: defaults
     };
 
     // Define the tableau.
@@ -158,3 +1010,4 @@ void dual_simplex_tester(void) {
     size_t basis[] = {4, 5};
     dual_simplex(&tab, basis);
 }
+
@@ -0,0 +1,579 @@
+#include "../include/network.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NONE ((size_t) -1)
+
+// Spanning tree of the network simplex. Node 0 is the root (the ground of
+// the single-entry columns), node i is row i. Arc a < n is column a+1, arc
+// n+i-1 is the artificial arc of node i.
+typedef struct {
+    size_t n_nodes;
+    size_t n_arcs;
+    size_t n_real;        // Arcs of the problem (the others are artificial).
+    size_t *tail, *head;  // Endpoints of the arcs.
+    long long *cost;      // Costs of the real arcs.
+    long long *flow;
+    char *in_tree;
+    char *fixed;          // Arcs that no feasible flow uses (never enter).
+    size_t *pred;         // Parent of a node (NONE for the root).
+    size_t *pred_arc;     // Tree arc between a node and its parent.
+    size_t *depth;
+    size_t *child;        // First child of a node.
+    size_t *sibling;      // Next and previous child of the same parent.
+    size_t *prev_sibling;
+    long long *pi;        // Node potentials.
+    size_t *stack;        // DFS stack, one entry per node.
+    char *mark;           // Nodes of a subtree.
+    int phase;            // 1: min sum of artificial flows, 2: real costs.
+    long long objective;  // Cost of the current tree in this phase.
+    size_t next_arc;      // Start of the next pricing scan.
+    long pivots;
+} Network;
+
+// Find the root of 'x' in the union-find, with the parity of the path.
+static size_t uf_find(size_t *parent, int *parity, size_t x, int *px) {
+    size_t r = x;
+    int p = 0;
+    while (parent[r] != r) {
+        p ^= parity[r];
+        r = parent[r];
+    }
+
+    // Path compression.
+    int py = p;
+    for (size_t y = x; parent[y] != y; ) {
+        size_t next = parent[y];
+        int pn = py ^ parity[y];
+        parent[y] = r;
+        parity[y] = py;
+        y = next;
+        py = pn;
+    }
+
+    *px = p;
+    return r;
+}
+
+int network_detect(const Tableau *tab, int *sign) {
+    size_t cols = tableau_stride(tab);
+    size_t m = tab->m;
+    int network = 0;
+
+    // Union-find over the rows: parity 1 if two rows have opposite signs.
+    size_t *parent = arena_alloc(tab->arena, (m + 1) * sizeof(size_t));
+    int *parity = arena_alloc(tab->arena, (m + 1) * sizeof(int));
+    if (parent == NULL || parity == NULL || m == 0) goto TERMINATE;
+    for (size_t i = 0; i <= m; i++) {
+        parent[i] = i;
+        parity[i] = 0;
+    }
+
+    for (size_t i = 0; i <= m; i++)
+        if (tab->data[i * cols].den != 1) goto TERMINATE;
+
+    for (size_t j = 1; j <= tab->n; j++) {
+        if (tab->data[j].den != 1) goto TERMINATE;
+
+        size_t rows[2];
+        int vals[2];
+        int count = 0;
+        for (size_t i = 1; i <= m; i++) {
+            Fraction elem = tab->data[i * cols + j];
+            if (elem.num == 0) continue;
+            if (elem.den != 1 || (elem.num != 1 && elem.num != -1) || count == 2)
+                goto TERMINATE;
+            rows[count] = i;
+            vals[count++] = elem.num;
+        }
+        if (count == 0) goto TERMINATE;
+        if (count == 1) continue;
+
+        // Opposite signs after the flips: same sign rows iff the entries differ.
+        int want = vals[0] == vals[1];
+        int p0, p1;
+        size_t r0 = uf_find(parent, parity, rows[0], &p0);
+        size_t r1 = uf_find(parent, parity, rows[1], &p1);
+        if (r0 == r1) {
+            if ((p0 ^ p1) != want) goto TERMINATE;
+        } else {
+            parent[r1] = r0;
+            parity[r1] = p0 ^ p1 ^ want;
+        }
+    }
+
+    network = 1;
+    if (sign) {
+        for (size_t i = 1; i <= m; i++) {
+            int p;
+            uf_find(parent, parity, i, &p);
+            sign[i - 1] = p ? -1 : 1;
+        }
+    }
+
+TERMINATE:
+    arena_free(tab->arena, parent);
+    arena_free(tab->arena, parity);
+
+    return network;
+}
+
+// Cost of arc 'a' in the current phase.
+static long long arc_cost(const Network *net, size_t a) {
+    if (net->phase == 1) return a >= net->n_real;
+    return a >= net->n_real ? 0 : net->cost[a];
+}
+
+static long long reduced_cost(const Network *net, size_t a) {
+    return arc_cost(net, a) - net->pi[net->tail[a]] + net->pi[net->head[a]];
+}
+
+static void detach(Network *net, size_t u) {
+    size_t p = net->pred[u];
+    if (net->prev_sibling[u] != NONE) net->sibling[net->prev_sibling[u]] = net->sibling[u];
+    else net->child[p] = net->sibling[u];
+    if (net->sibling[u] != NONE) net->prev_sibling[net->sibling[u]] = net->prev_sibling[u];
+}
+
+static void attach(Network *net, size_t u, size_t p) {
+    net->pred[u] = p;
+    net->prev_sibling[u] = NONE;
+    net->sibling[u] = net->child[p];
+    if (net->child[p] != NONE) net->prev_sibling[net->child[p]] = u;
+    net->child[p] = u;
+}
+
+// Depth and potential of the nodes of the subtree rooted at 'u', from the
+// ones of its parent.
+static void update_subtree(Network *net, size_t u) {
+    size_t top = 0;
+    net->stack[top++] = u;
+    while (top) {
+        size_t v = net->stack[--top];
+        size_t p = net->pred[v];
+        if (p == NONE) {
+            net->depth[v] = 0;
+            net->pi[v] = 0;
+        } else {
+            size_t a = net->pred_arc[v];
+            net->depth[v] = net->depth[p] + 1;
+            // Tree arcs have zero reduced cost.
+            if (net->tail[a] == p) net->pi[v] = net->pi[p] - arc_cost(net, a);
+            else net->pi[v] = net->pi[p] + arc_cost(net, a);
+        }
+        for (size_t c = net->child[v]; c != NONE; c = net->sibling[c])
+            net->stack[top++] = c;
+    }
+}
+
+// Replace the tree arc of node 'q' by 'e', which links 'inner' (in the
+// subtree of 'q') to 'outer': the path from 'inner' to 'q' is reversed.
+static void tree_exchange(Network *net, size_t e, size_t inner, size_t outer, size_t q) {
+    net->in_tree[net->pred_arc[q]] = 0;
+    net->in_tree[e] = 1;
+
+    size_t u = inner;
+    size_t new_pred = outer;
+    size_t new_arc = e;
+    for (;;) {
+        size_t old_pred = net->pred[u];
+        size_t old_arc = net->pred_arc[u];
+        detach(net, u);
+        attach(net, u, new_pred);
+        net->pred_arc[u] = new_arc;
+        if (u == q) break;
+        new_pred = u;
+        new_arc = old_arc;
+        u = old_pred;
+    }
+
+    update_subtree(net, inner);
+}
+
+// Block search pricing: the most negative reduced cost of the first block
+// of real arcs that has one. Returns NONE if the tree is optimal.
+static size_t select_entering(Network *net, long long *rc_out) {
+    size_t n = net->n_real;
+    size_t block = (size_t) sqrt((double) n) + 1;
+    size_t best = NONE;
+    long long best_rc = 0;
+
+    for (size_t cnt = 0; cnt < n; cnt++) {
+        size_t a = (net->next_arc + cnt) % n;
+        if (!net->in_tree[a] && !net->fixed[a]) {
+            long long rc = reduced_cost(net, a);
+            if (rc < best_rc) {
+                best = a;
+                best_rc = rc;
+            }
+        }
+        if (best != NONE && ((cnt + 1) % block == 0 || cnt + 1 == n)) {
+            net->next_arc = (a + 1) % n;
+            break;
+        }
+    }
+
+    *rc_out = best_rc;
+    return best;
+}
+
+// Send flow around the cycle of the entering arc 'e' (tail to head) and
+// update the tree. The leaving arc is the last blocking arc met from the
+// apex along the cycle, so the tree stays strongly feasible. Returns 1 if
+// no arc blocks (unbounded).
+static int pivot(Network *net, size_t e, long long rc) {
+    size_t k = net->tail[e];
+    size_t l = net->head[e];
+
+    // Apex of the cycle.
+    size_t u = k, v = l;
+    while (u != v) {
+        if (net->depth[u] > net->depth[v]) u = net->pred[u];
+        else if (net->depth[v] > net->depth[u]) v = net->pred[v];
+        else {
+            u = net->pred[u];
+            v = net->pred[v];
+        }
+    }
+    size_t apex = u;
+
+    // Path apex -> k is traversed downwards: arcs pointing up are backward.
+    // In phase 2 the artificial arcs (zero flow) block in both directions.
+    long long delta = LLONG_MAX;
+    size_t leave = NONE;
+    char l_side = 0;
+    for (u = k; u != apex; u = net->pred[u]) {
+        size_t a = net->pred_arc[u];
+        char blocks = net->tail[a] == u || (net->phase == 2 && a >= net->n_real);
+        if (blocks && net->flow[a] < delta) {
+            delta = net->flow[a];
+            leave = u;
+        }
+    }
+    // Path l -> apex is traversed upwards: arcs pointing down are backward.
+    for (u = l; u != apex; u = net->pred[u]) {
+        size_t a = net->pred_arc[u];
+        char blocks = net->head[a] == u || (net->phase == 2 && a >= net->n_real);
+        if (blocks && net->flow[a] <= delta) {
+            delta = net->flow[a];
+            leave = u;
+            l_side = 1;
+        }
+    }
+    if (leave == NONE) return 1;
+
+    // Update the flows.
+    if (delta) {
+        net->flow[e] += delta;
+        for (u = k; u != apex; u = net->pred[u]) {
+            size_t a = net->pred_arc[u];
+            net->flow[a] += net->tail[a] == u ? -delta : delta;
+        }
+        for (u = l; u != apex; u = net->pred[u]) {
+            size_t a = net->pred_arc[u];
+            net->flow[a] += net->tail[a] == u ? delta : -delta;
+        }
+        net->objective += rc * delta;
+    }
+
+    if (l_side) tree_exchange(net, e, l, k, leave);
+    else tree_exchange(net, e, k, l, leave);
+
+    return 0;
+}
+
+// Run one phase of the network simplex.
+static int run_phase(Network *net, const SolverParams *params) {
+    int status = OPTIMAL;
+
+    update_subtree(net, 0);
+    net->objective = 0;
+    for (size_t a = 0; a < net->n_arcs; a++)
+        if (net->flow[a]) net->objective += arc_cost(net, a) * net->flow[a];
+
+    for (;;) {
+        if (solve_stop(params, &status)) break;
+
+        long long rc;
+        size_t e = select_entering(net, &rc);
+        if (e == NONE) {
+            status = OPTIMAL;
+            break;
+        }
+        if (pivot(net, e, rc)) {
+            status = UNBOUNDED;
+            break;
+        }
+        net->pivots++;
+        solve_pivot(params, (double) net->objective);
+    }
+
+    return status;
+}
+
+// Mark the nodes of the subtree of 'q'.
+static void mark_subtree(Network *net, size_t q) {
+    memset(net->mark, 0, net->n_nodes);
+    size_t top = 0;
+    net->stack[top++] = q;
+    while (top) {
+        size_t v = net->stack[--top];
+        net->mark[v] = 1;
+        for (size_t c = net->child[v]; c != NONE; c = net->sibling[c])
+            net->stack[top++] = c;
+    }
+}
+
+// After phase one (every artificial flow is zero), replace the artificial
+// arcs of the tree by real arcs. An arc leaving the subtree of 'q' enters
+// with a degenerate pivot: the leaving arc is the deepest zero flow arc on
+// the path from 'q' to its tail, the artificial arc if there is none, so the
+// tree stays strongly feasible and the subtree shrinks until the artificial
+// arc leaves. No feasible flow enters a subtree that no arc leaves (its
+// supply is zero): the arcs entering it are fixed, and its artificial arc is
+// on no cycle of phase two.
+static void drive_out_artificials(Network *net) {
+    for (size_t q = 1; q < net->n_nodes; q++) {
+        while (net->pred_arc[q] >= net->n_real) {
+            mark_subtree(net, q);
+
+            size_t e = NONE;
+            for (size_t a = 0; a < net->n_real && e == NONE; a++)
+                if (!net->fixed[a] && net->mark[net->tail[a]] && !net->mark[net->head[a]])
+                    e = a;
+            if (e == NONE) {
+                for (size_t a = 0; a < net->n_real; a++)
+                    if (!net->mark[net->tail[a]] && net->mark[net->head[a]]) net->fixed[a] = 1;
+                break;
+            }
+
+            size_t leave = q;
+            for (size_t u = net->tail[e]; u != q; u = net->pred[u]) {
+                if (net->flow[net->pred_arc[u]] == 0) {
+                    leave = u;
+                    break;
+                }
+            }
+            tree_exchange(net, e, net->tail[e], net->head[e], leave);
+        }
+    }
+}
+
+// After phase two, link the subtrees still under an artificial arc by their
+// fixed entering arc of least reduced cost: the potentials of the subtree
+// shift so that this arc has a zero reduced cost and the other ones stay
+// >= 0. A subtree that no arc enters is a component without ground arcs, the
+// row of its top node is redundant.
+static void link_fixed_subtrees(Network *net) {
+    for (size_t q = 1; q < net->n_nodes; q++) {
+        if (net->pred_arc[q] < net->n_real) continue;
+        mark_subtree(net, q);
+
+        size_t e = NONE;
+        for (size_t a = 0; a < net->n_real; a++) {
+            if (net->mark[net->tail[a]] || !net->mark[net->head[a]]) continue;
+            if (e == NONE || reduced_cost(net, a) < reduced_cost(net, e)) e = a;
+        }
+        if (e == NONE) continue;
+        net->fixed[e] = 0;
+        tree_exchange(net, e, net->head[e], net->tail[e], q);
+    }
+}
+
+// Write the canonical tableau of the tree in 'tab', without the rows of the
+// nodes still under an artificial arc (tab->m decreases). Returns 0 on
+// success.
+static int write_tableau(Network *net, Tableau *tab, size_t *basis,
+        long long cost0, size_t *redundant) {
+    size_t cols = tableau_stride(tab);
+
+    // Row of every node (the DFS stack is free).
+    size_t *row = net->stack;
+    size_t m = 0;
+    for (size_t v = 1; v < net->n_nodes; v++) {
+        size_t a = net->pred_arc[v];
+        row[v] = a >= net->n_real ? NONE : ++m;
+        if (net->flow[a] > INT_MAX) return 1;
+    }
+
+    // Every value must fit a Fraction. The nonbasic columns must be priced
+    // >= 0 and stay off the removed rows, which only fixed arcs could break.
+    if (cost0 < INT_MIN || cost0 > INT_MAX) return 1;
+    for (size_t a = 0; a < net->n_real; a++) {
+        if (net->in_tree[a]) continue;
+        long long rc = reduced_cost(net, a);
+        if (rc < 0 || rc > INT_MAX) return 1;
+
+        size_t u = net->tail[a], w = net->head[a];
+        while (u != w) {
+            size_t *v = net->depth[u] >= net->depth[w] ? &u : &w;
+            if (row[*v] == NONE) return 1;
+            *v = net->pred[*v];
+        }
+    }
+
+    for (size_t i = 0; i <= tab->m; i++)
+        for (size_t j = 0; j <= tab->n; j++)
+            tab->data[i * cols + j] = fraction_create(0, 1);
+    *redundant = tab->m - m;
+    tab->m = m;
+
+    tab->data[0] = fraction_create((int) cost0, 1);
+    for (size_t v = 1; v < net->n_nodes; v++) {
+        if (row[v] == NONE) continue;
+        size_t a = net->pred_arc[v];
+        basis[row[v] - 1] = a + 1;
+        tab->data[row[v] * cols] = fraction_create((int) net->flow[a], 1);
+        tab->data[row[v] * cols + a + 1] = fraction_create(1, 1);
+    }
+
+    // A nonbasic column is the path of tree arcs from its tail to its head:
+    // +1 for the arcs traversed forward, -1 for the others.
+    for (size_t a = 0; a < net->n_real; a++) {
+        if (net->in_tree[a]) continue;
+        size_t j = a + 1;
+        tab->data[j] = fraction_create((int) reduced_cost(net, a), 1);
+
+        size_t u = net->tail[a], w = net->head[a];
+        while (u != w) {
+            if (net->depth[u] >= net->depth[w]) {
+                int coef = net->tail[net->pred_arc[u]] == u ? 1 : -1;
+                tab->data[row[u] * cols + j] = fraction_create(coef, 1);
+                u = net->pred[u];
+            } else {
+                int coef = net->head[net->pred_arc[w]] == w ? 1 : -1;
+                tab->data[row[w] * cols + j] = fraction_create(coef, 1);
+                w = net->pred[w];
+            }
+        }
+    }
+
+    return 0;
+}
+
+int network_simplex(Tableau *tab, size_t *basis, NetworkResult *res) {
+    const SolverParams *params = tableau_params(tab);
+    size_t cols = tableau_stride(tab);
+    size_t m = tab->m;
+    size_t n = tab->n;
+    int status = INFEASIBLE;
+
+    res->pivots = 0;
+    res->cost = 0;
+    res->written = 0;
+    res->redundant = 0;
+
+    int *sign = arena_alloc(tab->arena, (m ? m : 1) * sizeof(int));
+    if (sign == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the network simplex.\n");
+        return INFEASIBLE;
+    }
+    if (!network_detect(tab, sign)) {
+        fprintf(stderr, "Error - The problem has no network structure.\n");
+        arena_free(tab->arena, sign);
+        return INFEASIBLE;
+    }
+
+    // All the arrays in a single block.
+    Network net;
+    net.n_nodes = m + 1;
+    net.n_real = n;
+    net.n_arcs = n + m;
+    size_t nn = net.n_nodes, na = net.n_arcs;
+    size_t bytes = (2 * na + 7 * nn) * sizeof(size_t)
+        + (n + na + nn) * sizeof(long long) + 2 * na + nn;
+    char *block = arena_alloc(tab->arena, bytes);
+    if (block == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the network simplex.\n");
+        arena_free(tab->arena, sign);
+        return INFEASIBLE;
+    }
+    char *ptr = block;
+    net.cost = (long long*) ptr; ptr += n * sizeof(long long);
+    net.flow = (long long*) ptr; ptr += na * sizeof(long long);
+    net.pi = (long long*) ptr;   ptr += nn * sizeof(long long);
+    net.tail = (size_t*) ptr;    ptr += na * sizeof(size_t);
+    net.head = (size_t*) ptr;    ptr += na * sizeof(size_t);
+    net.pred = (size_t*) ptr;    ptr += nn * sizeof(size_t);
+    net.pred_arc = (size_t*) ptr; ptr += nn * sizeof(size_t);
+    net.depth = (size_t*) ptr;   ptr += nn * sizeof(size_t);
+    net.child = (size_t*) ptr;   ptr += nn * sizeof(size_t);
+    net.sibling = (size_t*) ptr; ptr += nn * sizeof(size_t);
+    net.prev_sibling = (size_t*) ptr; ptr += nn * sizeof(size_t);
+    net.stack = (size_t*) ptr;   ptr += nn * sizeof(size_t);
+    net.in_tree = ptr;           ptr += na;
+    net.fixed = ptr;             ptr += na;
+    net.mark = ptr;
+    net.next_arc = 0;
+    net.pivots = 0;
+
+    // Arcs of the columns, with the rows negated as in 'sign'.
+    for (size_t j = 1; j <= n; j++) {
+        size_t a = j - 1;
+        net.tail[a] = net.head[a] = 0;
+        for (size_t i = 1; i <= m; i++) {
+            int v = tab->data[i * cols + j].num * sign[i - 1];
+            if (v > 0) net.tail[a] = i;
+            else if (v < 0) net.head[a] = i;
+        }
+        net.cost[a] = tab->data[j].num;
+        net.flow[a] = 0;
+        net.in_tree[a] = 0;
+        net.fixed[a] = 0;
+    }
+
+    // Starting tree: an artificial arc between the root and every node,
+    // pointing to the root when its flow is zero (strongly feasible).
+    net.pred[0] = NONE;
+    net.pred_arc[0] = NONE;
+    net.child[0] = NONE;
+    for (size_t i = 1; i <= m; i++) {
+        size_t a = n + i - 1;
+        long long supply = (long long) tab->data[i * cols].num * sign[i - 1];
+        net.tail[a] = supply >= 0 ? i : 0;
+        net.head[a] = supply >= 0 ? 0 : i;
+        net.flow[a] = supply >= 0 ? supply : -supply;
+        net.in_tree[a] = 1;
+        net.fixed[a] = 0;
+        net.child[i] = NONE;
+        attach(&net, i, 0);
+        net.pred_arc[i] = a;
+    }
+
+    solve_begin(params);
+
+    // Phase 1: min sum of the artificial flows.
+    net.phase = 1;
+    status = run_phase(&net, params);
+    if (status == OPTIMAL && net.objective > 0) {
+        solver_log(params, "Original problem is infeasible\n");
+        status = INFEASIBLE;
+    }
+
+    // Phase 2: the artificial arcs never enter the tree again.
+    if (status == OPTIMAL) {
+        drive_out_artificials(&net);
+        net.phase = 2;
+        status = run_phase(&net, params);
+    }
+
+    solve_end();
+    res->pivots = net.pivots;
+
+    if (status == OPTIMAL) {
+        long long cost0 = tab->data[0].num - net.objective;
+        res->cost = (double) -cost0;
+        link_fixed_subtrees(&net);
+        res->written = !write_tableau(&net, tab, basis, cost0, &res->redundant);
+        if (!res->written)
+            solver_log(params, "Cannot write back the tableau of the optimal tree.\n");
+    }
+
+    arena_free(tab->arena, block);
+    arena_free(tab->arena, sign);
+
+    return status;
+}
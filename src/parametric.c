@@ -0,0 +1,351 @@
+#include "../include/parametric.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initialize an empty result.
+static void result_init(ParametricResult *res, const Tableau *tab) {
+    res->m = tab->m;
+    res->count = 0;
+    res->cap = 0;
+    res->pieces = NULL;
+    res->end_status = OPTIMAL;
+    res->arena = tab->arena;
+}
+
+// Append the piece [lo, hi] with cost z0 + z1 * lambda. Returns 0 on success.
+static int result_add(ParametricResult *res, Fraction lo, Fraction hi,
+        Fraction z0, Fraction z1, const size_t *basis) {
+    if (res->count == res->cap) {
+        size_t cap = res->cap ? 2 * res->cap : 8;
+        ParametricPiece *pieces = arena_realloc(res->arena, res->pieces,
+                res->cap * sizeof(ParametricPiece), cap * sizeof(ParametricPiece));
+        if (pieces == NULL) return 1;
+        res->pieces = pieces;
+        res->cap = cap;
+    }
+
+    ParametricPiece *p = &res->pieces[res->count];
+    p->basis = arena_alloc(res->arena, res->m * sizeof(size_t));
+    if (p->basis == NULL) return 1;
+    memcpy(p->basis, basis, res->m * sizeof(size_t));
+
+    p->lo = lo;
+    p->hi = hi;
+    p->z0 = z0;
+    p->z1 = z1;
+    res->count++;
+
+    return 0;
+}
+
+// Copy of the tableau (same arena).
+static int copy_tableau(const Tableau *src, Tableau *dst) {
+    size_t cols = tableau_stride(src);
+
+    *dst = *src;
+    dst->stride = 0;
+    dst->row_cap = 0;
+    dst->data = arena_alloc(src->arena, (src->m + 1) * (src->n + 1) * sizeof(Fraction));
+    if (dst->data == NULL) return 1;
+
+    for (size_t i = 0; i <= src->m; i++)
+        memcpy(&dst->data[i * (src->n + 1)], &src->data[i * cols],
+                (src->n + 1) * sizeof(Fraction));
+    return 0;
+}
+
+// Compute out = B^-1 d (rows 1..m, in the order of 'basis') and
+// out[0] = -c_B B^-1 d, where B and c_B are the columns and the costs of the
+// basic variables in the original tableau 'orig'. A small tableau holding
+// only the basic columns and 'd' is reduced with Gauss-Jordan pivots.
+static int basis_solve(const Tableau *orig, const size_t *basis,
+        const Fraction *d, Fraction *out) {
+    int status = 1;
+    size_t m = orig->m;
+    size_t cols_o = tableau_stride(orig);
+
+    Tableau sub = {m + 1, m, NULL, orig->arena, 0, 0, orig->params};
+    size_t cols = m + 2;
+    char *used = NULL;      // Rows already used as pivot rows.
+    size_t *row_of = NULL;  // Pivot row of each basic column.
+
+    sub.data = arena_alloc(orig->arena, (m + 1) * cols * sizeof(Fraction));
+    used = arena_alloc(orig->arena, (m + 1) * sizeof(char));
+    row_of = arena_alloc(orig->arena, (m + 1) * sizeof(size_t));
+    if (!sub.data || !used || !row_of) {
+        fprintf(stderr, "Error - Not enough memory to solve with the basis.\n");
+        goto TERMINATE;
+    }
+
+    for (size_t i = 0; i <= m; i++) {
+        sub.data[i * cols] = fraction_create(0, 1);
+        for (size_t k = 1; k <= m; k++)
+            sub.data[i * cols + k] = orig->data[i * cols_o + basis[k-1]];
+        sub.data[i * cols + m + 1] = i ? d[i] : fraction_create(0, 1);
+        used[i] = 0;
+    }
+
+    for (size_t k = 1; k <= m; k++) {
+        size_t r = 1;
+        while (r <= m && (used[r] || sub.data[r * cols + k].num == 0)) r++;
+        if (r > m) {
+            fprintf(stderr, "Error - Singular basis.\n");
+            goto TERMINATE;
+        }
+        pivot_operations(&sub, k, r, 0, 0);
+        used[r] = 1;
+        row_of[k] = r;
+    }
+
+    out[0] = sub.data[m + 1];
+    for (size_t i = 1; i <= m; i++)
+        out[i] = sub.data[row_of[i] * cols + m + 1];
+
+    status = 0;
+
+TERMINATE:
+    arena_free(orig->arena, sub.data);
+    arena_free(orig->arena, used);
+    arena_free(orig->arena, row_of);
+
+    return status;
+}
+
+// Cost of the piece: z(lambda) = -(obj + (lambda - at) * slope), where 'obj'
+// is the -z entry of the tableau at lambda = 'at'.
+static void piece_cost(Fraction obj, Fraction slope, Fraction at,
+        Fraction *z0, Fraction *z1) {
+    *z1 = fraction_chg_sign(slope);
+    *z0 = fraction_subtract(fraction_multiply(at, slope), obj);
+}
+
+int parametric_rhs(Tableau *tab, size_t *basis, const Fraction *d,
+        Fraction lo, Fraction hi, ParametricResult *res) {
+    int status = OPTIMAL;
+    size_t cols = tableau_stride(tab);
+    const SolverParams *params = tableau_params(tab);
+    Tableau orig = {0};
+    Fraction *dbar = NULL; // B^-1 d (row 0: effect on -z).
+
+    result_init(res, tab);
+    res->end = lo;
+
+    // Keep the original columns, needed to compute B^-1 d.
+    if (copy_tableau(tab, &orig)) {
+        fprintf(stderr, "Error - Not enough memory for the parametric analysis.\n");
+        return INFEASIBLE;
+    }
+
+    // Solve the problem for lambda = lo.
+    for (size_t i = 1; i <= tab->m; i++)
+        tab->data[i * cols] = fraction_add(tab->data[i * cols],
+                fraction_multiply(lo, d[i]));
+
+    status = two_phase_simplex(tab, basis);
+    if (status != OPTIMAL) {
+        res->end_status = status;
+        goto TERMINATE;
+    }
+
+    dbar = arena_alloc(tab->arena, (tab->m + 1) * sizeof(Fraction));
+    if (dbar == NULL || basis_solve(&orig, basis, d, dbar)) {
+        status = res->end_status = INFEASIBLE;
+        goto TERMINATE;
+    }
+
+    solver_log(params, "\n### Parametric rhs ###\n");
+    Fraction lambda = lo;
+    while (1) {
+        // Breakpoint: largest step keeping b_i + step * dbar_i >= 0.
+        size_t r = 0;
+        Fraction step = {0, 1};
+        for (size_t i = 1; i <= tab->m; i++) {
+            if (dbar[i].num >= 0) continue;
+            Fraction ratio = fraction_divide(tab->data[i * cols],
+                    fraction_chg_sign(dbar[i]));
+            if (!r || fraction_less(ratio, step)
+                    || (fraction_equal(ratio, step) && basis[i-1] < basis[r-1])) {
+                r = i;
+                step = ratio;
+            }
+        }
+
+        Fraction next = hi;
+        if (r && fraction_less(fraction_add(lambda, step), hi))
+            next = fraction_add(lambda, step);
+
+        // Record the piece [lambda, next].
+        if (fraction_greater(next, lambda) || fraction_equal(lo, hi)) {
+            Fraction z0, z1;
+            piece_cost(tab->data[0], dbar[0], lambda, &z0, &z1);
+            if (result_add(res, lambda, next, z0, z1, basis)) {
+                fprintf(stderr, "Error - Not enough memory for the parametric analysis.\n");
+                status = res->end_status = INFEASIBLE;
+                break;
+            }
+        }
+
+        // Move the rhs (and the cost) to lambda = next.
+        Fraction delta = fraction_subtract(next, lambda);
+        for (size_t i = 0; i <= tab->m; i++)
+            tab->data[i * cols] = fraction_add(tab->data[i * cols],
+                    fraction_multiply(delta, dbar[i]));
+        lambda = next;
+        res->end = lambda;
+
+        if (fraction_equal(lambda, hi)) break;
+
+        // Row 'r' becomes infeasible past the breakpoint: dual simplex pivot.
+        size_t h = 0;
+        if (dual_unbounded_check(tab, r, &h)) {
+            res->end_status = INFEASIBLE;
+            break;
+        }
+
+        solver_log(params, "%*sBreakpoint at lambda = %d/%d: x[%lu] leaves, x[%lu] enters.\n",
+                8, "", lambda.num, lambda.den, basis[r-1], h);
+
+        pivot_aux_column(tab, dbar, h, r);
+        pivot_operations(tab, h, r, 0, 0);
+        basis[r - 1] = h;
+    }
+
+TERMINATE:
+    arena_free(tab->arena, dbar);
+    arena_free(tab->arena, orig.data);
+
+    return status;
+}
+
+int parametric_cost(Tableau *tab, size_t *basis, const Fraction *e,
+        Fraction lo, Fraction hi, ParametricResult *res) {
+    int status = OPTIMAL;
+    size_t cols = tableau_stride(tab);
+    const SolverParams *params = tableau_params(tab);
+    Fraction *ebar = NULL; // Reduced costs of 'e' (entry 0: effect on -z).
+
+    result_init(res, tab);
+    res->end = lo;
+
+    // Solve the problem for lambda = lo.
+    for (size_t j = 1; j <= tab->n; j++)
+        tab->data[j] = fraction_add(tab->data[j], fraction_multiply(lo, e[j]));
+
+    status = two_phase_simplex(tab, basis);
+    if (status != OPTIMAL) {
+        res->end_status = status;
+        return status;
+    }
+
+    // ebar = e - e_B B^-1 A, with B^-1 A read from the optimal tableau.
+    ebar = arena_alloc(tab->arena, (tab->n + 1) * sizeof(Fraction));
+    if (ebar == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the parametric analysis.\n");
+        res->end_status = INFEASIBLE;
+        return INFEASIBLE;
+    }
+    ebar[0] = fraction_create(0, 1);
+    for (size_t j = 1; j <= tab->n; j++) ebar[j] = e[j];
+    for (size_t i = 1; i <= tab->m; i++) {
+        Fraction e_b = e[basis[i-1]];
+        if (e_b.num != 0)
+            fraction_row_fms(ebar, &tab->data[i * cols], e_b, tab->n + 1);
+    }
+
+    solver_log(params, "\n### Parametric cost ###\n");
+    Fraction lambda = lo;
+    while (1) {
+        // Breakpoint: largest step keeping c_j + step * ebar_j >= 0.
+        size_t h = 0;
+        Fraction step = {0, 1};
+        for (size_t j = 1; j <= tab->n; j++) {
+            if (ebar[j].num >= 0) continue;
+            Fraction ratio = fraction_divide(tab->data[j], fraction_chg_sign(ebar[j]));
+            if (!h || fraction_less(ratio, step)) {
+                h = j;
+                step = ratio;
+            }
+        }
+
+        Fraction next = hi;
+        if (h && fraction_less(fraction_add(lambda, step), hi))
+            next = fraction_add(lambda, step);
+
+        // Record the piece [lambda, next].
+        if (fraction_greater(next, lambda) || fraction_equal(lo, hi)) {
+            Fraction z0, z1;
+            piece_cost(tab->data[0], ebar[0], lambda, &z0, &z1);
+            if (result_add(res, lambda, next, z0, z1, basis)) {
+                fprintf(stderr, "Error - Not enough memory for the parametric analysis.\n");
+                status = res->end_status = INFEASIBLE;
+                break;
+            }
+        }
+
+        // Move the costs to lambda = next.
+        Fraction delta = fraction_subtract(next, lambda);
+        for (size_t j = 0; j <= tab->n; j++)
+            tab->data[j] = fraction_add(tab->data[j], fraction_multiply(delta, ebar[j]));
+        lambda = next;
+        res->end = lambda;
+
+        if (fraction_equal(lambda, hi)) break;
+
+        // x[h] prices out past the breakpoint: primal simplex pivot.
+        size_t t = 0;
+        if (unbounded_check(tab, h, &t, basis)) {
+            res->end_status = UNBOUNDED;
+            break;
+        }
+
+        solver_log(params, "%*sBreakpoint at lambda = %d/%d: x[%lu] enters, x[%lu] leaves.\n",
+                8, "", lambda.num, lambda.den, h, basis[t-1]);
+
+        pivot_operations(tab, h, t, 0, 0);
+        basis[t - 1] = h;
+
+        // Update the reduced costs of 'e' like row 0.
+        Fraction e_h = ebar[h];
+        fraction_row_fms(ebar, &tab->data[t * cols], e_h, tab->n + 1);
+    }
+
+    arena_free(tab->arena, ebar);
+
+    return status;
+}
+
+void parametric_print(const ParametricResult *res) {
+    printf("\n### Parametric analysis - %lu pieces ###\n", res->count);
+
+    for (size_t k = 0; k < res->count; k++) {
+        const ParametricPiece *p = &res->pieces[k];
+
+        printf("%*slambda in [", 8, "");
+        fraction_print(p->lo);
+        printf(", ");
+        fraction_print(p->hi);
+        printf("]: z = ");
+        fraction_print(p->z0);
+        printf(" + ");
+        fraction_print(p->z1);
+        printf(" * lambda, basis: ");
+        for (size_t i = 0; i < res->m; i++)
+            printf(i == res->m - 1 ? "x[%lu]\n" : "x[%lu], ", p->basis[i]);
+    }
+
+    if (res->count == 0) {
+        printf("%*sNo optimal solution for lambda = ", 8, "");
+        fraction_print(res->end);
+        printf(".\n");
+    } else if (res->end_status == INFEASIBLE) {
+        printf("%*sInfeasible for lambda > ", 8, "");
+        fraction_print(res->end);
+        printf(".\n");
+    } else if (res->end_status == UNBOUNDED) {
+        printf("%*sUnbounded for lambda > ", 8, "");
+        fraction_print(res->end);
+        printf(".\n");
+    }
+}
@@ -0,0 +1,500 @@
+#include "../include/separators.h"
+#include "../include/utils.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Max # of binaries of the conflict graph (it takes n_binaries^2 bytes).
+#define CLIQUE_MAX_BINARIES 2048
+
+// A variable of a knapsack row, with its sort key.
+typedef struct {
+    size_t var;
+    long long weight;
+    double key;
+} KnapsackItem;
+
+// Buffers of the separators, n+1 entries each.
+typedef struct {
+    KnapsackItem *items;
+    long long *dp;
+    size_t *members;
+    char *used;
+    Fraction *row;
+} Scratch;
+
+static Fraction frac_part(Fraction f) {
+    return fraction_subtract(f, fraction_floor(f));
+}
+
+// Write in 'out' (entries 0..tab->n) the row "a x <= b" of the original
+// variables ('row' = b, a_1..a_n) expressed in the current basis.
+static void express_in_basis(const SeparationInput *in, const Fraction *row,
+        Fraction *out) {
+    const Tableau *tab = in->tab;
+    tableau_express_row(tab, in->basis, tab->m, row, in->orig->n, tab->n + 1, out);
+}
+
+// Gomory and GMI: one cut per fractional row of the tableau.
+
+static size_t fractional_rows(const SeparationInput *in) {
+    const Tableau *tab = in->tab;
+    size_t cols = tableau_stride(tab);
+    size_t count = 0;
+    for (size_t i = 1; i <= tab->m; i++)
+        if (tab->data[i * cols].den != 1) count++;
+    return count;
+}
+
+static size_t gomory_separate(const SeparationInput *in, Fraction *cuts, size_t max) {
+    const Tableau *tab = in->tab;
+    size_t cols = tableau_stride(tab);
+    size_t count = 0;
+    for (size_t i = 1; i <= tab->m && count < max; i++) {
+        if (tab->data[i * cols].den == 1) continue;
+        gomory_write_cut(tab, i, &cuts[count * (tab->n + 1)], tab->n);
+        count++;
+    }
+    return count;
+}
+
+// GMI cut of the row "x_B + sum_j a_j x_j = b", f_0 = frac(b):
+//     sum_j g_j x_j >= 1,  g_j = min(f_j / f_0, (1 - f_j) / (1 - f_0)).
+// It is multiplied by the lcm of the denominators of the g_j, so that its
+// slack is integer too. Beyond params->cut_max_scale the multiplier is
+// capped and the coefficients rounded up, which weakens the cut but keeps
+// it valid (x >= 0).
+static size_t gmi_separate(const SeparationInput *in, Fraction *cuts, size_t max) {
+    const Tableau *tab = in->tab;
+    const SolverParams *params = tableau_params(tab);
+    size_t cols = tableau_stride(tab);
+    long long max_scale = params->cut_max_scale > 0 ? params->cut_max_scale : 1;
+    size_t count = 0;
+
+    for (size_t i = 1; i <= tab->m && count < max; i++) {
+        const Fraction *src = &tab->data[i * cols];
+        if (src[0].den == 1) continue;
+
+        Fraction f0 = frac_part(src[0]);
+        Fraction one = fraction_create(1, 1);
+        Fraction one_f0 = fraction_subtract(one, f0);
+        Fraction *out = &cuts[count * (tab->n + 1)];
+
+        long long scale = 1;
+        for (size_t j = 1; j <= tab->n; j++) {
+            Fraction f = frac_part(src[j]);
+            if (f.num == 0) {
+                out[j] = f;
+                continue;
+            }
+            if (fraction_less_equal(f, f0))
+                out[j] = fraction_divide(f, f0);
+            else
+                out[j] = fraction_divide(fraction_subtract(one, f), one_f0);
+            if (scale <= max_scale)
+                scale = scale / fraction_gcd64(scale, out[j].den) * out[j].den;
+        }
+        if (scale > max_scale) scale = max_scale;
+
+        // -scale * g x + s = -scale, with ceil(scale * g_j) if needed.
+        out[0] = fraction_create((int) -scale, 1);
+        for (size_t j = 1; j <= tab->n; j++) {
+            long long num = scale * out[j].num;
+            long long coef = num / out[j].den + (num % out[j].den != 0);
+            out[j] = fraction_create((int) -coef, 1);
+        }
+        count++;
+    }
+
+    return count;
+}
+
+// Lifted cover: one cut per knapsack row of the original problem.
+
+static size_t cover_max_cuts(const SeparationInput *in) {
+    return in->orig ? in->orig->n_knapsacks : 0;
+}
+
+// Most promising items first: small (1 - x_j) / a_j.
+static int compare_items(const void *a, const void *b) {
+    const KnapsackItem *i1 = a, *i2 = b;
+    if (i1->key < i2->key) return -1;
+    if (i1->key > i2->key) return 1;
+    return (i1->var > i2->var) - (i1->var < i2->var);
+}
+
+// Coefficient of the item of weight 'weight' lifted in "sum_j alpha_j x_j <=
+// r" (over the items in items[0..count) with alpha_j = row[var]): r minus the
+// max left hand side when x = 1 for the lifted item, computed by a dynamic
+// program over the values (dp[v] = min weight with a left hand side >= v).
+static long long lift(const KnapsackItem *items, size_t count, const Fraction *row,
+        long long r, long long weight, long long capacity, long long *dp) {
+    long long cap = capacity - weight;
+    if (cap < 0) return r; // The item cannot be 1.
+
+    dp[0] = 0;
+    for (long long v = 1; v <= r; v++)
+        dp[v] = LLONG_MAX;
+    for (size_t k = 0; k < count; k++) {
+        long long alpha = row[items[k].var].num;
+        if (alpha <= 0) continue;
+        for (long long v = r; v >= 0; v--) {
+            if (dp[v] == LLONG_MAX) continue;
+            long long t = v + alpha < r ? v + alpha : r;
+            if (dp[v] + items[k].weight < dp[t]) dp[t] = dp[v] + items[k].weight;
+        }
+    }
+
+    long long best = 0;
+    for (long long v = r; v > 0 && !best; v--)
+        if (dp[v] <= cap) best = v;
+    return r - best;
+}
+
+static size_t cover_separate(const SeparationInput *in, Fraction *cuts, size_t max) {
+    const OriginalProblem *orig = in->orig;
+    Scratch *s = orig->scratch;
+    size_t count = 0;
+
+    for (size_t q = 0; q < orig->n_knapsacks && count < max; q++) {
+        const Fraction *a = &orig->rows[orig->knapsacks[q] * (orig->n + 1)];
+        long long capacity = a[0].num;
+
+        // Greedy cover: items sorted by (1 - x_j) / a_j.
+        size_t n_items = 0;
+        for (size_t j = 1; j <= orig->n; j++) {
+            if (!orig->binary[j] || a[j].num == 0) continue;
+            s->items[n_items].var = j;
+            s->items[n_items].weight = a[j].num;
+            s->items[n_items].key = (1 - fraction_to_double(orig->x[j])) / a[j].num;
+            n_items++;
+        }
+        qsort(s->items, n_items, sizeof(KnapsackItem), compare_items);
+
+        size_t n_cover = 0;
+        long long weight = 0;
+        while (n_cover < n_items && weight <= capacity)
+            weight += s->items[n_cover++].weight;
+        if (weight <= capacity) continue;
+
+        // Minimal cover: drop the items with the smallest x_j while the rest
+        // still exceeds the capacity. The cover is items[0..n_cover).
+        for (size_t k = n_cover; k-- > 0;) {
+            if (weight - s->items[k].weight <= capacity) continue;
+            weight -= s->items[k].weight;
+            KnapsackItem tmp = s->items[k];
+            memmove(&s->items[k], &s->items[k + 1],
+                    (n_items - k - 1) * sizeof(KnapsackItem));
+            s->items[n_items - 1] = tmp;
+            n_cover--;
+        }
+
+        // sum_{j in C} x_j <= |C| - 1, then lift the other items in order.
+        long long r = (long long) n_cover - 1;
+        for (size_t j = 0; j <= orig->n; j++)
+            s->row[j] = fraction_create(0, 1);
+        s->row[0] = fraction_create((int) r, 1);
+        for (size_t k = 0; k < n_cover; k++)
+            s->row[s->items[k].var] = fraction_create(1, 1);
+        for (size_t k = n_cover; k < n_items; k++) {
+            long long alpha = lift(s->items, k, s->row, r, s->items[k].weight,
+                    capacity, s->dp);
+            s->row[s->items[k].var] = fraction_create((int) alpha, 1);
+        }
+
+        Fraction *out = &cuts[count * (in->tab->n + 1)];
+        express_in_basis(in, s->row, out);
+        if (out[0].num < 0) count++;
+    }
+
+    return count;
+}
+
+// Clique: one cut per seed, a binary variable with a fractional value.
+
+static size_t clique_max_cuts(const SeparationInput *in) {
+    return in->orig && in->orig->conflict ? in->orig->n_binaries : 0;
+}
+
+// Largest x_j first.
+static int compare_values(const void *a, const void *b) {
+    const KnapsackItem *i1 = a, *i2 = b;
+    if (i1->key > i2->key) return -1;
+    if (i1->key < i2->key) return 1;
+    return (i1->var > i2->var) - (i1->var < i2->var);
+}
+
+static size_t clique_separate(const SeparationInput *in, Fraction *cuts, size_t max) {
+    const OriginalProblem *orig = in->orig;
+    Scratch *s = orig->scratch;
+    size_t nb = orig->n_binaries;
+    size_t count = 0;
+
+    size_t n_items = 0;
+    for (size_t j = 1; j <= orig->n; j++) {
+        if (!orig->binary[j]) continue;
+        s->items[n_items].var = j;
+        s->items[n_items].key = fraction_to_double(orig->x[j]);
+        n_items++;
+    }
+    qsort(s->items, n_items, sizeof(KnapsackItem), compare_values);
+    memset(s->used, 0, orig->n + 1);
+
+    // Grow a clique from each seed not in a previous clique, taking the
+    // variables with the largest values first.
+    for (size_t q = 0; q < n_items && count < max; q++) {
+        size_t seed = s->items[q].var;
+        if (s->used[seed] || orig->x[seed].den == 1) continue;
+
+        size_t size = 0;
+        double sum = 0;
+        s->members[size++] = seed;
+        sum += s->items[q].key;
+        for (size_t k = 0; k < n_items; k++) {
+            size_t var = s->items[k].var;
+            if (var == seed) continue;
+            char adjacent = 1;
+            for (size_t t = 0; t < size && adjacent; t++)
+                adjacent = orig->conflict[orig->bin_index[var] * nb
+                        + orig->bin_index[s->members[t]]];
+            if (!adjacent) continue;
+            s->members[size++] = var;
+            sum += s->items[k].key;
+        }
+        if (size < 2 || sum <= 1) continue;
+
+        // sum_{j in K} x_j <= 1.
+        for (size_t j = 0; j <= orig->n; j++)
+            s->row[j] = fraction_create(0, 1);
+        s->row[0] = fraction_create(1, 1);
+        for (size_t t = 0; t < size; t++) {
+            s->row[s->members[t]] = fraction_create(1, 1);
+            s->used[s->members[t]] = 1;
+        }
+
+        Fraction *out = &cuts[count * (in->tab->n + 1)];
+        express_in_basis(in, s->row, out);
+        if (out[0].num < 0) count++;
+    }
+
+    return count;
+}
+
+const CutSeparator cut_separators[N_CUT_FAMILIES] = {
+    {"gomory", fractional_rows, gomory_separate},
+    {"gmi", fractional_rows, gmi_separate},
+    {"cover", cover_max_cuts, cover_separate},
+    {"clique", clique_max_cuts, clique_separate}
+};
+
+int cut_families_parse(const char *list, unsigned int *mask) {
+    const char *names[N_CUT_FAMILIES];
+    for (int family = 0; family < N_CUT_FAMILIES; family++)
+        names[family] = cut_separators[family].name;
+    return parse_name_list(list, names, N_CUT_FAMILIES, mask);
+}
+
+int original_problem_init(OriginalProblem *orig, const Tableau *tab) {
+    size_t n = tab->n;
+    size_t m = tab->m;
+    size_t cols = tableau_stride(tab);
+    Arena *arena = tab->arena;
+
+    memset(orig, 0, sizeof(OriginalProblem));
+    orig->n = n;
+    orig->m = m;
+    orig->arena = arena;
+
+    Scratch *s = arena_alloc(arena, sizeof(Scratch));
+    orig->scratch = s;
+    orig->rows = arena_alloc(arena, m * (n + 1) * sizeof(Fraction));
+    orig->cost = arena_alloc(arena, (n + 1) * sizeof(Fraction));
+    orig->binary = arena_alloc(arena, n + 1);
+    orig->knapsacks = arena_alloc(arena, (m + 1) * sizeof(size_t));
+    orig->bin_index = arena_alloc(arena, (n + 1) * sizeof(size_t));
+    orig->x = arena_alloc(arena, (n + 1) * sizeof(Fraction));
+    if (s == NULL || orig->rows == NULL || orig->cost == NULL || orig->binary == NULL
+            || orig->knapsacks == NULL || orig->bin_index == NULL || orig->x == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the original problem.\n");
+        original_problem_free(orig);
+        return 1;
+    }
+    memset(s, 0, sizeof(Scratch));
+    s->items = arena_alloc(arena, (n + 1) * sizeof(KnapsackItem));
+    s->dp = arena_alloc(arena, (n + 1) * sizeof(long long));
+    s->members = arena_alloc(arena, (n + 1) * sizeof(size_t));
+    s->used = arena_alloc(arena, n + 1);
+    s->row = arena_alloc(arena, (n + 1) * sizeof(Fraction));
+    if (s->items == NULL || s->dp == NULL || s->members == NULL
+            || s->used == NULL || s->row == NULL) {
+        fprintf(stderr, "Error - Not enough memory for the original problem.\n");
+        original_problem_free(orig);
+        return 1;
+    }
+
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j <= n; j++)
+            orig->rows[i * (n + 1) + j] = tab->data[(i + 1) * cols + j];
+    for (size_t j = 0; j <= n; j++) orig->cost[j] = tab->data[j];
+
+    // x_j <= b / a_j in the rows with a >= 0 and b >= 0: binary if < 2.
+    memset(orig->binary, 0, n + 1);
+    for (size_t i = 0; i < m; i++) {
+        const Fraction *a = &orig->rows[i * (n + 1)];
+        char packing = a[0].num >= 0;
+        char integer = a[0].den == 1 && a[0].num > 0;
+        for (size_t j = 1; j <= n && packing; j++) {
+            packing = a[j].num >= 0;
+            integer = integer && a[j].den == 1;
+        }
+        if (!packing) continue;
+
+        for (size_t j = 1; j <= n; j++) {
+            Fraction two_a = fraction_multiply(fraction_create(2, 1), a[j]);
+            if (a[j].num > 0 && fraction_less(a[0], two_a)) orig->binary[j] = 1;
+        }
+        if (integer) orig->knapsacks[orig->n_knapsacks++] = i;
+    }
+
+    for (size_t j = 1; j <= n; j++)
+        orig->bin_index[j] = orig->binary[j] ? orig->n_binaries++ : SIZE_MAX;
+
+    // Conflict graph: x_i + x_k <= 1 if a_i + a_k > b in a knapsack row.
+    size_t nb = orig->n_binaries;
+    if (nb && nb <= CLIQUE_MAX_BINARIES) {
+        orig->conflict = arena_alloc(arena, nb * nb);
+        if (orig->conflict == NULL) {
+            fprintf(stderr, "Error - Not enough memory for the conflict graph.\n");
+            original_problem_free(orig);
+            return 1;
+        }
+        memset(orig->conflict, 0, nb * nb);
+        for (size_t q = 0; q < orig->n_knapsacks; q++) {
+            const Fraction *a = &orig->rows[orig->knapsacks[q] * (n + 1)];
+            for (size_t i = 1; i <= n; i++) {
+                if (!orig->binary[i] || a[i].num == 0) continue;
+                for (size_t k = i + 1; k <= n; k++) {
+                    if (!orig->binary[k] || a[k].num == 0) continue;
+                    if ((long long) a[i].num + a[k].num <= a[0].num) continue;
+                    orig->conflict[orig->bin_index[i] * nb + orig->bin_index[k]] = 1;
+                    orig->conflict[orig->bin_index[k] * nb + orig->bin_index[i]] = 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+void original_problem_free(OriginalProblem *orig) {
+    Scratch *s = orig->scratch;
+    if (s) {
+        arena_free(orig->arena, s->items);
+        arena_free(orig->arena, s->dp);
+        arena_free(orig->arena, s->members);
+        arena_free(orig->arena, s->used);
+        arena_free(orig->arena, s->row);
+    }
+    arena_free(orig->arena, s);
+    arena_free(orig->arena, orig->rows);
+    arena_free(orig->arena, orig->cost);
+    arena_free(orig->arena, orig->binary);
+    arena_free(orig->arena, orig->knapsacks);
+    arena_free(orig->arena, orig->bin_index);
+    arena_free(orig->arena, orig->conflict);
+    arena_free(orig->arena, orig->x);
+    orig->scratch = NULL;
+    orig->rows = NULL;
+    orig->cost = NULL;
+    orig->binary = NULL;
+    orig->knapsacks = NULL;
+    orig->bin_index = NULL;
+    orig->conflict = NULL;
+    orig->x = NULL;
+}
+
+static double elapsed_since(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+// Separation round of the families of 'mask'.
+static size_t separate_families(const SeparationInput *in, CutPool *pool,
+        CutWorkspace *ws, unsigned int mask) {
+    const Tableau *tab = in->tab;
+    const SolverParams *params = tableau_params(tab);
+    SeparatorStats *stats = params->cut_stats;
+    size_t n = tab->n;
+
+    // Make room for the cuts of every enabled separator.
+    size_t bound[N_CUT_FAMILIES];
+    size_t total = 0;
+    for (int f = 0; f < N_CUT_FAMILIES; f++) {
+        bound[f] = 0;
+        if (mask & CUT_FAMILY_BIT(f))
+            bound[f] = cut_separators[f].max_cuts(in);
+        total += bound[f];
+    }
+    if (!total) return 0;
+    if (cut_workspace_reserve(ws, tab->arena, total, n)) {
+        fprintf(stderr, "Error - Not enough memory for the cuts.\n");
+        return 0;
+    }
+
+    size_t count = 0;
+    for (int f = 0; f < N_CUT_FAMILIES; f++) {
+        if (!bound[f]) continue;
+
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t found = cut_separators[f].separate(in, &ws->coefs[count * (n + 1)], bound[f]);
+        for (size_t k = count; k < count + found; k++) {
+            ws->cand[k].family = f;
+            ws->cand[k].coef = &ws->coefs[k * (n + 1)];
+        }
+        count += found;
+
+        if (stats) {
+            stats[f].calls++;
+            stats[f].found += found;
+            stats[f].seconds += elapsed_since(&start);
+        }
+    }
+
+    size_t selected = cut_select(tab, pool, ws, count);
+    for (size_t k = 0; k < selected; k++) {
+        const CutCandidate *c = &ws->cand[k];
+        solver_log(params, "%*s%s cut: efficacy = %.4f, orthogonality = %.4f\n",
+                8, "", cut_separators[c->family].name, c->efficacy, c->orthogonality);
+        if (stats) stats[c->family].selected++;
+    }
+
+    return selected;
+}
+
+size_t separate_cuts(const SeparationInput *in, CutPool *pool, CutWorkspace *ws) {
+    const Tableau *tab = in->tab;
+    const SolverParams *params = tableau_params(tab);
+
+    // Values of the original variables at the current vertex.
+    if (in->orig) {
+        const OriginalProblem *orig = in->orig;
+        tableau_vertex(tab, in->basis, orig->n, orig->x);
+    }
+
+    size_t selected = separate_families(in, pool, ws, params->cut_families);
+
+    // A fractional row always has a Gomory cut.
+    unsigned int gomory = CUT_FAMILY_BIT(CUT_GOMORY);
+    if (!selected && !(params->cut_families & gomory)) {
+        solver_log(params, "No cut of the enabled families, falling back to Gomory.\n");
+        selected = separate_families(in, pool, ws, gomory);
+    }
+
+    return selected;
+}
@@ -1,7 +1,30 @@
 #include "../include/simple_simplex.h"
-
+#include "../include/checkpoint.h"
+#include "../include/cuts.h"
+#include "../include/heuristics.h"
+#include "../include/separators.h"
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// Row-blocked pivots of an out-of-core tableau: rows are updated a block of
+// about PIVOT_BLOCK_BYTES at a time, PIVOT_TILE columns at a time, so that the
+// tile of the pivot row stays in cache while the block streams from the file.
+// The next PIVOT_READAHEAD_BYTES of rows are requested to the kernel ahead.
+#define PIVOT_BLOCK_BYTES (256 * 1024)
+#define PIVOT_MAX_BLOCK_ROWS 256
+#define PIVOT_TILE 512
+#define PIVOT_READAHEAD_BYTES (8 * 1024 * 1024)
+
+// Bytes of the files read at once by load_tableau().
+#define LOAD_BLOCK_BYTES (64 * 1024)
 
 
 int load_tableau(
@@ -9,9 +32,13 @@ int load_tableau(
         const char *den_fn,
         int rows,
         int cols,
+        Arena *arena,
         Tableau *tab
 ) {
     int status = 0;
+    int *numerators = NULL;
+    int *denominators = NULL;
+    Fraction *matrix = NULL;
 
     // Open the numerator and denominator files.
     FILE *num_f = fopen(num_fn, "rb");
@@ -24,41 +51,67 @@ int load_tableau(
     }
     
     // Allocate memory for the matrix.
-    Fraction *matrix = malloc(rows * cols * sizeof(Fraction));
+    matrix = arena_alloc(arena, (size_t) rows * cols * sizeof(Fraction));
     if (!matrix) {
         fprintf(stderr, "Error -  Memory allocation failed.\n");
         status = 1;
         goto TERMINATE;
     }
     
-    // Store numerators and denominators.
-    int *numerators = malloc(rows * cols * sizeof(int));
-    int *denominators = malloc(rows * cols * sizeof(int));
-
-    int num_sz = fread(numerators, sizeof(int), rows * cols, num_f);
-    int den_sz = fread(denominators, sizeof(int), rows * cols, den_f);
-    
-    // Check if all data are present.
-    if ((num_sz != rows * cols) || (den_sz != rows * cols)) {
-        fprintf(stderr, "Error - Cannot read numerator and/or denominators data.\n");
+    // Store numerators and denominators of a block of rows (temporary
+    // buffers): the files are streamed, whatever the size of the tableau.
+    size_t block = LOAD_BLOCK_BYTES / (cols * sizeof(int));
+    if (block == 0) block = 1;
+    if (block > (size_t) rows) block = rows;
+    ArenaMark mark = arena ? arena_mark(arena) : (ArenaMark) {0};
+    numerators = arena_alloc(arena, block * cols * sizeof(int));
+    denominators = arena_alloc(arena, block * cols * sizeof(int));
+    if (!numerators || !denominators) {
+        fprintf(stderr, "Error -  Memory allocation failed.\n");
         status = 1;
         goto TERMINATE;
     }
-    
-    // Init the matrix.
-    for (int i = 0; i < rows * cols; i++) {
-        matrix[i] = fraction_create(numerators[i], denominators[i]);
+
+    for (size_t i0 = 0; i0 < (size_t) rows; i0 += block) {
+        size_t count = (rows - i0 < block ? rows - i0 : block) * cols;
+        size_t num_sz = fread(numerators, sizeof(int), count, num_f);
+        size_t den_sz = fread(denominators, sizeof(int), count, den_f);
+
+        // Check if all data are present.
+        if (num_sz != count || den_sz != count) {
+            fprintf(stderr, "Error - Cannot read numerator and/or denominators data.\n");
+            status = 1;
+            goto TERMINATE;
+        }
+
+        // Init the matrix.
+        for (size_t k = 0; k < count; k++) {
+            matrix[i0 * cols + k] = fraction_create(numerators[k], denominators[k]);
+        }
     }
 
     // Init the tableau.
     tab->n = cols - 1; // Cols of the constraint matrix A.
     tab->m = rows - 1; // Rows of the constraint matrix A.
     tab->data = matrix;
+    tab->arena = arena;
+    tab->params = NULL;
+    tab->stride = cols;
+    tab->row_cap = rows;
+
+    // Release the temporary buffers.
+    if (arena) {
+        arena_rewind(arena, mark);
+        numerators = denominators = NULL;
+    }
 
 TERMINATE:
     // Release reesources.
-    free_and_null((char**) &numerators);
-    free_and_null((char**) &denominators);
+    if (!arena) {
+        free_and_null((char**) &numerators);
+        free_and_null((char**) &denominators);
+        if (status) free_and_null((char**) &matrix);
+    }
 
     if (num_f) fclose(num_f);
     if (den_f) fclose(den_f);
@@ -67,72 +120,153 @@ TERMINATE:
 }
 
 // Function used to find the starting base for the (primal or dual) simplex.
+// basis[i-1] is the unit column e_i, the first one with a zero reduced cost.
+void tableau_express_row(const Tableau *tab, const size_t *basis, size_t rows,
+        const Fraction *row, size_t n, size_t width, Fraction *out) {
+    size_t cols = tableau_stride(tab);
+
+    for (size_t j = 0; j < width; j++)
+        out[j] = j <= n ? row[j] : fraction_create(0, 1);
+
+    for (size_t i = 1; i <= rows; i++) {
+        size_t var = basis[i - 1];
+        if (var > n || row[var].num == 0) continue;
+        fraction_row_fms(out, &tab->data[i * cols], row[var], width);
+    }
+}
+
+int tableau_vertex(const Tableau *tab, const size_t *basis, size_t n, Fraction *x) {
+    size_t cols = tableau_stride(tab);
+    for (size_t j = 0; j <= n; j++) x[j] = fraction_create(0, 1);
+    for (size_t i = 1; i <= tab->m; i++) {
+        Fraction rhs = tab->data[i * cols];
+        if (rhs.den <= 0) return 1;
+        if (basis[i - 1] <= n) x[basis[i - 1]] = rhs;
+    }
+    return tab->data[0].den <= 0;
+}
+
 int search_starting_basis(Tableau *tab, size_t *basis) {
-    int cols = tab->n + 1;
+    size_t cols = tableau_stride(tab);
     size_t idx = 0;
     Fraction one = fraction_create(1, 1);
 
-    for (size_t j = 1; j <= tab->n; j++) {
-        
-        // Check whether reduced cost is zero.
-        if (tab->data[j].num != 0) continue;
+    // Row of the 1 of every identity column candidate (0 = none yet, NOT_UNIT
+    // = not an identity column). The rows are scanned in order, so that an
+    // out-of-core tableau is read sequentially.
+    const size_t NOT_UNIT = (size_t) -1;
+    ArenaMark mark = tab->arena ? arena_mark(tab->arena) : (ArenaMark) {0};
+    size_t *one_row = arena_alloc(tab->arena, (tab->n + 1) * sizeof(size_t));
+    if (one_row == NULL) {
+        fprintf(stderr, "Error - Not enough memory to search the basis.\n");
+        return 1;
+    }
 
-        // Check if there is an identity column.
-        char one_found = 0;
-        char in_basis = 1;
+    // Check whether reduced cost is zero.
+    for (size_t j = 1; j <= tab->n; j++)
+        one_row[j] = tab->data[j].num != 0 ? NOT_UNIT : 0;
 
-        for (size_t i = 1; i <= tab->m; i++) {
-            Fraction elem = tab->data[i * cols + j];
+    // Check if there is an identity column.
+    for (size_t i = 1; i <= tab->m; i++) {
+        const Fraction *row = &tab->data[i * cols];
+        for (size_t j = 1; j <= tab->n; j++) {
+            Fraction elem = row[j];
+            if (one_row[j] == NOT_UNIT || elem.num == 0) continue;
 
             if (fraction_greater(elem, one) || elem.num < 0) {
-                in_basis = 0;
-                break;
+                one_row[j] = NOT_UNIT;
             } else if (fraction_equal(elem, one)) {
-                if (one_found) {
-                    in_basis = 0;
-                    break;
-                }
-                one_found = 1;
+                one_row[j] = one_row[j] ? NOT_UNIT : i;
             }
         }
+    }
 
-        // Save to basis, if necessary.
-        if (in_basis) {
-            basis[idx] = j;
+    // Save to basis, if necessary. Each row takes one column only.
+    for (size_t i = 0; i < tab->m; i++) basis[i] = 0;
+    for (size_t j = 1; j <= tab->n; j++) {
+        size_t r = one_row[j];
+        if (r != 0 && r != NOT_UNIT && !basis[r - 1]) {
+            basis[r - 1] = j;
             idx++;
         }
     }
 
+    if (tab->arena) arena_rewind(tab->arena, mark);
+    else free(one_row);
+
     // If a full basis was not found, report the error.
     if (idx != tab->m) return 1;
 
     return 0;
 }
 
-void pivot_operations(Tableau *tab, size_t h, size_t t, int minipivot, size_t row) {
-    int cols = tab->n + 1;
-    Fraction save = tab->data[t * cols + h];
+// Ask the kernel to read [p, p + len) ahead (page aligned).
+static void prefetch_pages(const void *p, size_t len) {
+    uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t) p & ~(page - 1);
+    madvise((void*) start, (uintptr_t) p + len - start, MADV_WILLNEED);
+}
+
+// Eliminate column h from every row but t, a block of rows at a time. The
+// result is the same as the row by row pass of pivot_operations().
+static void pivot_blocked(Tableau *tab, size_t h, size_t t) {
+    size_t cols = tableau_stride(tab);
+    size_t len = tab->n + 1;
+    const Fraction *pivot_row = &tab->data[t * cols];
+
+    size_t block = PIVOT_BLOCK_BYTES / (cols * sizeof(Fraction));
+    if (block == 0) block = 1;
+    if (block > PIVOT_MAX_BLOCK_ROWS) block = PIVOT_MAX_BLOCK_ROWS;
+    size_t window = PIVOT_READAHEAD_BYTES / (cols * sizeof(Fraction));
+    if (window < block) window = block;
+    Fraction factor[PIVOT_MAX_BLOCK_ROWS];
+
+    size_t next_readahead = 0; // First row not requested yet.
+    for (size_t i0 = 0; i0 <= tab->m; i0 += block) {
+        size_t rows = tab->m + 1 - i0 < block ? tab->m + 1 - i0 : block;
+        if (i0 + window / 2 >= next_readahead && next_readahead <= tab->m) {
+            size_t first = next_readahead > i0 ? next_readahead : i0;
+            size_t count = tab->m + 1 - first < window ? tab->m + 1 - first : window;
+            prefetch_pages(&tab->data[first * cols], count * cols * sizeof(Fraction));
+            next_readahead = first + count;
+        }
+
+        // Multipliers first: the tiles overwrite column h.
+        for (size_t r = 0; r < rows; r++) {
+            factor[r] = i0 + r == t ? fraction_create(0, 1) : tab->data[(i0 + r) * cols + h];
+        }
 
-    for (size_t j = 0; j <= tab->n; j++) {
-        tab->data[t * cols + j] = fraction_divide(tab->data[t * cols + j], save);
+        for (size_t j0 = 0; j0 < len; j0 += PIVOT_TILE) {
+            size_t width = len - j0 < PIVOT_TILE ? len - j0 : PIVOT_TILE;
+            for (size_t r = 0; r < rows; r++) {
+                fraction_row_fms(&tab->data[(i0 + r) * cols + j0], &pivot_row[j0],
+                        factor[r], width);
+            }
+        }
     }
+}
+
+void pivot_operations(Tableau *tab, size_t h, size_t t, int minipivot, size_t row) {
+    size_t cols = tableau_stride(tab);
+    size_t len = tab->n + 1;
+    Fraction *pivot_row = &tab->data[t * cols];
+
+    // Divide the pivot row by the pivot element.
+    fraction_row_scale(pivot_row, fraction_divide(fraction_create(1, 1),
+                pivot_row[h]), len);
 
     if (minipivot) {
         if (row != t && tab->data[row * cols + h].num != 0) {
-            save = tab->data[row * cols + h];
-            for (size_t j = 0; j <= tab->n; j++) {
-                Fraction tmp = fraction_multiply(save, tab->data[t * cols + j]);
-                tab->data[row * cols + j] = fraction_subtract(tab->data[row * cols + j], tmp);
-            }
+            Fraction save = tab->data[row * cols + h];
+            fraction_row_fms(&tab->data[row * cols], pivot_row, save, len);
         }
+    } else if (arena_is_mapped(tab->arena)) {
+        pivot_blocked(tab, h, t);
     } else {
         for (size_t i = 0; i <= tab->m; i++) {
             if (i != t) {
-                save = tab->data[i * cols + h];
-                for (size_t j = 0; j <= tab->n; j++) {
-                    Fraction tmp = fraction_multiply(save, tab->data[t * cols + j]);
-                    tab->data[i * cols + j] = fraction_subtract(tab->data[i * cols + j], tmp);
-                }
+                Fraction save = tab->data[i * cols + h];
+                fraction_row_fms(&tab->data[i * cols], pivot_row, save, len);
             }
         }
     }
@@ -141,15 +275,15 @@ void pivot_operations(Tableau *tab, size_t h, size_t t, int minipivot, size_t ro
 
 // Print the tableau in a nice way :).
 void pretty_print_tableau(Tableau *tab, size_t *basis) {
-    size_t cols = tab->n + 1;
+    size_t cols = tableau_stride(tab);
 
     const int col_width = 5;
     const int indent = 5;
 
     // Print the variables names as first row.
     printf("%*s", 10 + indent, "");
-    for (int j = 0; j < tab->n; j++) 
-        printf(ANSI_COLOR_GREEN "%*sx[%i]" ANSI_COLOR_RESET, col_width, "", j + 1);
+    for (size_t j = 0; j < tab->n; j++) 
+        printf(ANSI_COLOR_GREEN "%*sx[%lu]" ANSI_COLOR_RESET, col_width, "", j + 1);
     printf("\n");
 
     // Print first row of the table.
@@ -162,7 +296,7 @@ void pretty_print_tableau(Tableau *tab, size_t *basis) {
     printf("┐\n");
 
     // Now print the tableau.
-    for (int i = 0; i <= tab->m; i++) {
+    for (size_t i = 0; i <= tab->m; i++) {
 
         // Draw an horizontal line after row_0 of tableau.
         if (i == 1) {
@@ -186,7 +320,7 @@ void pretty_print_tableau(Tableau *tab, size_t *basis) {
         printf(ANSI_COLOR_GREEN "%6s " ANSI_COLOR_RESET, name);
 
         // Print row_i elements.
-        for (int j = 0; j <= tab->n; j++) {
+        for (size_t j = 0; j <= tab->n; j++) {
             Fraction elem = tab->data[i * cols + j];
 
             // Buffer that holds the string representation of 'elem'.
@@ -216,31 +350,16 @@ void pretty_print_tableau(Tableau *tab, size_t *basis) {
 // Return 1 if the problem is unbounded, 0 otherwise.
 // If the problem is not unbounded, then 't' contains the pivot row index.
 char unbounded_check(Tableau *tab, size_t h, size_t *t, size_t *basis) {
-    char unbounded = 1;
-    int cols = tab->n + 1;  // Numer of cols of the tableau.
-    Fraction min = {-1, 1}; // Used to compute the pivot row.
-
-    for (size_t i = 1; i <= tab->m; i++) {
-        Fraction *elem = &tab->data[i * cols + h]; // Element of the tableau.
-
-        if (elem->num > 0) {
-            unbounded = 0;
+    size_t cols = tableau_stride(tab); // Row length of the tableau.
 
-            // 'tmp' is the new minumum candidate.
-            Fraction tmp = fraction_divide(tab->data[i * cols], *elem);
+    // Min ratio b_i / a_ih over the rows with a_ih > 0, ties broken by
+    // Bland's rule (smallest index of the basic variable).
+    size_t i = fraction_min_ratio(&tab->data[cols], &tab->data[cols + h],
+            cols, tab->m, 1, basis);
+    if (i == tab->m) return 1;
 
-            if (min.num == -1 || fraction_less(tmp, min)) {
-                // Update candidate due to smallest value.
-                min = tmp; // Update the minumum.
-                *t = i;    // Update the pivot row.
-            } else if (fraction_equal(tmp, min) && basis[i-1] < basis[*t-1]) {
-                // Update candidate due to Bland's rule.
-                *t = i; // Update the pivot row.
-            }
-        }
-    }
-
-    return unbounded;
+    *t = i + 1; // Update the pivot row.
+    return 0;
 }
 
 // Return 1 if the tablau is optimal, 0 otherwise.
@@ -260,6 +379,224 @@ char optimality_check(Tableau *tab, size_t *h) {
     return optimal;
 }
 
+// Default solver parameters.
+static const SolverParams default_params = {
+    100000,     // max_iterations
+    DEGEN_NONE, // degeneracy
+    50,         // stall_threshold
+    1,          // seed
+    1,          // threads
+    1,          // cuts_per_round
+    0.5,        // cut_ortho_weight
+    0.1,        // cut_min_orthogonality
+    NULL,       // checkpoint_path
+    60,         // checkpoint_interval
+    NULL,       // cancel
+    1,          // verbose
+    0,          // backend (BACKEND_CLASSIC)
+    8,          // colgen_batch
+    8,          // lazy_batch
+    0,          // time_limit
+    NULL,       // progress
+    0,          // network
+    1,          // cut_families (Gomory only)
+    1000,       // cut_max_scale
+    NULL,       // cut_stats
+    0,          // heuristics (none)
+    1,          // heuristic_time
+    0,          // heuristic_iterations
+    0,          // gap_limit
+    NULL,       // incumbent
+    NULL        // scope
+};
+
+void solver_params_default(SolverParams *params) {
+    *params = default_params;
+}
+
+const SolverParams *tableau_params(const Tableau *tab) {
+    return tab->params ? tab->params : &default_params;
+}
+
+// Seconds elapsed on a monotonic clock.
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Limits of the solve running on this thread.
+static _Thread_local struct {
+    int depth;          // # of nested solvers.
+    SolveScope *scope;  // Clock and pivots of the solve: 'own', or the scope
+                        // of the solve this thread works for.
+    SolveScope own;
+} solve_ctx;
+
+void solve_begin(const SolverParams *params) {
+    if (solve_ctx.depth++) return;
+    if (params->scope) {
+        solve_ctx.scope = params->scope;
+        return;
+    }
+    solve_ctx.scope = &solve_ctx.own;
+    solve_ctx.own.start = monotonic_seconds();
+    atomic_store(&solve_ctx.own.pivots, 0);
+
+    if (params->progress) {
+        atomic_store(&params->progress->pivots, 0);
+        atomic_store(&params->progress->rounds, 0);
+        atomic_store(&params->progress->seconds, 0);
+    }
+}
+
+void solve_end(void) {
+    if (--solve_ctx.depth == 0) solve_ctx.scope = NULL;
+}
+
+SolveScope *solve_scope(void) {
+    return solve_ctx.scope;
+}
+
+long solve_pivots(void) {
+    return solve_ctx.scope ? atomic_load(&solve_ctx.scope->pivots) : 0;
+}
+
+void solve_add_pivots(long pivots) {
+    if (solve_ctx.scope) atomic_fetch_add(&solve_ctx.scope->pivots, pivots);
+}
+
+double solve_elapsed(void) {
+    return solve_ctx.scope ? monotonic_seconds() - solve_ctx.scope->start : 0;
+}
+
+int solve_stop(const SolverParams *params, int *status) {
+    if (params->max_iterations > 0 && solve_pivots() >= params->max_iterations) {
+        *status = ITERATION_LIMIT;
+        return 1;
+    }
+    if (solver_cancelled(params)) {
+        *status = CANCELLED;
+        return 1;
+    }
+    if (params->time_limit > 0 || params->progress) {
+        double elapsed = solve_elapsed();
+        if (params->progress) atomic_store(&params->progress->seconds, elapsed);
+        if (params->time_limit > 0 && elapsed >= params->time_limit) {
+            *status = TIME_LIMIT;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void solve_pivot(const SolverParams *params, double cost) {
+    solve_add_pivots(1);
+    if (params->progress) {
+        atomic_fetch_add(&params->progress->pivots, 1);
+        atomic_store(&params->progress->objective, cost);
+    }
+}
+
+void solve_round(const SolverParams *params, double cost) {
+    if (params->progress) {
+        atomic_fetch_add(&params->progress->rounds, 1);
+        atomic_store(&params->progress->objective, cost);
+    }
+}
+
+void solver_log(const SolverParams *params, const char *fmt, ...) {
+    if (!params->verbose) return;
+
+    va_list args;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+void pivot_aux_column(Tableau *tab, Fraction *col, size_t h, size_t t) {
+    size_t cols = tableau_stride(tab);
+
+    col[t] = fraction_divide(col[t], tab->data[t * cols + h]);
+    for (size_t i = 0; i <= tab->m; i++) {
+        Fraction elem = tab->data[i * cols + h];
+        if (i != t && elem.num != 0)
+            col[i] = fraction_subtract(col[i], fraction_multiply(elem, col[t]));
+    }
+}
+
+// Lexicographic ratio test: among the rows with minimum ratio, choose the one
+// whose row of B^-1 divided by the pivot column entry is lexicographically
+// smallest. The columns of B^-1 are those of the basis 'ref' the rule was
+// started from (they were the identity then). The rows of [rhs | B^-1] stay
+// lexicographically positive, so no basis repeats: the rule cannot cycle.
+// Returns 1 if the problem is unbounded.
+static char lexicographic_unbounded_check(Tableau *tab, size_t h, size_t *t,
+        size_t *basis, const size_t *ref) {
+    char unbounded = unbounded_check(tab, h, t, basis);
+    if (unbounded) return unbounded;
+
+    size_t cols = tableau_stride(tab);
+    Fraction min = fraction_divide(tab->data[*t * cols], tab->data[*t * cols + h]);
+
+    for (size_t i = 1; i <= tab->m; i++) {
+        Fraction elem = tab->data[i * cols + h];
+        if (i == *t || elem.num <= 0) continue;
+
+        Fraction ratio = fraction_divide(tab->data[i * cols], elem);
+        if (fraction_not_equal(ratio, min)) continue;
+
+        // Tie: compare the two rows of B^-1. They are never equal, B^-1 is
+        // not singular.
+        Fraction piv = tab->data[*t * cols + h];
+        for (size_t k = 0; k < tab->m; k++) {
+            Fraction a = fraction_divide(tab->data[i * cols + ref[k]], elem);
+            Fraction b = fraction_divide(tab->data[*t * cols + ref[k]], piv);
+            if (fraction_less(a, b)) {
+                *t = i;
+                break;
+            } else if (fraction_greater(a, b)) {
+                break;
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Pivot the columns of 'saved' (a basis of the same tableau) back into the
+// basis, at most m pivots.
+static void restore_basis(Tableau *tab, size_t *basis, const size_t *saved) {
+    size_t cols = tableau_stride(tab);
+    for (size_t k = 0; k < tab->m; k++) {
+        size_t h = saved[k];
+        char in_basis = 0;
+        for (size_t i = 0; i < tab->m && !in_basis; i++) in_basis = basis[i] == h;
+        if (in_basis) continue;
+
+        // A row whose basic variable is not in 'saved' has a nonzero in
+        // column h, otherwise the columns of 'saved' would be dependent.
+        for (size_t i = 1; i <= tab->m; i++) {
+            char kept = 0;
+            for (size_t l = 0; l < tab->m && !kept; l++) kept = saved[l] == basis[i - 1];
+            if (kept || tab->data[i * cols + h].num == 0) continue;
+            pivot_operations(tab, h, i, 0, 0);
+            basis[i - 1] = h;
+            break;
+        }
+    }
+}
+
+// Small xorshift generator, used for the perturbation.
+static unsigned int next_random(unsigned int *state) {
+    unsigned int x = *state ? *state : 1;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
 int simplex(Tableau *tab, size_t *basis) {
     char unbounded = 0; // True if the problem is unbounded.
     char optimal = 0;   // True if found an optimal solution.
@@ -269,67 +606,174 @@ int simplex(Tableau *tab, size_t *basis) {
     size_t h = -1; // Index of the variable that enters the basis.
     size_t t = 0; // Pivot row.
 
-    size_t cols = tab->n + 1;
+    size_t cols = tableau_stride(tab);
+
+    // Degeneracy handling.
+    const SolverParams *params = tableau_params(tab);
+    int stall = 0;          // # of consecutive pivots with no progress.
+    size_t *ref = NULL;     // Basis when stalling started: the columns of B^-1
+                            // for the lexicographic rule, the basis restored
+                            // if the perturbation is not solved to the end.
+    char lexicographic = 0; // True if the lexicographic rule is active.
+    Fraction *delta = NULL; // Perturbation of the rhs (in current basis).
+    unsigned int seed = params->seed;
+
+    char stopped = 0;  // True if a limit was hit.
+    int status = OPTIMAL;
+    solve_begin(params);
 
     // Start the simplex algorithm.
     while (!optimal && !unbounded) {
-        printf("Current tableau - itr: %d\n", itr);
-        pretty_print_tableau(tab, basis);
+        solver_log(params, "Current tableau - itr: %d\n", itr);
+        if (params->verbose) pretty_print_tableau(tab, basis);
+
+        // Iteration limit, time limit or cancellation.
+        if (solve_stop(params, &status)) {
+            solver_log(params, "%*sStopped: %s.\n", 8, "",
+                    status == CANCELLED ? "cancelled" : "limit reached");
+            stopped = 1;
+            break;
+        }
  
         // Optimality check.
         optimal = optimality_check(tab, &h);
 
         if (!optimal) {
-            printf("%*sx[%lu] enters the basis.\n", 8, "", h);
+            solver_log(params, "%*sx[%lu] enters the basis.\n", 8, "", h);
+
+            if (lexicographic)
+                unbounded = lexicographic_unbounded_check(tab, h, &t, basis, ref);
+            else
+                unbounded = unbounded_check(tab, h, &t, basis);
 
-            unbounded = unbounded_check(tab, h, &t, basis);
             if (!unbounded) {
-                printf("%*sCurrent pivot element = ", 8, "");
-                fraction_print(tab->data[t * cols + h]);
-                printf("\n%*sx[%lu] leaves the basis.\n", 8, "", basis[t - 1]);
+                if (params->verbose) {
+                    printf("%*sCurrent pivot element = ", 8, "");
+                    fraction_print(tab->data[t * cols + h]);
+                    printf("\n%*sx[%lu] leaves the basis.\n", 8, "", basis[t - 1]);
+                }
+
+                Fraction obj = tab->data[0];
+                if (delta) pivot_aux_column(tab, delta, h, t);
                 pivot_operations(tab, h, t, 0, 0);
 
                 basis[t - 1] = h; // Update basis;
                 itr += 1;         // Increment iteration.
-                printf("\n");
+                solve_pivot(params, tableau_cost(tab));
+                solver_log(params, "\n");
+
+                // Stalling detection.
+                if (fraction_equal(obj, tab->data[0])) stall++;
+                else stall = 0;
+
+                if (stall >= params->stall_threshold && ref == NULL
+                        && params->degeneracy != DEGEN_NONE) {
+                    ref = arena_alloc(tab->arena, tab->m * sizeof(size_t));
+                    if (ref != NULL) memcpy(ref, basis, tab->m * sizeof(size_t));
+                    if (ref != NULL && params->degeneracy == DEGEN_PERTURB)
+                        delta = arena_alloc(tab->arena, (tab->m + 1) * sizeof(Fraction));
+
+                    if (ref == NULL || (params->degeneracy == DEGEN_PERTURB && delta == NULL)) {
+                        fprintf(stderr, "Error - Not enough memory to handle stalling.\n");
+                    } else if (params->degeneracy == DEGEN_LEXICOGRAPHIC) {
+                        solver_log(params, "%*sStalling: switching to the"
+                                " lexicographic ratio test.\n\n", 8, "");
+                        lexicographic = 1;
+                    } else {
+                        // Each rhs moves by a few units of its own
+                        // denominator: no new factor enters the denominators
+                        // of the tableau. Rows whose rhs would overflow are
+                        // left alone.
+                        solver_log(params, "%*sStalling: perturbing the rhs.\n\n", 8, "");
+                        for (size_t i = 0; i <= tab->m; i++) {
+                            Fraction rhs = tab->data[i * cols];
+                            long long r = i ? 1 + next_random(&seed) % 16 : 0;
+                            if ((long long) rhs.num + r > INT_MAX) r = 0;
+                            delta[i] = fraction_create((int) r, rhs.den);
+                            tab->data[i * cols] = fraction_add(rhs, delta[i]);
+                        }
+                    }
+                }
             }
         }
     }
 
+    // Remove the perturbation, then restore primal feasibility: the reduced
+    // costs do not depend on the rhs, so an optimal basis is still dual
+    // feasible and the dual simplex cleans it up. A basis stopped by a limit
+    // is neither: the one the perturbation started from is restored.
+    if (delta) {
+        solver_log(params, "%*sRemoving the perturbation.\n", 8, "");
+        char infeasible = 0;
+        for (size_t i = 0; i <= tab->m; i++) {
+            tab->data[i * cols] = fraction_subtract(tab->data[i * cols], delta[i]);
+            if (i && tab->data[i * cols].num < 0) infeasible = 1;
+        }
+        arena_free(tab->arena, delta);
+
+        if (optimal && infeasible) {
+            solver_log(params, "\n### Clean up (dual simplex) ###\n");
+            status = dual_simplex(tab, basis);
+            if (status != OPTIMAL) restore_basis(tab, basis, ref);
+            arena_free(tab->arena, ref);
+            solve_end();
+            return status;
+        }
+        if (infeasible) {
+            solver_log(params, "%*sRestoring the basis before the perturbation.\n", 8, "");
+            restore_basis(tab, basis, ref);
+        }
+    }
+    arena_free(tab->arena, ref);
+    solve_end();
+
     // Check the result.
     if (optimal) {
-        printf("%*sFound an optimal solution.\n", 8, "");
-        Fraction cost = fraction_chg_sign(tab->data[0]);
-        printf("%*sCost = ", 8, ""); fraction_print(cost); printf("\n");
+        if (params->verbose) {
+            printf("%*sFound an optimal solution.\n", 8, "");
+            Fraction cost = fraction_chg_sign(tab->data[0]);
+            printf("%*sCost = ", 8, ""); fraction_print(cost); printf("\n");
+        }
         return OPTIMAL;
     }
 
+    if (stopped) return status;
+
     return UNBOUNDED;
 }
 
 // Phase 1 of Two phases simplex method.
 int phase_one(Tableau *tab, size_t *basis) {
+    const SolverParams *params = tableau_params(tab);
     int status = INFEASIBLE; // Referred to orginal problem (not artificial).
     // Create the tableau associated to the artificial problem.
     Tableau artificial;
     artificial.n = tab->n + tab->m; // Add 'm' artificial variables.
     artificial.m = tab->m;
     
+    artificial.arena = tab->arena;
+    artificial.params = tab->params;
+    artificial.stride = 0;
+    artificial.row_cap = 0;
+
     // Allocate memory for the tableau.
     size_t cols_a = artificial.n + 1; // Tableau cols - artificial.
     size_t sz = cols_a * (artificial.m + 1); // Tableau size.
-    artificial.data = (Fraction*) malloc(sz * sizeof(Fraction));
+    artificial.data = arena_alloc(tab->arena, sz * sizeof(Fraction));
 
     if (artificial.data == NULL) {
         fprintf(stderr, "Error - No enough memory to create artificial probelm.");
         goto TERMINATE;
     }
 
-    // Copy the of original tableau.
-    size_t cols_o = tab->n + 1; // Tableau cols - original.
+    // Copy the of original tableau. Rows with a negative rhs are multiplied
+    // by -1, so that the artificial basis is feasible.
+    size_t cols_o = tableau_stride(tab); // Tableau cols - original.
     for (size_t i = 1; i <= tab->m; i++) {
+        char negate = tab->data[i * cols_o].num < 0;
         for (size_t j = 0; j <= tab->n; j++) {
-            artificial.data[i * cols_a + j] = tab->data[i * cols_o + j];
+            Fraction elem = tab->data[i * cols_o + j];
+            artificial.data[i * cols_a + j] = negate ? fraction_chg_sign(elem) : elem;
         }
     }
 
@@ -365,14 +809,18 @@ int phase_one(Tableau *tab, size_t *basis) {
         basis[j] = j + tab->n + 1;
     }
 
-    // Solve the artificial problem. Don't need to check for the status
-    // since the artificial problem is never unbounded.
-    simplex(&artificial, basis);
+    // Solve the artificial problem. The artificial problem is never
+    // unbounded, so only a stopped solve has to be checked.
+    int art_status = simplex(&artificial, basis);
+    if (art_status != OPTIMAL) {
+        status = art_status;
+        goto TERMINATE;
+    }
 
     // Check solution status.
-    Fraction cost = fraction_chg_sign(tab->data[0]);
+    Fraction cost = fraction_chg_sign(artificial.data[0]);
     if (cost.num != 0) {
-        printf("Original problem is infeasible\n");
+        solver_log(params, "Original problem is infeasible\n");
         goto TERMINATE;
     }
 
@@ -380,16 +828,16 @@ int phase_one(Tableau *tab, size_t *basis) {
     // Check degeneracy cases.
     for (size_t i = 0; i < tab->m; i++) {
         if (basis[i] > tab->n) { // Found degeneracy.
-            printf("Found degeneracy: variable x[%lu].\n", basis[i]);
+            solver_log(params, "Found degeneracy: variable x[%lu].\n", basis[i]);
 
             // Find first element in row (i+1) of the tableau that is != 0.
             int remove_line = 1;
             for (size_t j = 1; j <= tab->n; j++) {
 
-                Fraction elem = tab->data[(i+1) * cols_o + j];
+                Fraction elem = artificial.data[(i+1) * cols_a + j];
                 if (elem.num != 0) {
-                    printf("x[%lu] enters the basis, x[%lu] leaves.\n", j, basis[i]);
-                    pivot_operations(tab, j, i+1, 0, 0);
+                    solver_log(params, "x[%lu] enters the basis, x[%lu] leaves.\n", j, basis[i]);
+                    pivot_operations(&artificial, j, i+1, 0, 0);
                     basis[i] = j;    // Update basis.
                     remove_line = 0; // No need to remove the line.
                     break;
@@ -420,7 +868,37 @@ int phase_one(Tableau *tab, size_t *basis) {
     }
 
 TERMINATE:
-    free_and_null((char**) &artificial.data);
+    arena_free(tab->arena, artificial.data);
+
+    return status;
+}
+
+int two_phase_simplex(Tableau *tab, size_t *basis) {
+    const SolverParams *params = tableau_params(tab);
+    solve_begin(params);
+
+    // Search basis. It is a starting basis only if it is primal feasible.
+    int status = search_starting_basis(tab, basis);
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 1; !status && i <= tab->m; i++)
+        if (tab->data[i * cols].num < 0) status = 1;
+
+    if (status) {
+        solver_log(params, "No starting basis was found...\n");
+
+        // Phase 1.
+        solver_log(params, "### Starting phase one... ###\n");
+        status = phase_one(tab, basis);
+        if (status != FEASIBLE) {
+            solve_end();
+            return status;
+        }
+    }
+
+    // Simplex (phase 2).
+    solver_log(params, "\n### Starting phase two... ###\n");
+    status = simplex(tab, basis);
+    solve_end();
 
     return status;
 }
@@ -429,8 +907,8 @@ TERMINATE:
 // If the tablau is not optimal, then 't' contains the index of the pivot row.
 int dual_optimality_check(Tableau *tab, size_t *t, size_t *basis) {
     int optimal = 1;
-    int cols = tab->n + 1;
-    size_t tmp = cols; // Tmp index of the var that leaves the basis.
+    size_t cols = tableau_stride(tab);
+    size_t tmp = tab->n + 1; // Tmp index of the var that leaves the basis.
 
     for (size_t i = 1; i <= tab->m; i++) {
         // Update if element is negative and check Bland's rule.
@@ -448,27 +926,15 @@ int dual_optimality_check(Tableau *tab, size_t *t, size_t *basis) {
 // If the problem is not unbounded, then 'h' contains the variable that enters
 // the basis.
 char dual_unbounded_check(Tableau *tab, size_t t, size_t *h) {
-    char unbounded = 1;
-    int cols = tab->n + 1;  // Numer of cols of the tableau.
-    Fraction min = {-1, 1}; // Used to compute the pivot row.
-
-    for (size_t j = 1; j <= tab->n; j++) {
-        Fraction *elem = &tab->data[t * cols + j]; // Element of the tableau.
+    size_t cols = tableau_stride(tab); // Row length of the tableau.
 
-        if (elem->num < 0) {
-            unbounded = 0;
+    // Min ratio |c_j / a_tj| over the columns with a_tj < 0.
+    size_t j = fraction_min_ratio(&tab->data[1], &tab->data[t * cols + 1],
+            1, tab->n, -1, NULL);
+    if (j == tab->n) return 1;
 
-            // 'tmp' is the new minumum candidate.
-            Fraction tmp = fraction_divide(tab->data[j], *elem);
-            tmp = fraction_abs(tmp);
-
-            if (min.num == -1 || fraction_less(tmp, min)) {
-                min = tmp; // Update the minumum.
-                *h = j;    // Update the leaving candidate.
-            }
-        }
-    }
-    return unbounded;
+    *h = j + 1; // Update the entering candidate.
+    return 0;
 }
 
 int dual_simplex(Tableau *tab, size_t *basis) {
@@ -480,42 +946,62 @@ int dual_simplex(Tableau *tab, size_t *basis) {
     size_t h = -1; // Index of the variable that enters the basis.
     size_t t = 0; // Pivot row.
 
-    size_t cols = tab->n + 1;
+    size_t cols = tableau_stride(tab);
+    const SolverParams *params = tableau_params(tab);
+    char stopped = 0;  // True if a limit was hit.
+    int status = OPTIMAL;
+    solve_begin(params);
 
     // Start the simplex algorithm.
     while (!optimal && !unbounded) {
-        printf("Current tableau - itr: %d\n", itr);
-        pretty_print_tableau(tab, basis);
+        solver_log(params, "Current tableau - itr: %d\n", itr);
+        if (params->verbose) pretty_print_tableau(tab, basis);
+
+        // Iteration limit, time limit or cancellation.
+        if (solve_stop(params, &status)) {
+            solver_log(params, "%*sStopped: %s.\n", 8, "",
+                    status == CANCELLED ? "cancelled" : "limit reached");
+            stopped = 1;
+            break;
+        }
  
         // Optimality check.
         optimal = dual_optimality_check(tab, &t, basis);
 
         if (!optimal) {
-            printf("%*sx[%lu] leaves the basis.\n", 8, "", basis[t - 1]);
+            solver_log(params, "%*sx[%lu] leaves the basis.\n", 8, "", basis[t - 1]);
 
             unbounded = dual_unbounded_check(tab, t, &h);
 
             if (!unbounded) {
-                printf("%*sCurrent pivot element = ", 8, "");
-                fraction_print(tab->data[t * cols + h]);
-                printf("\n%*sx[%lu] enters the basis.\n", 8, "", h);
+                if (params->verbose) {
+                    printf("%*sCurrent pivot element = ", 8, "");
+                    fraction_print(tab->data[t * cols + h]);
+                    printf("\n%*sx[%lu] enters the basis.\n", 8, "", h);
+                }
                 pivot_operations(tab, h, t, 0, 0);
 
                 basis[t - 1] = h; // Update basis;
                 itr += 1;         // Increment iteration.
-                printf("\n");
+                solve_pivot(params, tableau_cost(tab));
+                solver_log(params, "\n");
             }
         }
     }
+    solve_end();
 
     // Check the result.
     if (optimal) {
-        printf("%*sFound an optimal solution.\n", 8, "");
-        Fraction cost = fraction_chg_sign(tab->data[0]);
-        printf("%*sCost = ", 8, ""); fraction_print(cost); printf("\n");
+        if (params->verbose) {
+            printf("%*sFound an optimal solution.\n", 8, "");
+            Fraction cost = fraction_chg_sign(tab->data[0]);
+            printf("%*sCost = ", 8, ""); fraction_print(cost); printf("\n");
+        }
         return OPTIMAL;
     }
 
+    if (stopped) return status;
+
     return UNBOUNDED;
 }
 
@@ -523,7 +1009,7 @@ int dual_simplex(Tableau *tab, size_t *basis) {
 // If the solution is not integer, then in 'row_idx' is stored the row index
 // of the first non integer variable.
 int check_integrality(Tableau *tab, size_t *row_idx) {
-    size_t cols = tab->n + 1;
+    size_t cols = tableau_stride(tab);
     for (size_t i = 1; i <= tab->m; i++) {
         Fraction elem = tab->data[i * cols];
         if (elem.den != 1) {
@@ -535,116 +1021,280 @@ int check_integrality(Tableau *tab, size_t *row_idx) {
 }
 
 int augment_tableau(Tableau *tab, size_t new_n, size_t new_m) {
-    // Check if augmetation is not needed.
-    if (new_n <= tab->n || new_m <= tab->m) {
+    // Check if augmetation is not needed. Rows or columns alone can grow.
+    if (new_n < tab->n || new_m < tab->m || (new_n == tab->n && new_m == tab->m)) {
         fprintf(stderr, "Error - Augmentation is not needed since the new size"
-                        " = old size.\n");
+                        " <= old size.\n");
         return 1;
     }
 
-    size_t old_cols = tab->n + 1; // Tableau nuber of columns.
-    size_t new_cols = new_n + 1; // Augmented tableau nuber of columns.
-    Fraction *aug_tab = NULL; // The augmented tableau.
-
-    // Compute the size of the augmented tableau.
-    size_t old_len = (tab->m + 1) * (tab->n + 1);
-    size_t new_len = old_len + new_m + new_n + 3;
+    size_t old_cols = tableau_stride(tab); // Allocated columns.
+    size_t old_rows = tab->row_cap ? tab->row_cap : tab->m + 1; // Allocated rows.
 
-    // Allocate space for the augmented tableau.
-    aug_tab = malloc(new_len * sizeof(Fraction));
-    if (aug_tab == NULL) {
-        fprintf(stderr, "Error - Not enough space for augmented tableau.\n");
-        return 1;
+    // Enough capacity: nothing to move.
+    if (new_n + 1 <= old_cols && new_m + 1 <= old_rows) {
+        tab->n = new_n;
+        tab->m = new_m;
+        return 0;
     }
 
-    // Copy the data in the augmented tableau.
-    for (size_t i = 0; i <= tab->m; i++) {
-        for (size_t j = 0; j <= tab->n; j++) {
-            aug_tab[i * new_cols + j] = tab->data[i * old_cols + j];
+    // Grow both dimensions by 1.5x, so that a sequence of augmentations
+    // (one per cut) costs amortized O(m + n) per row/column added.
+    size_t new_cols = old_cols;
+    if (new_n + 1 > new_cols) new_cols = new_n + 1 + (new_n + 1) / 2;
+    size_t new_rows = old_rows;
+    if (new_m + 1 > new_rows) new_rows = new_m + 1 + (new_m + 1) / 2;
+
+    Fraction *aug_tab = NULL; // The augmented tableau.
+
+    if (new_cols == old_cols) {
+        // Same row length: rows can be extended in place.
+        aug_tab = arena_realloc(tab->arena, tab->data,
+                old_rows * old_cols * sizeof(Fraction),
+                new_rows * new_cols * sizeof(Fraction));
+        if (aug_tab == NULL) {
+            fprintf(stderr, "Error - Not enough space for augmented tableau.\n");
+            return 1;
+        }
+    } else {
+        // Allocate space for the augmented tableau.
+        aug_tab = arena_alloc(tab->arena, new_rows * new_cols * sizeof(Fraction));
+        if (aug_tab == NULL) {
+            fprintf(stderr, "Error - Not enough space for augmented tableau.\n");
+            return 1;
+        }
+
+        // Copy the data in the augmented tableau.
+        for (size_t i = 0; i <= tab->m; i++) {
+            for (size_t j = 0; j <= tab->n; j++) {
+                aug_tab[i * new_cols + j] = tab->data[i * old_cols + j];
+            }
         }
-    }
 
-    // Free memory of old tableau.
-    free_and_null((char**) &tab->data);
+        // Free memory of old tableau.
+        arena_free(tab->arena, tab->data);
+    }
 
     // Finally augment the tableau.
     tab->data = aug_tab;
-    tab->n += 1;
-    tab->m += 1;
+    tab->stride = new_cols;
+    tab->row_cap = new_rows;
+    tab->n = new_n;
+    tab->m = new_m;
 
     return 0;
 }
 
-int cutting_plane(Tableau *tab, size_t *basis) {
-    // Search basis.
-    int status = search_starting_basis(tab, basis);
+int append_rows(Tableau *tab, size_t **basis_ptr, size_t k) {
+    size_t old_n = tab->n;
+    size_t old_m = tab->m;
+    if (augment_tableau(tab, old_n + k, old_m + k)) return 1;
+
+    // Write all zeros in the new columns (except the slacks).
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i <= tab->m; i++)
+        for (size_t j = old_n + 1; j <= tab->n; j++)
+            tab->data[i * cols + j] = fraction_create(0, 1);
+    for (size_t r = 0; r < k; r++)
+        tab->data[(old_m + 1 + r) * cols + old_n + 1 + r] = fraction_create(1, 1);
+
+    // Augment basis.
+    size_t *aug_basis = arena_realloc(tab->arena, *basis_ptr,
+            old_m * sizeof(size_t), tab->m * sizeof(size_t));
+    if (aug_basis == NULL) {
+        fprintf(stderr, "Error - Cannot augment basis.\n");
+        return 1;
+    }
+    *basis_ptr = aug_basis;
 
-    if (status) {
-        printf("No starting basis was found...\n");
+    // Add new variables to the basis.
+    for (size_t r = 0; r < k; r++)
+        aug_basis[old_m + r] = old_n + 1 + r;
 
-        // Phase 1.
-        printf("### Starting phase one... ###\n");
-        status = phase_one(tab, basis);
-        if (status == INFEASIBLE) {
-            return status;
-        }
-    }
+    return 0;
+}
 
-    // Simplex (phase 2).
-    printf("\n### Starting phase two... ###\n");
-    status = simplex(tab, basis);
-    if (status == UNBOUNDED) {
-        return status;
-    }
+// Rounds of the cutting plane algorithm, starting from round 'first_itr' with
+// an optimal tableau and the cuts of 'pool'. 'orig' holds the rows of the
+// problem before the cuts (NULL if unknown). 'resumed' is set if the state
+// comes from a snapshot.
+static int cutting_plane_rounds(Tableau *tab, size_t **basis_ptr, CutPool *pool,
+        const OriginalProblem *orig, size_t first_itr, char resumed) {
+    const SolverParams *params = tableau_params(tab);
+    size_t *basis = *basis_ptr;
+    int status = OPTIMAL;
 
-    // Cutting plane algorithm.
     size_t row_idx = 0; // Index of the first non integer variable.
 
-    for (size_t itr = 0; !check_integrality(tab, &row_idx); itr++) {
-        printf("\n### Cutting Plane - itr: %lu ###\n", itr);
+    CutWorkspace ws; // Buffers of the separation rounds.
+    cut_workspace_init(&ws);
 
-        // Augment the tableau.
-        status = augment_tableau(tab, tab->n + 1, tab->m + 1);
-        if (status) {
-            status = INFEASIBLE;
-            break;
-        }
+    // The first state is always saved, unless it is the one we resumed from.
+    char saved = resumed;
+    double last_save = monotonic_seconds();
 
-        // Write all zeros in the last column (except last position).
-        size_t cols = tab->n + 1;
-        for (size_t i = 0; i < tab->m; i++)
-            tab->data[i * cols + tab->n] = fraction_create(0, 1);
+    // Incumbent of the heuristics, kept here if the caller has no use for it.
+    Incumbent local;
+    Incumbent *inc = params->incumbent;
+    if (inc == NULL && params->heuristics) {
+        incumbent_init(&local);
+        inc = &local;
+    }
 
-        // Write last row.
-        for (size_t j = 0; j < tab->n; j++) {
-            Fraction elem = tab->data[row_idx * cols + j];
-            Fraction res = fraction_subtract(elem, fraction_floor(elem));
-            tab->data[tab->m * cols + j] = fraction_chg_sign(res);
+    char gap_reached = 0;
+    for (size_t itr = first_itr; !check_integrality(tab, &row_idx); itr++) {
+        if (solve_stop(params, &status)) break;
+
+        // Heuristics from the vertex of the round: stop as soon as their
+        // solution is close enough to the bound of the relaxation.
+        if (inc) {
+            if (orig && params->heuristics) run_heuristics(tab, basis, orig, inc);
+            incumbent_bound(inc, orig, fraction_chg_sign(tab->data[0]));
+            if (inc->found && inc->gap <= params->gap_limit) {
+                solver_log(params, "Gap %.4g of the incumbent, stopping.\n", inc->gap);
+                status = inc->gap == 0 ? OPTIMAL : FEASIBLE;
+                gap_reached = 1;
+                break;
+            }
         }
-        // Last entry in the last row is a 1.
-        tab->data[tab->m * cols + tab->n] = fraction_create(1, 1);
 
-        // Augment basis.
-        size_t *aug_basis = realloc(basis, tab->m * sizeof(Fraction));
-        if (aug_basis == NULL) {
-            fprintf(stderr, "Error - Cannot augment basis.\n");
+        if (params->checkpoint_path && (!saved
+                    || monotonic_seconds() - last_save >= params->checkpoint_interval)) {
+            if (!checkpoint_write(params->checkpoint_path, tab, basis, pool,
+                        PHASE_CUTTING_PLANE, itr)) {
+                solver_log(params, "Checkpoint written at itr %lu.\n", itr);
+                saved = 1;
+                last_save = monotonic_seconds();
+            }
+        }
+
+        solver_log(params, "\n### Cutting Plane - itr: %lu ###\n", itr);
+
+        // Select the cuts among the ones of all the separators.
+        SeparationInput in = {tab, basis, orig};
+        size_t n_cuts = separate_cuts(&in, pool, &ws);
+        if (!n_cuts) {
+            fprintf(stderr, "Error - No cut could be generated.\n");
             status = INFEASIBLE;
             break;
         }
-        basis = aug_basis;
 
-        // Add new variable to the basis.
-        basis[tab->m - 1] = tab->n;
+        // Augment the tableau: one row and one slack column per cut.
+        size_t old_n = tab->n;
+        size_t old_m = tab->m;
+        if (append_rows(tab, basis_ptr, n_cuts)) {
+            status = INFEASIBLE;
+            break;
+        }
+        basis = *basis_ptr;
+
+        // Write the new rows.
+        size_t cols = tableau_stride(tab);
+        for (size_t k = 0; k < n_cuts; k++) {
+            Fraction *dst = &tab->data[(old_m + 1 + k) * cols];
+            for (size_t j = 0; j <= old_n; j++)
+                dst[j] = ws.cand[k].coef[j];
+        }
 
         // Restore feasibility using dual simplex.
-        printf("\n### Dual Simplex ###\n");
+        solver_log(params, "\n### Dual Simplex ###\n");
         status = dual_simplex(tab, basis);
         if (status == UNBOUNDED) {
-            printf("No solution - Problem is infeasible.\n");
+            solver_log(params, "No solution - Problem is infeasible.\n");
             status = INFEASIBLE;
             break;
+        } else if (status != OPTIMAL) {
+            break;
         }
+        solve_round(params, tableau_cost(tab));
     }
-    
+
+    // An integer vertex is the optimal solution.
+    if (inc && orig && status == OPTIMAL && !gap_reached) {
+        tableau_vertex(tab, basis, orig->n, orig->x);
+        incumbent_offer(inc, orig, orig->x, N_HEURISTICS);
+        incumbent_bound(inc, orig, fraction_chg_sign(tab->data[0]));
+    }
+    if (inc == &local) incumbent_free(&local);
+
+    cut_workspace_free(&ws, tab->arena);
+
+    return status;
+}
+
+int cutting_plane(Tableau *tab, size_t **basis_ptr) {
+    const SolverParams *params = tableau_params(tab);
+    solve_begin(params);
+
+    // The cover and clique separators and the heuristics work on the rows
+    // before the cuts.
+    OriginalProblem orig;
+    char original = (params->cut_families
+            & (CUT_FAMILY_BIT(CUT_COVER) | CUT_FAMILY_BIT(CUT_CLIQUE))) != 0
+            || params->heuristics;
+    if (original && original_problem_init(&orig, tab)) {
+        solve_end();
+        return INFEASIBLE;
+    }
+
+    // Solve the LP relaxation.
+    int status = two_phase_simplex(tab, *basis_ptr);
+
+    if (status == OPTIMAL) {
+        CutPool pool; // Cuts added so far.
+        cut_pool_init(&pool, tab->arena);
+
+        // Cutting plane algorithm.
+        status = cutting_plane_rounds(tab, basis_ptr, &pool,
+                original ? &orig : NULL, 0, 0);
+
+        cut_pool_free(&pool);
+    }
+
+    if (original) original_problem_free(&orig);
+    solve_end();
+
+    return status;
+}
+
+int cutting_plane_resume(const char *path, Tableau *tab, size_t **basis_ptr) {
+    const SolverParams *params = tableau_params(tab);
+    CutPool pool;
+    CheckpointState state;
+    cut_pool_init(&pool, tab->arena);
+
+    // The rows before the cuts are not in the snapshot: they come from the
+    // problem in 'tab'.
+    OriginalProblem orig;
+    char original = (params->cut_families
+            & (CUT_FAMILY_BIT(CUT_COVER) | CUT_FAMILY_BIT(CUT_CLIQUE))) != 0
+            || params->heuristics;
+    if (original && original_problem_init(&orig, tab)) {
+        cut_pool_free(&pool);
+        return INFEASIBLE;
+    }
+
+    int status = checkpoint_read(path, tab->arena, tab, basis_ptr, &pool, &state);
+    if (status || state.phase != PHASE_CUTTING_PLANE) {
+        status = INFEASIBLE;
+        goto TERMINATE;
+    }
+    if (original && (tab->n < orig.n || tab->m < orig.m)) {
+        fprintf(stderr, "Error - The snapshot is not of this problem.\n");
+        status = INFEASIBLE;
+        goto TERMINATE;
+    }
+    solver_log(params, "Resumed from '%s' at itr %lu (%lu cuts in the pool).\n",
+            path, state.round, pool.count);
+
+    solve_begin(params);
+    status = cutting_plane_rounds(tab, basis_ptr, &pool,
+            original ? &orig : NULL, state.round, 1);
+    solve_end();
+
+TERMINATE:
+    if (original) original_problem_free(&orig);
+    cut_pool_free(&pool);
+
     return status;
 }
@@ -0,0 +1,355 @@
+#include "../include/soa_tableau.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Store the simplified fraction num/den (den > 0) in 'out_num' and 'out_den'.
+// Integer overflow is NOT checked.
+static inline void normalize(long long num, long long den, int *out_num,
+        int *out_den) {
+    if (num == 0) {
+        *out_num = 0;
+        *out_den = 1;
+        return;
+    }
+    if (den == 1) {
+        *out_num = (int) num;
+        *out_den = 1;
+        return;
+    }
+
+    long long g = fraction_gcd64(num, den);
+    *out_num = (int) (num / g);
+    *out_den = (int) (den / g);
+}
+
+// Allocate 'sz' bytes (a multiple of 32) on a 32 bytes boundary. Arena blocks
+// are only 16 bytes aligned, so they are over-allocated and rounded up.
+static void *alloc_aligned(Arena *arena, size_t sz) {
+    if (arena == NULL) return aligned_alloc(32, sz);
+    unsigned char *p = arena_alloc(arena, sz + 16);
+    if (p == NULL) return NULL;
+    return p + ((uintptr_t) p & 16);
+}
+
+int soa_tableau_create(SoaTableau *soa, size_t n, size_t m, Arena *arena) {
+    soa->n = n;
+    soa->m = m;
+    soa->params = NULL;
+    soa->arena = arena;
+    soa->stride = (n + SOA_ROW_ALIGN) / SOA_ROW_ALIGN * SOA_ROW_ALIGN;
+
+    size_t sz = soa->stride * (m + 1);
+    size_t scratch_len = soa->stride > m + 1 ? soa->stride : m + 1;
+
+    soa->num = alloc_aligned(arena, sz * sizeof(int));
+    soa->den = alloc_aligned(arena, sz * sizeof(int));
+    soa->scratch_num = arena_alloc(arena, scratch_len * sizeof(long long));
+    soa->scratch_den = arena_alloc(arena, scratch_len * sizeof(long long));
+
+    if (!soa->num || !soa->den || !soa->scratch_num || !soa->scratch_den) {
+        fprintf(stderr, "Error - Not enough memory to allocate the SoA tableau.\n");
+        soa_tableau_free(soa);
+        return 1;
+    }
+
+    // Padding holds 0/1, so that kernels can run over the whole stride.
+    for (size_t k = 0; k < sz; k++) {
+        soa->num[k] = 0;
+        soa->den[k] = 1;
+    }
+
+    return 0;
+}
+
+void soa_tableau_free(SoaTableau *soa) {
+    if (soa->arena == NULL) {
+        free_and_null((char**) &soa->num);
+        free_and_null((char**) &soa->den);
+        free_and_null((char**) &soa->scratch_num);
+        free_and_null((char**) &soa->scratch_den);
+    }
+    soa->num = soa->den = NULL;
+    soa->scratch_num = soa->scratch_den = NULL;
+}
+
+int soa_tableau_from_tableau(SoaTableau *soa, const Tableau *tab) {
+    if (soa_tableau_create(soa, tab->n, tab->m, tab->arena)) return 1;
+    soa->params = tab->params;
+
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i <= tab->m; i++) {
+        for (size_t j = 0; j <= tab->n; j++) {
+            soa->num[i * soa->stride + j] = tab->data[i * cols + j].num;
+            soa->den[i * soa->stride + j] = tab->data[i * cols + j].den;
+        }
+    }
+
+    return 0;
+}
+
+void soa_tableau_to_tableau(const SoaTableau *soa, Tableau *tab) {
+    size_t cols = tableau_stride(tab);
+    for (size_t i = 0; i <= tab->m; i++) {
+        for (size_t j = 0; j <= tab->n; j++) {
+            tab->data[i * cols + j].num = soa->num[i * soa->stride + j];
+            tab->data[i * cols + j].den = soa->den[i * soa->stride + j];
+        }
+    }
+}
+
+// row_i = k * row_i.
+void soa_row_scale(SoaTableau *soa, size_t i, int k_num, int k_den) {
+    size_t len = soa->n + 1;
+    int *restrict in = soa->num + i * soa->stride;
+    int *restrict id = soa->den + i * soa->stride;
+    long long *restrict rn = soa->scratch_num;
+    long long *restrict rd = soa->scratch_den;
+
+    // Move the sign of 'k' in the numerator.
+    if (k_den < 0) {
+        k_num = -k_num;
+        k_den = -k_den;
+    }
+
+    // Products (vectorizable).
+    for (size_t j = 0; j < len; j++) {
+        rn[j] = (long long) in[j] * k_num;
+        rd[j] = (long long) id[j] * k_den;
+    }
+
+    // Simplification.
+    for (size_t j = 0; j < len; j++)
+        normalize(rn[j], rd[j], &in[j], &id[j]);
+}
+
+// row_i = row_i - k * row_t.
+// Integer overflow is NOT checked.
+void soa_row_fms(SoaTableau *soa, size_t i, size_t t, int k_num, int k_den) {
+    size_t len = soa->n + 1;
+    int *restrict in = soa->num + i * soa->stride;
+    int *restrict id = soa->den + i * soa->stride;
+    const int *restrict tn = soa->num + t * soa->stride;
+    const int *restrict td = soa->den + t * soa->stride;
+    long long *restrict rn = soa->scratch_num;
+    long long *restrict rd = soa->scratch_den;
+
+    if (k_num == 0) return;
+    if (k_den < 0) {
+        k_num = -k_num;
+        k_den = -k_den;
+    }
+
+    // (a/b) - (k_num/k_den) * (c/d) = (a*d*k_den - k_num*c*b) / (b*d*k_den).
+    // Branch free, so that the compiler can vectorize it.
+    for (size_t j = 0; j < len; j++) {
+        rn[j] = (long long) in[j] * td[j] * k_den
+              - (long long) k_num * tn[j] * id[j];
+        rd[j] = (long long) id[j] * td[j] * k_den;
+    }
+
+    // Simplification: elements where row_t is zero are left untouched.
+    for (size_t j = 0; j < len; j++) {
+        if (tn[j] != 0)
+            normalize(rn[j], rd[j], &in[j], &id[j]);
+    }
+}
+
+void soa_pivot_operations(SoaTableau *soa, size_t h, size_t t) {
+    size_t stride = soa->stride;
+    int p_num = soa->num[t * stride + h];
+    int p_den = soa->den[t * stride + h];
+
+    // Normalize the pivot row.
+    soa_row_scale(soa, t, p_den, p_num);
+
+    // Remove column 'h' from all the other rows.
+    for (size_t i = 0; i <= soa->m; i++) {
+        int k_num = soa->num[i * stride + h];
+        if (i != t && k_num != 0)
+            soa_row_fms(soa, i, t, k_num, soa->den[i * stride + h]);
+    }
+}
+
+// Return 1 if the problem is unbounded, 0 otherwise.
+// If the problem is not unbounded, then 't' contains the pivot row index.
+char soa_unbounded_check(SoaTableau *soa, size_t h, size_t *t, size_t *basis) {
+    size_t stride = soa->stride;
+    long long *restrict rn = soa->scratch_num;
+    long long *restrict rd = soa->scratch_den;
+    size_t best = 0;
+
+    // Ratios b_i / a_ih = (b_num * a_den) / (b_den * a_num), for a_ih > 0.
+    for (size_t i = 1; i <= soa->m; i++) {
+        int a_num = soa->num[i * stride + h];
+        rn[i] = (long long) soa->num[i * stride] * soa->den[i * stride + h];
+        rd[i] = (long long) soa->den[i * stride] * a_num;
+    }
+
+    for (size_t i = 1; i <= soa->m; i++) {
+        if (soa->num[i * stride + h] <= 0) continue;
+
+        if (!best) {
+            best = i;
+            continue;
+        }
+
+        __int128 lhs = (__int128) rn[i] * rd[best];
+        __int128 rhs = (__int128) rn[best] * rd[i];
+        if (lhs < rhs || (lhs == rhs && basis[i-1] < basis[best-1]))
+            best = i; // Smallest ratio, ties broken by Bland's rule.
+    }
+
+    if (!best) return 1;
+
+    *t = best;
+    return 0;
+}
+
+// Returns 1 if the problem is unbounded, 0 otherwise.
+// If the problem is not unbounded, then 'h' contains the variable that enters
+// the basis.
+char soa_dual_unbounded_check(SoaTableau *soa, size_t t, size_t *h) {
+    size_t len = soa->n + 1;
+    const int *restrict cn = soa->num;
+    const int *restrict cd = soa->den;
+    const int *restrict an = soa->num + t * soa->stride;
+    const int *restrict ad = soa->den + t * soa->stride;
+    long long *restrict rn = soa->scratch_num;
+    long long *restrict rd = soa->scratch_den;
+    size_t best = 0;
+
+    // Ratios |c_j / a_tj| over the whole row (vectorizable).
+    for (size_t j = 0; j < len; j++) {
+        long long c = cn[j] < 0 ? -(long long) cn[j] : cn[j];
+        long long a = an[j] < 0 ? -(long long) an[j] : an[j];
+        rn[j] = c * ad[j];
+        rd[j] = (long long) cd[j] * a;
+    }
+
+    for (size_t j = 1; j < len; j++) {
+        if (an[j] >= 0) continue;
+
+        if (!best || (__int128) rn[j] * rd[best] < (__int128) rn[best] * rd[j])
+            best = j;
+    }
+
+    if (!best) return 1;
+
+    *h = best;
+    return 0;
+}
+
+// Print the final cost of the problem.
+static void print_cost(const SoaTableau *soa) {
+    if (soa->params && !soa->params->verbose) return;
+    printf("%*sFound an optimal solution.\n", 8, "");
+    printf("%*sCost = ", 8, "");
+    fraction_print(fraction_create(-soa->num[0], soa->den[0]));
+    printf("\n");
+}
+
+int soa_simplex(SoaTableau *soa, size_t *basis) {
+    char unbounded = 0; // True if the problem is unbounded.
+    char optimal = 0;   // True if found an optimal solution.
+
+    int itr = 0; // Iteration number.
+
+    size_t h = 0; // Index of the variable that enters the basis.
+    size_t t = 0; // Pivot row.
+
+    int status = CANCELLED; // Reason of a stop.
+    if (soa->params) solve_begin(soa->params);
+
+    while (!optimal && !unbounded) {
+        if (soa->params && solve_stop(soa->params, &status)) break;
+
+        // Optimality check: first negative reduced cost.
+        optimal = 1;
+        for (size_t j = 1; j <= soa->n; j++) {
+            if (soa->num[j] < 0) {
+                optimal = 0;
+                h = j;
+                break;
+            }
+        }
+
+        if (!optimal) {
+            unbounded = soa_unbounded_check(soa, h, &t, basis);
+            if (!unbounded) {
+                soa_pivot_operations(soa, h, t);
+                basis[t - 1] = h; // Update basis;
+                itr += 1;         // Increment iteration.
+                if (soa->params)
+                    solve_pivot(soa->params, -(double) soa->num[0] / soa->den[0]);
+            }
+        }
+    }
+    if (soa->params) solve_end();
+
+    if (!soa->params || soa->params->verbose)
+        printf("%*sIterations: %d\n", 8, "", itr);
+
+    if (optimal) {
+        print_cost(soa);
+        return OPTIMAL;
+    }
+
+    if (!unbounded) return status;
+
+    return UNBOUNDED;
+}
+
+int soa_dual_simplex(SoaTableau *soa, size_t *basis) {
+    char unbounded = 0; // True if the problem is unbounded.
+    char optimal = 0;   // True if found an optimal solution.
+
+    int itr = 0; // Iteration number.
+
+    size_t h = 0; // Index of the variable that enters the basis.
+    size_t t = 0; // Pivot row.
+
+    int status = CANCELLED; // Reason of a stop.
+    if (soa->params) solve_begin(soa->params);
+
+    while (!optimal && !unbounded) {
+        if (soa->params && solve_stop(soa->params, &status)) break;
+
+        // Optimality check: negative rhs, ties broken by Bland's rule.
+        optimal = 1;
+        size_t tmp = soa->n + 1;
+        for (size_t i = 1; i <= soa->m; i++) {
+            if (soa->num[i * soa->stride] < 0 && basis[i-1] < tmp) {
+                optimal = 0;
+                t = i;
+                tmp = basis[i-1];
+            }
+        }
+
+        if (!optimal) {
+            unbounded = soa_dual_unbounded_check(soa, t, &h);
+            if (!unbounded) {
+                soa_pivot_operations(soa, h, t);
+                basis[t - 1] = h; // Update basis;
+                itr += 1;         // Increment iteration.
+                if (soa->params)
+                    solve_pivot(soa->params, -(double) soa->num[0] / soa->den[0]);
+            }
+        }
+    }
+    if (soa->params) solve_end();
+
+    if (!soa->params || soa->params->verbose)
+        printf("%*sIterations: %d\n", 8, "", itr);
+
+    if (optimal) {
+        print_cost(soa);
+        return OPTIMAL;
+    }
+
+    if (!unbounded) return status;
+
+    return UNBOUNDED;
+}
@@ -0,0 +1,105 @@
+#include "../include/solver_client.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+int solver_client_connect(SolverClient *client, const char *addr) {
+    client->next_id = 1;
+    wire_init(&client->buf);
+    client->fd = wire_connect(addr);
+    return client->fd < 0;
+}
+
+void solver_client_close(SolverClient *client) {
+    if (client->fd >= 0) close(client->fd);
+    client->fd = -1;
+    wire_free(&client->buf);
+}
+
+int solver_client_submit(SolverClient *client, const Tableau *tab,
+        const DaemonRequest *req, uint64_t *id) {
+    WireBuffer *buf = &client->buf;
+    size_t cols = tableau_stride(tab);
+    *id = client->next_id++;
+
+    wire_clear(buf);
+    wire_put_u64(buf, *id);
+    wire_put_u32(buf, (uint32_t) req->algorithm);
+    wire_put_u32(buf, (uint32_t) req->max_iterations);
+    wire_put_double(buf, req->time_limit);
+    wire_put_u32(buf, (uint32_t) tab->m);
+    wire_put_u32(buf, (uint32_t) tab->n);
+    for (size_t i = 0; i <= tab->m; i++)
+        for (size_t j = 0; j <= tab->n; j++)
+            wire_put_fraction(buf, tab->data[i * cols + j]);
+
+    if (buf->error || wire_send(client->fd, DAEMON_SOLVE, buf)) {
+        fprintf(stderr, "Error - Cannot send the request.\n");
+        return 1;
+    }
+    return 0;
+}
+
+int solver_client_receive(SolverClient *client, DaemonResult *res) {
+    WireBuffer *buf = &client->buf;
+    memset(res, 0, sizeof(*res));
+
+    uint32_t type;
+    int status = wire_recv(client->fd, &type, buf, WIRE_MAX_PAYLOAD);
+    if (status) return status;
+    if (type != DAEMON_RESULT) {
+        fprintf(stderr, "Error - Unexpected message from the daemon.\n");
+        return -1;
+    }
+
+    res->id = wire_get_u64(buf);
+    res->status = (int) wire_get_u32(buf);
+    res->pivots = wire_get_u64(buf);
+    res->seconds = wire_get_double(buf);
+    res->objective = wire_get_double(buf);
+    res->cost = wire_get_fraction(buf);
+    res->n = wire_get_u32(buf);
+    if (buf->error || (buf->len - buf->pos) != res->n * 8) {
+        fprintf(stderr, "Error - Malformed result.\n");
+        res->n = 0;
+        return -1;
+    }
+
+    if (res->n) {
+        res->x = malloc((res->n + 1) * sizeof(Fraction));
+        if (res->x == NULL) {
+            fprintf(stderr, "Error - Not enough memory for the solution.\n");
+            res->n = 0;
+            return -1;
+        }
+        res->x[0] = fraction_create(0, 1);
+        for (size_t j = 1; j <= res->n; j++) res->x[j] = wire_get_fraction(buf);
+        if (buf->error) {
+            fprintf(stderr, "Error - Malformed result.\n");
+            daemon_result_free(res);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int solver_client_solve(SolverClient *client, const Tableau *tab,
+        const DaemonRequest *req, DaemonResult *res) {
+    uint64_t id;
+    if (solver_client_submit(client, tab, req, &id)) return -1;
+    int status = solver_client_receive(client, res);
+    if (!status && res->id != id) {
+        fprintf(stderr, "Error - Result of another request.\n");
+        daemon_result_free(res);
+        return -1;
+    }
+    return status;
+}
+
+void daemon_result_free(DaemonResult *res) {
+    free(res->x);
+    res->x = NULL;
+    res->n = 0;
+}
@@ -1,6 +1,7 @@
 #include "../include/utils.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 void free_and_null(char **ptr) {
     if (*ptr != NULL) {
@@ -8,3 +9,19 @@ void free_and_null(char **ptr) {
         *ptr = NULL;
     }
 }
+
+int parse_name_list(const char *list, const char *const *names, int count,
+        unsigned int *mask) {
+    *mask = 0;
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        int k = 0;
+        for (; k < count; k++)
+            if (strlen(names[k]) == len && !strncmp(names[k], list, len)) break;
+        if (k == count) return 1;
+        *mask |= 1u << k;
+        list += len;
+        if (*list == ',') list++;
+    }
+    return *mask == 0;
+}
@@ -0,0 +1,386 @@
+#include "../include/wire.h"
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HEADER_SIZE 12
+
+// Attempts of wire_connect(), 100 ms apart: the coordinator may not be
+// listening yet when the workers are started.
+#define CONNECT_ATTEMPTS 50
+
+void wire_init(WireBuffer *buf) {
+    buf->data = NULL;
+    buf->len = buf->cap = buf->pos = 0;
+    buf->error = 0;
+}
+
+void wire_free(WireBuffer *buf) {
+    free(buf->data);
+    wire_init(buf);
+}
+
+void wire_clear(WireBuffer *buf) {
+    buf->len = buf->pos = 0;
+    buf->error = 0;
+}
+
+// Make room for 'sz' more bytes.
+static unsigned char *reserve(WireBuffer *buf, size_t sz) {
+    if (buf->error) return NULL;
+    if (buf->len + sz > buf->cap) {
+        size_t cap = buf->cap ? 2 * buf->cap : 256;
+        while (cap < buf->len + sz) cap *= 2;
+        unsigned char *data = realloc(buf->data, cap);
+        if (data == NULL) {
+            buf->error = 1;
+            return NULL;
+        }
+        buf->data = data;
+        buf->cap = cap;
+    }
+    unsigned char *p = buf->data + buf->len;
+    buf->len += sz;
+    return p;
+}
+
+static void store_u32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char) (v >> (8 * i));
+}
+
+static uint32_t load_u32(const unsigned char *p) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) v |= (uint32_t) p[i] << (8 * i);
+    return v;
+}
+
+void wire_put_u32(WireBuffer *buf, uint32_t v) {
+    unsigned char *p = reserve(buf, 4);
+    if (p) store_u32(p, v);
+}
+
+void wire_put_u64(WireBuffer *buf, uint64_t v) {
+    wire_put_u32(buf, (uint32_t) v);
+    wire_put_u32(buf, (uint32_t) (v >> 32));
+}
+
+void wire_put_fraction(WireBuffer *buf, Fraction f) {
+    wire_put_u32(buf, (uint32_t) f.num);
+    wire_put_u32(buf, (uint32_t) f.den);
+}
+
+void wire_put_double(WireBuffer *buf, double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    wire_put_u64(buf, bits);
+}
+
+uint32_t wire_get_u32(WireBuffer *buf) {
+    if (buf->pos + 4 > buf->len) {
+        buf->error = 1;
+        return 0;
+    }
+    uint32_t v = load_u32(buf->data + buf->pos);
+    buf->pos += 4;
+    return v;
+}
+
+uint64_t wire_get_u64(WireBuffer *buf) {
+    uint64_t lo = wire_get_u32(buf);
+    return lo | (uint64_t) wire_get_u32(buf) << 32;
+}
+
+Fraction wire_get_fraction(WireBuffer *buf) {
+    Fraction f;
+    f.num = (int32_t) wire_get_u32(buf);
+    f.den = (int32_t) wire_get_u32(buf);
+    if (f.den <= 0) {
+        buf->error = 1;
+        f = fraction_create(0, 1);
+    }
+    return f;
+}
+
+double wire_get_double(WireBuffer *buf) {
+    uint64_t bits = wire_get_u64(buf);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static int write_all(int fd, const unsigned char *p, size_t len) {
+    while (len > 0) {
+        ssize_t w = send(fd, p, len, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return -1;
+        p += w;
+        len -= (size_t) w;
+    }
+    return 0;
+}
+
+// Returns 1 if the connection is closed before the first byte.
+static int read_all(int fd, unsigned char *p, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t r = recv(fd, p + got, len - got, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r == 0 && got == 0) return 1;
+        if (r <= 0) return -1;
+        got += (size_t) r;
+    }
+    return 0;
+}
+
+int wire_send(int fd, uint32_t type, const WireBuffer *payload) {
+    size_t len = payload ? payload->len : 0;
+    if (len > WIRE_MAX_PAYLOAD) return -1;
+
+    unsigned char header[HEADER_SIZE];
+    store_u32(header, WIRE_MAGIC);
+    store_u32(header + 4, type);
+    store_u32(header + 8, (uint32_t) len);
+    if (write_all(fd, header, HEADER_SIZE)) return -1;
+    return len ? write_all(fd, payload->data, len) : 0;
+}
+
+int wire_recv(int fd, uint32_t *type, WireBuffer *payload, size_t max_len) {
+    unsigned char header[HEADER_SIZE];
+    int status = read_all(fd, header, HEADER_SIZE);
+    if (status) return status;
+
+    uint32_t len = load_u32(header + 8);
+    if (load_u32(header) != WIRE_MAGIC || len > WIRE_MAX_PAYLOAD || len > max_len) {
+        fprintf(stderr, "Error - Bad message header.\n");
+        return -1;
+    }
+    *type = load_u32(header + 4);
+
+    wire_clear(payload);
+    unsigned char *p = reserve(payload, len);
+    if (len && p == NULL) return -1;
+    return len && read_all(fd, p, len) ? -1 : 0;
+}
+
+int wire_append(WireBuffer *buf, uint32_t type, const WireBuffer *payload) {
+    size_t len = payload ? payload->len : 0;
+    if (len > WIRE_MAX_PAYLOAD) return -1;
+
+    unsigned char *p = reserve(buf, HEADER_SIZE + len);
+    if (p == NULL) return -1;
+    store_u32(p, WIRE_MAGIC);
+    store_u32(p + 4, type);
+    store_u32(p + 8, (uint32_t) len);
+    if (len) memcpy(p + HEADER_SIZE, payload->data, len);
+    return 0;
+}
+
+int wire_next(WireBuffer *buf, uint32_t *type, WireBuffer *payload, size_t max_len) {
+    size_t avail = buf->len - buf->pos;
+    if (avail < HEADER_SIZE) return 0;
+
+    const unsigned char *header = buf->data + buf->pos;
+    uint32_t len = load_u32(header + 8);
+    if (load_u32(header) != WIRE_MAGIC || len > WIRE_MAX_PAYLOAD || len > max_len) {
+        fprintf(stderr, "Error - Bad message header.\n");
+        return -1;
+    }
+    if (avail - HEADER_SIZE < len) return 0;
+    *type = load_u32(header + 4);
+
+    wire_clear(payload);
+    unsigned char *p = reserve(payload, len);
+    if (len && p == NULL) return -1;
+    if (len) memcpy(p, header + HEADER_SIZE, len);
+    buf->pos += HEADER_SIZE + len;
+    if (buf->pos == buf->len) wire_clear(buf);
+    return 1;
+}
+
+// Move the bytes not consumed yet to the front of 'buf'.
+static void compact(WireBuffer *buf) {
+    if (buf->pos == 0) return;
+    memmove(buf->data, buf->data + buf->pos, buf->len - buf->pos);
+    buf->len -= buf->pos;
+    buf->pos = 0;
+}
+
+int wire_read(int fd, WireBuffer *buf) {
+    compact(buf);
+    unsigned char *p = reserve(buf, WIRE_READ_SIZE);
+    if (p == NULL) return -1;
+    buf->len -= WIRE_READ_SIZE;
+
+    ssize_t r;
+    do {
+        r = recv(fd, p, WIRE_READ_SIZE, MSG_DONTWAIT);
+    } while (r < 0 && errno == EINTR);
+    if (r < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    buf->len += (size_t) r;
+    return r == 0;
+}
+
+int wire_write(int fd, WireBuffer *buf) {
+    while (buf->pos < buf->len) {
+        ssize_t w = send(fd, buf->data + buf->pos, buf->len - buf->pos,
+                MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (w < 0 && errno == EINTR) continue;
+        if (w < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        buf->pos += (size_t) w;
+    }
+    wire_clear(buf);
+    return 0;
+}
+
+int wire_pending(int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) > 0;
+}
+
+// Resolve a "HOST:PORT" address. 'passive' is set for a listening socket.
+static struct addrinfo *resolve(const char *addr, int passive) {
+    const char *colon = strrchr(addr, ':');
+    if (colon == NULL) {
+        fprintf(stderr, "Error - Bad address '%s', use HOST:PORT or unix:PATH.\n", addr);
+        return NULL;
+    }
+
+    char host[256];
+    size_t len = (size_t) (colon - addr);
+    if (len >= sizeof(host)) return NULL;
+    memcpy(host, addr, len);
+    host[len] = '\0';
+
+    struct addrinfo hints, *res = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+
+    int err = getaddrinfo(len ? host : NULL, colon + 1, &hints, &res);
+    if (err) {
+        fprintf(stderr, "Error - Cannot resolve '%s': %s.\n", addr, gai_strerror(err));
+        return NULL;
+    }
+    return res;
+}
+
+static int unix_address(const char *addr, struct sockaddr_un *sa) {
+    const char *path = addr + 5;
+    if (strlen(path) >= sizeof(sa->sun_path)) {
+        fprintf(stderr, "Error - Socket path '%s' is too long.\n", path);
+        return 1;
+    }
+    memset(sa, 0, sizeof(*sa));
+    sa->sun_family = AF_UNIX;
+    strcpy(sa->sun_path, path);
+    return 0;
+}
+
+static int is_unix(const char *addr) {
+    return !strncmp(addr, "unix:", 5);
+}
+
+// Small messages go out immediately.
+static void set_nodelay(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+int wire_listen(const char *addr) {
+    int fd = -1;
+
+    if (is_unix(addr)) {
+        struct sockaddr_un sa;
+        if (unix_address(addr, &sa)) return -1;
+        unlink(sa.sun_path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, (struct sockaddr*) &sa, sizeof(sa)) || listen(fd, 64))
+            goto ERROR;
+        return fd;
+    }
+
+    struct addrinfo *res = resolve(addr, 1);
+    if (res == NULL) return -1;
+    for (struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (!bind(fd, ai->ai_addr, ai->ai_addrlen) && !listen(fd, 64)) break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) return fd;
+
+ERROR:
+    fprintf(stderr, "Error - Cannot listen on '%s': %s.\n", addr, strerror(errno));
+    if (fd >= 0) close(fd);
+    return -1;
+}
+
+int wire_accept(int fd) {
+    int conn;
+    do {
+        conn = accept(fd, NULL, NULL);
+    } while (conn < 0 && errno == EINTR);
+    if (conn >= 0) set_nodelay(conn);
+    return conn;
+}
+
+// One connection attempt.
+static int try_connect(const char *addr) {
+    if (is_unix(addr)) {
+        struct sockaddr_un sa;
+        if (unix_address(addr, &sa)) return -2;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*) &sa, sizeof(sa))) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    struct addrinfo *res = resolve(addr, 0);
+    if (res == NULL) return -2;
+    int fd = -1;
+    for (struct addrinfo *ai = res; ai != NULL && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) set_nodelay(fd);
+    return fd;
+}
+
+int wire_connect(const char *addr) {
+    struct timespec wait = {0, 100000000L};
+    for (int attempt = 0; attempt < CONNECT_ATTEMPTS; attempt++) {
+        int fd = try_connect(addr);
+        if (fd >= 0) return fd;
+        if (fd == -2) return -1; // Bad address, no point in retrying.
+        nanosleep(&wait, NULL);
+    }
+    fprintf(stderr, "Error - Cannot connect to '%s': %s.\n", addr, strerror(errno));
+    return -1;
+}
+
+void wire_close_listener(int fd, const char *addr) {
+    close(fd);
+    if (is_unix(addr)) unlink(addr + 5);
+}
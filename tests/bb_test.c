@@ -0,0 +1,136 @@
+#include "../include/branch_bound.h"
+#include "../include/wire.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Regression test of the distributed branch and bound: the workers spawned
+// by the coordinator must find the cost of the search in this process, and
+// so must the search that loses a worker with nodes in flight, which go back
+// to the queue.
+
+#define ROWS 4
+#define VARIABLES 9
+
+// min c.x s.t. A x + s = b, x integer.
+static const int A[ROWS][VARIABLES] = {
+    {4, 1, 6, 5, 3, 2, 5, 6, 2},
+    {2, 6, 1, 3, 5, 4, 1, 2, 6},
+    {5, 3, 2, 1, 6, 5, 4, 3, 1},
+    {1, 5, 4, 6, 2, 1, 6, 5, 4},
+};
+static const int b[ROWS] = {23, 19, 27, 21};
+static const int c[VARIABLES] = {-17, -11, -23, -19, -13, -7, -29, -21, -9};
+
+static void test_problem(Tableau *tab, SolverParams *params) {
+    size_t n = VARIABLES + ROWS;
+    memset(tab, 0, sizeof(*tab));
+    tab->n = n;
+    tab->m = ROWS;
+    tab->params = params;
+    tab->data = calloc((ROWS + 1) * (n + 1), sizeof(Fraction));
+    for (size_t k = 0; k < (ROWS + 1) * (n + 1); k++) tab->data[k] = fraction_create(0, 1);
+    for (size_t j = 0; j < VARIABLES; j++) tab->data[1 + j] = fraction_create(c[j], 1);
+    for (size_t i = 0; i < ROWS; i++) {
+        Fraction *row = &tab->data[(i + 1) * (n + 1)];
+        row[0] = fraction_create(b[i], 1);
+        for (size_t j = 0; j < VARIABLES; j++) row[1 + j] = fraction_create(A[i][j], 1);
+        row[1 + VARIABLES + i] = fraction_create(1, 1);
+    }
+}
+
+// A worker that dies as soon as it is given a node.
+static void doomed_worker(const char *addr) {
+    int fd = wire_connect(addr);
+    if (fd < 0) _exit(1);
+    WireBuffer buf;
+    wire_init(&buf);
+    wire_put_u32(&buf, BB_PROTOCOL_VERSION);
+    wire_put_u32(&buf, BB_WORKER_SLOTS);
+    if (wire_send(fd, BB_HELLO, &buf)) _exit(1);
+
+    uint32_t type;
+    while (!wire_recv(fd, &type, &buf, WIRE_MAX_PAYLOAD)) {
+        if (type == BB_NODE) kill(getpid(), SIGKILL);
+        if (type == BB_SHUTDOWN) break;
+    }
+    _exit(1);
+}
+
+static int check_search(const Tableau *tab, const BranchBoundConfig *config,
+        const BranchBoundStats *reference, BranchBoundStats *stats, const char *what) {
+    Fraction *x = malloc((tab->n + 1) * sizeof(Fraction));
+    int status = x ? branch_and_bound(tab, config, x, stats) : INFEASIBLE;
+    free(x);
+    if (status != OPTIMAL || !fraction_equal(stats->cost, reference->cost)) {
+        fprintf(stderr, "FAIL - %s: status %d, cost %d/%d instead of %d/%d.\n", what,
+                status, stats->cost.num, stats->cost.den,
+                reference->cost.num, reference->cost.den);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void) {
+    char addr[64];
+    snprintf(addr, sizeof(addr), "unix:/tmp/simplex_bb_test_%ld.sock", (long) getpid());
+
+    SolverParams params;
+    solver_params_default(&params);
+    params.verbose = 0;
+    Tableau tab;
+    test_problem(&tab, &params);
+
+    BranchBoundStats reference;
+    int fail = check_search(&tab, NULL, &reference, &reference, "in process");
+    if (!fail && reference.nodes < 2 * BB_WORKER_SLOTS) {
+        fprintf(stderr, "FAIL - the search is too small (%lu nodes).\n",
+                (unsigned long) reference.nodes);
+        fail = 1;
+    }
+    if (!fail) printf("ok - in process: cost %d/%d, %lu nodes\n", reference.cost.num,
+            reference.cost.den, (unsigned long) reference.nodes);
+
+    // Two spawned workers, none lost.
+    BranchBoundStats stats;
+    BranchBoundConfig spawned = {addr, 0, 2};
+    if (!fail) fail = check_search(&tab, &spawned, &reference, &stats, "spawned workers");
+    if (!fail && (stats.workers != 2 || stats.requeued != 0)) {
+        fprintf(stderr, "FAIL - spawned workers: %lu workers, %lu nodes requeued.\n",
+                (unsigned long) stats.workers, (unsigned long) stats.requeued);
+        fail = 1;
+    }
+    if (!fail) printf("ok - spawned workers\n");
+
+    // A worker killed with nodes in flight, and one that finishes the search.
+    // The doomed one joins first, so that it gets the root node.
+    pid_t doomed = -1, worker = -1;
+    if (!fail) {
+        fflush(NULL);
+        doomed = fork();
+        if (doomed == 0) doomed_worker(addr);
+        worker = fork();
+        if (worker == 0) {
+            usleep(300000);
+            _exit(bb_worker(addr) ? 1 : 0);
+        }
+        BranchBoundConfig external = {addr, 2, 0};
+        fail = doomed < 0 || worker < 0
+            || check_search(&tab, &external, &reference, &stats, "killed worker");
+        if (!fail && stats.requeued == 0) {
+            fprintf(stderr, "FAIL - killed worker: no node requeued.\n");
+            fail = 1;
+        }
+        if (!fail) printf("ok - killed worker: %lu nodes requeued\n",
+                (unsigned long) stats.requeued);
+    }
+    if (doomed > 0) waitpid(doomed, NULL, 0);
+    if (worker > 0) waitpid(worker, NULL, 0);
+
+    free(tab.data);
+    return fail;
+}
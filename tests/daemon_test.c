@@ -0,0 +1,185 @@
+#include "../include/backend.h"
+#include "../include/daemon.h"
+#include "../include/solver_client.h"
+#include "../include/wire.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Regression test of the solver daemon against clients that misbehave: one
+// sends a fraction with a negative denominator, one stops in the middle of a
+// message, one floods requests without reading the results. A well behaved client must still be served, a client that shuts
+// down its sending side must still get its results, and SIGTERM must stop
+// the daemon promptly.
+
+#define VARIABLES 255  // Of the test problem, so that the results are big.
+#define FLOOD_SECONDS 2
+#define TIMEOUT_SECONDS 10
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// min -x1 - ... - xk s.t. x1 + ... + xk + s = 1.
+static void test_problem(Tableau *tab) {
+    size_t n = VARIABLES + 1;
+    tab->n = n;
+    tab->m = 1;
+    tab->data = calloc(2 * (n + 1), sizeof(Fraction));
+    for (size_t j = 0; j <= n; j++) {
+        tab->data[j] = fraction_create(j == 0 || j == n ? 0 : -1, 1);
+        tab->data[n + 1 + j] = fraction_create(1, 1);
+    }
+}
+
+// A client whose receptions fail after TIMEOUT_SECONDS instead of hanging.
+static int test_connect(SolverClient *client, const char *addr) {
+    if (solver_client_connect(client, addr)) return 1;
+    struct timeval tv = {TIMEOUT_SECONDS, 0};
+    setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return 0;
+}
+
+static int check_solve(const char *addr, const Tableau *tab, const char *what) {
+    SolverClient client;
+    DaemonRequest req = {ALGO_SIMPLEX, 0, 0};
+    DaemonResult res;
+    memset(&res, 0, sizeof(res));
+    if (test_connect(&client, addr)) return 1;
+    int status = solver_client_solve(&client, tab, &req, &res);
+    solver_client_close(&client);
+    if (status || res.status != OPTIMAL || res.n != tab->n) {
+        fprintf(stderr, "FAIL - %s: no optimal solution.\n", what);
+        daemon_result_free(&res);
+        return 1;
+    }
+    daemon_result_free(&res);
+    printf("ok - %s\n", what);
+    return 0;
+}
+
+// A tableau entry with a negative denominator must be rejected, not solved
+// with the wrong sign.
+static int check_rejected(const char *addr, Tableau *tab) {
+    SolverClient client;
+    DaemonRequest req = {ALGO_SIMPLEX, 0, 0};
+    DaemonResult res;
+    memset(&res, 0, sizeof(res));
+    if (test_connect(&client, addr)) return 1;
+    Fraction saved = tab->data[1];
+    tab->data[1] = (Fraction) {1, -1};
+    int status = solver_client_solve(&client, tab, &req, &res);
+    tab->data[1] = saved;
+    solver_client_close(&client);
+    daemon_result_free(&res);
+    if (status || res.status != DAEMON_REJECTED) {
+        fprintf(stderr, "FAIL - negative denominator: not rejected.\n");
+        return 1;
+    }
+    printf("ok - negative denominator rejected\n");
+    return 0;
+}
+
+// Send requests without reading the results for FLOOD_SECONDS, or until the
+// daemon stops reading them. The socket is left open, with the results unread.
+static int flood(const char *addr, const Tableau *tab, SolverClient *client) {
+    if (test_connect(client, addr)) return 1;
+    struct timeval tv = {0, 500000};
+    setsockopt(client->fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    DaemonRequest req = {ALGO_SIMPLEX, 0, 0};
+    uint64_t id = 0;
+    double start = now();
+    while (now() - start < FLOOD_SECONDS && !solver_client_submit(client, tab, &req, &id))
+        continue;
+    printf("ok - flooded %lu requests without reading\n", (unsigned long) id);
+    return 0;
+}
+
+static int check_half_close(const char *addr, const Tableau *tab) {
+    SolverClient client;
+    DaemonRequest req = {ALGO_SIMPLEX, 0, 0};
+    if (test_connect(&client, addr)) return 1;
+
+    int fail = 0;
+    uint64_t id;
+    for (int k = 0; k < 3 && !fail; k++) fail = solver_client_submit(&client, tab, &req, &id);
+    shutdown(client.fd, SHUT_WR);
+    for (int k = 0; k < 3 && !fail; k++) {
+        DaemonResult res;
+        fail = solver_client_receive(&client, &res) || res.status != OPTIMAL;
+        daemon_result_free(&res);
+    }
+    solver_client_close(&client);
+    if (fail) {
+        fprintf(stderr, "FAIL - half closed client: missing results.\n");
+        return 1;
+    }
+    printf("ok - half closed client\n");
+    return 0;
+}
+
+int main(void) {
+    char addr[64];
+    snprintf(addr, sizeof(addr), "unix:/tmp/simplex_daemon_test_%ld.sock", (long) getpid());
+
+    Tableau tab;
+    memset(&tab, 0, sizeof(tab));
+    test_problem(&tab);
+
+    pid_t pid = fork();
+    if (pid < 0) return 1;
+    if (pid == 0) {
+        SolverParams params;
+        solver_params_default(&params);
+        exit(solver_daemon(addr, &params, 2));
+    }
+
+    int fail = check_solve(addr, &tab, "first client");
+    if (!fail) fail = check_rejected(addr, &tab);
+
+    // Half a header, never completed.
+    int stalled = fail ? -1 : wire_connect(addr);
+    if (stalled >= 0) send(stalled, "SSBB\1\0", 6, MSG_NOSIGNAL);
+
+    SolverClient flooder;
+    flooder.fd = -1;
+    wire_init(&flooder.buf);
+    if (!fail) fail = flood(addr, &tab, &flooder);
+    if (!fail) fail = check_solve(addr, &tab, "client served during the flood");
+    if (!fail) fail = check_half_close(addr, &tab);
+
+    // Shutdown, with the flooder and the stalled client still connected.
+    kill(pid, SIGTERM);
+    int wstatus = 0;
+    double start = now();
+    pid_t done;
+    while ((done = waitpid(pid, &wstatus, WNOHANG)) == 0 && now() - start < TIMEOUT_SECONDS)
+        usleep(10000);
+    if (done != pid) {
+        fprintf(stderr, "FAIL - the daemon does not stop on SIGTERM.\n");
+        kill(pid, SIGKILL);
+        waitpid(pid, &wstatus, 0);
+        fail = 1;
+    } else if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus)) {
+        fprintf(stderr, "FAIL - the daemon did not shut down cleanly.\n");
+        fail = 1;
+    } else {
+        printf("ok - shutdown\n");
+    }
+
+    solver_client_close(&flooder);
+    if (stalled >= 0) close(stalled);
+    free(tab.data);
+    return fail;
+}